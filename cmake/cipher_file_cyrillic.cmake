@@ -0,0 +1,29 @@
+# Проверка cipher_file: шифр Виженера с кириллическим ключом через конвейер файлов.
+# Запуск: cmake -DCIPHER_FILE=<путь к cipher_file> -DWORK_DIR=<каталог> -P cipher_file_cyrillic.cmake
+# Без setlocale в main ключ КЛЮЧ отклоняется, а кириллица текста не шифруется.
+
+set(ENV{LC_ALL} "C.UTF-8")
+set(plain "${WORK_DIR}/cyrillic_plain.txt")
+set(cipher "${WORK_DIR}/cyrillic_cipher.txt")
+set(back "${WORK_DIR}/cyrillic_back.txt")
+file(WRITE "${plain}" "привет мир\nПРИВЕТ\n")
+
+foreach(step "encrypt;${plain};${cipher}" "decrypt;${cipher};${back}")
+    list(GET step 0 mode)
+    list(GET step 1 input)
+    list(GET step 2 output)
+    execute_process(COMMAND "${CIPHER_FILE}" ${mode} vigenere "КЛЮЧ" "${input}" "${output}"
+                    RESULT_VARIABLE result OUTPUT_QUIET ERROR_VARIABLE error)
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "cipher_file ${mode} failed: ${error}")
+    endif()
+endforeach()
+
+file(READ "${cipher}" encrypted)
+file(READ "${back}" decrypted)
+if (NOT encrypted STREQUAL "щыжщпэ гты\nНЗТНГЙ\n")
+    message(FATAL_ERROR "Unexpected ciphertext: ${encrypted}")
+endif()
+if (NOT decrypted STREQUAL "привет мир\nПРИВЕТ\n")
+    message(FATAL_ERROR "Round trip failed: ${decrypted}")
+endif()
@@ -6,6 +6,10 @@
  */
 
 #include "affine_cipher.h"
+#include "cipher_batch.h"
+#include "metrics.h"
+#include "simd_dispatch.h"
+#include <algorithm>
 #include <stdexcept>
 #include <cwctype> ///< Для towupper
 
@@ -27,6 +31,26 @@ int gcd(int a, int b) {
     return a;
 }
 
+namespace {
+    /**
+     * @brief Как towupper текущей локали переводит строчные буквы встроенного алфавита.
+     *
+     * @return 1 — в заглавные (векторное ядро сворачивает регистр само), 0 — не меняет
+     *         (локаль "C" для кириллицы), -1 — иначе (только скалярный код).
+     */
+    template <class Alphabet>
+    int lowerCaseMode() {
+        const wchar_t lowerFirst = static_cast<wchar_t>(Alphabet::first + 0x20);
+        const wchar_t lowerLast = static_cast<wchar_t>(lowerFirst + Alphabet::count - 1);
+        if (towupper(L'i') != L'I') return -1;
+        if (static_cast<wchar_t>(towupper(lowerFirst)) == Alphabet::first &&
+            static_cast<wchar_t>(towupper(lowerLast)) == Alphabet::at(Alphabet::count - 1)) return 1;
+        if (static_cast<wchar_t>(towupper(lowerFirst)) == lowerFirst &&
+            static_cast<wchar_t>(towupper(lowerLast)) == lowerLast) return 0;
+        return -1;
+    }
+}
+
 /**
  * @brief Конструктор класса AffineCipher.
  *
@@ -39,10 +63,11 @@ int gcd(int a, int b) {
  * @throw std::invalid_argument Если ключ a не взаимно прост с длиной алфавита.
  */
 AffineCipher::AffineCipher(int a_, int b_, const std::wstring& alph)
-    : a(a_), b(b_), alphabet(alph) {
-    m = static_cast<int>(alphabet.size());
+    : a(a_), b(b_), alphabet(alph), m(static_cast<int>(alph.size())), alphabetIndex(alph),
+      alphabetKind(detectBuiltinAlphabet(alph)) {
     if (gcd(a, m) != 1)
         throw std::invalid_argument("Key 'a' and alphabet length must be coprime.");
+    aInverse = modInverse(a, m);
 }
 
 /**
@@ -71,28 +96,86 @@ int AffineCipher::modInverse(int a, int m) const {
 }
 
 /**
- * @brief Преобразует символ в индекс в алфавите.
+ * @brief Общая реализация шифрования и дешифрования.
  *
- * Если символ не найден в алфавите, возвращает -1.
+ * Выбирает специализацию алфавита (EN, RU или пользовательский) и вызывает шаблонное ядро.
  *
- * @param c Символ для поиска.
- * @return Индекс символа или -1, если символ не найден.
+ * @param text Входной текст.
+ * @param encryptMode true — шифрование, false — дешифрование.
+ * @param[out] out Строка для результата.
  */
-int AffineCipher::charToInt(wchar_t c) const {
-    for (int i = 0; i < m; ++i) {
-        if (alphabet[i] == c) return i;
-    }
-    return -1;
+template <class String>
+void AffineCipher::transform(std::wstring_view text, bool encryptMode, String& out) const {
+    dispatchAlphabet(alphabetKind, alphabetIndex, [&](const auto& alph) {
+        transformWith(alph, text, encryptMode, out);
+    });
 }
 
 /**
- * @brief Преобразует индекс в символ алфавита.
+ * @brief Ядро шифрования и дешифрования для конкретного алфавита.
  *
- * @param i Индекс символа.
- * @return Соответствующий символ алфавита.
+ * Пробелы и символы, не входящие в алфавит, сохраняются без изменений.
+ * Результат дописывается в out, память берётся из аллокатора out. Для встроенных
+ * алфавитов длинные тексты обрабатывает векторное ядро simd::affineContiguous.
+ *
+ * @param alph Алфавит (EnAlphabet, RuAlphabet или RuntimeAlphabet).
+ * @param text Входной текст.
+ * @param encryptMode true — шифрование, false — дешифрование.
+ * @param[out] out Строка для результата.
  */
-wchar_t AffineCipher::intToChar(int i) const {
-    return alphabet[i];
+template <class Alphabet, class String>
+void AffineCipher::transformWith(const Alphabet& alph, std::wstring_view text, bool encryptMode, String& out) const {
+    metrics::CallScope scope(CipherKind::Affine, text.size(), out);
+    size_t passthrough = 0;
+    const int a_inv = aInverse;
+    auto transformChar = [&](wchar_t c) {
+        if (c == L' ') {
+            ++passthrough;
+            return c;
+        }
+        int index = upperIndexOf(alph, c);
+        if (index == -1) {
+            ++passthrough;
+            return c;
+        }
+        return encryptMode ? alph.at((a * index + b) % m) : alph.at((a_inv * (index - b + m)) % m);
+    };
+
+    if constexpr (!std::is_same_v<Alphabet, RuntimeAlphabet>) {
+        // Векторное ядро — для ключей, при которых формулы выше не уходят в отрицательные
+        // остатки; блоки с символами, которые свернуть может только towupper, и хвост
+        // дорабатывает скалярный код.
+        const int foldMode = text.size() >= simd::MAX_LANES && simd::activeLevel() != simd::Level::Scalar
+                                 ? lowerCaseMode<Alphabet>() : -1;
+        const bool keyFits = a >= 0 && b >= 0 && a <= 0xFFFF && (encryptMode ? b <= 0xFFFF : b <= m);
+        if (foldMode >= 0 && keyFits) {
+            simd::AffineMap map;
+            map.first = Alphabet::first;
+            map.count = m;
+            map.multiplier = encryptMode ? a % m : a_inv % m;
+            map.offset = encryptMode ? b % m : a_inv * (m - b) % m;
+            map.foldLower = foldMode == 1;
+
+            const size_t base = out.size();
+            out.resize(base + text.size());
+            wchar_t* dest = &out[base];
+            size_t i = 0;
+            while (i < text.size()) {
+                i += simd::affineContiguous(text.data() + i, text.size() - i, dest + i, map, passthrough);
+                for (const size_t end = std::min(text.size(), i + simd::MAX_LANES); i < end; ++i) {
+                    dest[i] = transformChar(text[i]);
+                }
+            }
+            scope.passthrough(passthrough);
+            return;
+        }
+    }
+
+    out.reserve(out.size() + text.size());
+    for (wchar_t c : text) {
+        out += transformChar(c);
+    }
+    scope.passthrough(passthrough);
 }
 
 /**
@@ -106,19 +189,7 @@ wchar_t AffineCipher::intToChar(int i) const {
  */
 std::wstring AffineCipher::encrypt(const std::wstring& text) {
     std::wstring result;
-    for (wchar_t c : text) {
-        if (c == L' ') {
-            result += L' ';
-            continue;
-        }
-        int index = charToInt(towupper(c));
-        if (index == -1) {
-            result += c;
-        } else {
-            int encrypted = (a * index + b) % m;
-            result += intToChar(encrypted);
-        }
-    }
+    transform(text, true, result);
     return result;
 }
 
@@ -133,19 +204,47 @@ std::wstring AffineCipher::encrypt(const std::wstring& text) {
  */
 std::wstring AffineCipher::decrypt(const std::wstring& text) {
     std::wstring result;
-    int a_inv = modInverse(a, m);
-    for (wchar_t c : text) {
-        if (c == L' ') {
-            result += L' ';
-            continue;
-        }
-        int index = charToInt(towupper(c));
-        if (index == -1) {
-            result += c;
-        } else {
-            int decrypted = (a_inv * (index - b + m)) % m;
-            result += intToChar(decrypted);
-        }
-    }
+    transform(text, false, result);
+    return result;
+}
+
+/**
+ * @brief Шифрует текст, выделяя память под результат из ресурса mr.
+ *
+ * @param text Исходный текст для шифрования.
+ * @param mr Ресурс памяти вызывающего кода (например, арена запроса).
+ * @return Зашифрованный текст.
+ */
+std::pmr::wstring AffineCipher::encrypt(const std::wstring& text, std::pmr::memory_resource* mr) const {
+    std::pmr::wstring result(mr);
+    transform(text, true, result);
     return result;
 }
+
+/**
+ * @brief Дешифрует текст, выделяя память под результат из ресурса mr.
+ *
+ * @param text Зашифрованный текст.
+ * @param mr Ресурс памяти вызывающего кода (например, арена запроса).
+ * @return Расшифрованный текст.
+ */
+std::pmr::wstring AffineCipher::decrypt(const std::wstring& text, std::pmr::memory_resource* mr) const {
+    std::pmr::wstring result(mr);
+    transform(text, false, result);
+    return result;
+}
+
+/**
+ * @brief Пакетная обработка: специализация алфавита выбирается один раз на пакет.
+ *
+ * @param texts Входные сообщения.
+ * @param encryptMode true — шифрование, false — дешифрование.
+ * @param[out] out Пакет, в который дописываются результаты.
+ */
+void AffineCipher::processBatch(const TextBatch& texts, bool encryptMode, CipherBatch& out) const {
+    dispatchAlphabet(alphabetKind, alphabetIndex, [&](const auto& alph) {
+        out.appendEach(texts, [&](std::wstring_view text, std::pmr::wstring& data) {
+            transformWith(alph, text, encryptMode, data);
+        });
+    });
+}
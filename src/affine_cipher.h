@@ -1,7 +1,13 @@
 #ifndef AFFINE_CIPHER_H
 #define AFFINE_CIPHER_H
 
+#include "alphabet_traits.h"
 #include <string>
+#include <string_view>
+#include <memory_resource>
+
+class TextBatch;
+class CipherBatch;
 
 /**
  * @brief Вычисляет наибольший общий делитель (НОД)
@@ -17,16 +23,37 @@ class AffineCipher {
     int b;               // ключ b
     std::wstring alphabet;
     int m;               // размер алфавита
+    int aInverse;        // a^(-1) mod m, вычисляется один раз в конструкторе
+    AlphabetIndex alphabetIndex;  // индекс символов алфавита
+    BuiltinAlphabet alphabetKind; // встроенный алфавит (EN/RU) или пользовательский
 
     int modInverse(int a, int m) const;
-    int charToInt(wchar_t c) const;
-    wchar_t intToChar(int i) const;
+
+    template <class String>
+    void transform(std::wstring_view text, bool encryptMode, String& out) const;
+    template <class Alphabet, class String>
+    void transformWith(const Alphabet& alph, std::wstring_view text, bool encryptMode, String& out) const;
 
 public:
     AffineCipher(int a_, int b_, const std::wstring& alph);
 
     std::wstring encrypt(const std::wstring& text);
     std::wstring decrypt(const std::wstring& text);
+
+    /**
+     * @brief Шифрует текст, размещая результат в переданном ресурсе памяти.
+     */
+    std::pmr::wstring encrypt(const std::wstring& text, std::pmr::memory_resource* mr) const;
+
+    /**
+     * @brief Дешифрует текст, размещая результат в переданном ресурсе памяти.
+     */
+    std::pmr::wstring decrypt(const std::wstring& text, std::pmr::memory_resource* mr) const;
+
+    /**
+     * @brief Шифрует или дешифрует пакет сообщений, дописывая результаты в out (см. cipher_batch.h).
+     */
+    void processBatch(const TextBatch& texts, bool encryptMode, CipherBatch& out) const;
 };
 
 #endif // AFFINE_CIPHER_H
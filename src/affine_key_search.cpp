@@ -0,0 +1,101 @@
+/**
+ * @file affine_key_search.cpp
+ * @brief Реализация подбора ключа аффинного шифра по частотам букв.
+ */
+
+#include "affine_key_search.h"
+#include "affine_cipher.h"
+#include "alphabet_index.h"
+#include "letter_histogram.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cwctype>
+#include <stdexcept>
+
+namespace
+{
+    constexpr size_t PARALLEL_THRESHOLD = 1 << 20; ///< С какой длины текста гистограмма считается в несколько потоков
+
+    /**
+     * @brief Считает гистограмму участка текста [begin, end).
+     */
+    void countRange(const wchar_t* begin, const wchar_t* end, const AlphabetIndex& index,
+                    std::vector<uint64_t>& counts)
+    {
+        for (const wchar_t* p = begin; p != end; ++p) {
+            if (*p == L' ') continue;
+            int i = index.indexOf(towupper(*p));
+            if (i >= 0) ++counts[i];
+        }
+    }
+}
+
+std::vector<uint64_t> AffineKeySearch::countLetters(const std::wstring& text, const std::wstring& alphabet) {
+    // Встроенный алфавит, строчные буквы которого towupper переводит в заглавные:
+    // гистограмма без учёта регистра даёт то же, что и правила AffineCipher.
+    const BuiltinAlphabet builtin = detectBuiltinAlphabet(alphabet);
+    if (builtin != BuiltinAlphabet::None
+        && static_cast<wchar_t>(towupper(alphabet[0] + 0x20)) == alphabet[0]) {
+        auto bins = LetterHistogram::count(text);
+        auto first = bins.begin() + LetterHistogram::firstBin(builtin);
+        return std::vector<uint64_t>(first, first + alphabet.size());
+    }
+
+    AlphabetIndex index(alphabet);
+    const size_t m = alphabet.size();
+
+    // Части не короче PARALLEL_THRESHOLD: короткий текст считается одной частью в вызывающем потоке.
+    ThreadPool& pool = ThreadPool::shared();
+    const size_t grain = std::max(PARALLEL_THRESHOLD, (text.size() + pool.concurrency() - 1) / pool.concurrency());
+    return pool.parallelReduce(
+        0, text.size(), grain, std::vector<uint64_t>(m, 0),
+        [&](size_t begin, size_t end) {
+            std::vector<uint64_t> counts(m, 0);
+            countRange(text.data() + begin, text.data() + end, index, counts);
+            return counts;
+        },
+        [](std::vector<uint64_t> sum, const std::vector<uint64_t>& part) {
+            for (size_t i = 0; i < sum.size(); ++i) sum[i] += part[i];
+            return sum;
+        });
+}
+
+std::vector<AffineKeyCandidate> AffineKeySearch::rankKeys(const std::vector<uint64_t>& counts,
+                                                          const std::vector<double>& reference,
+                                                          FrequencyScore method, size_t top) {
+    const int m = static_cast<int>(counts.size());
+    if (m == 0 || reference.size() != counts.size()) {
+        throw std::invalid_argument("Histogram and reference distribution must have the same size.");
+    }
+
+    FrequencyScorer scorer(reference, method);
+    uint64_t total = 0;
+    for (uint64_t c : counts) total += c;
+
+    // Для ключа (a, b) буква открытого текста x шифруется в корзину (a*x + b) mod m.
+    std::vector<AffineKeyCandidate> candidates;
+    std::vector<int> map(m);
+    for (int a = 1; a < m; ++a) {
+        if (gcd(a, m) != 1) continue;
+        for (int b = 0; b < m; ++b) {
+            for (int x = 0; x < m; ++x) {
+                map[x] = (a * x + b) % m;
+            }
+            candidates.push_back({a, b, scorer(counts.data(), map.data(), total)});
+        }
+    }
+
+    top = std::min(top, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + top, candidates.end(),
+                      [&](const AffineKeyCandidate& l, const AffineKeyCandidate& r) {
+                          return scorer.better(l.score, r.score);
+                      });
+    candidates.resize(top);
+    return candidates;
+}
+
+std::vector<AffineKeyCandidate> AffineKeySearch::recoverKeys(const std::wstring& ciphertext,
+                                                             const std::wstring& alphabet,
+                                                             FrequencyScore method, size_t top) {
+    return rankKeys(countLetters(ciphertext, alphabet), LetterFrequency::forAlphabet(alphabet), method, top);
+}
@@ -0,0 +1,69 @@
+/**
+ * @file affine_key_search.h
+ * @brief Заголовочный файл для класса AffineKeySearch — подбор ключа аффинного шифра по частотам букв.
+ */
+
+#ifndef AFFINE_KEY_SEARCH_H
+#define AFFINE_KEY_SEARCH_H
+
+#include "letter_frequency.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Кандидат ключа аффинного шифра.
+ */
+struct AffineKeyCandidate {
+    int a;          ///< Ключ a (множитель)
+    int b;          ///< Ключ b (сдвиг)
+    double score;   ///< Оценка (смысл зависит от FrequencyScore)
+};
+
+/**
+ * @class AffineKeySearch
+ * @brief Полный перебор ключей (a, b) аффинного шифра.
+ *
+ * Гистограмма букв шифртекста считается один раз (по тем же правилам, что и
+ * AffineCipher: пробелы пропускаются, буквы приводятся к верхнему регистру).
+ * Затем каждый из phi(m) * m ключей оценивается перестановкой корзин гистограммы,
+ * без расшифровки текста. Длинные тексты считаются параллельно по частям.
+ */
+class AffineKeySearch {
+public:
+    /**
+     * @brief Считает гистограмму букв текста по алфавиту.
+     * @param text Текст.
+     * @param alphabet Алфавит.
+     * @return Количество вхождений каждой буквы алфавита.
+     */
+    static std::vector<uint64_t> countLetters(const std::wstring& text, const std::wstring& alphabet);
+
+    /**
+     * @brief Оценивает все ключи по готовой гистограмме шифртекста.
+     * @param counts Гистограмма шифртекста (размер равен размеру алфавита).
+     * @param reference Эталонное распределение букв открытого текста.
+     * @param method Способ оценки.
+     * @param top Сколько лучших кандидатов вернуть.
+     * @return Кандидаты, упорядоченные от лучшего к худшему.
+     * @throw std::invalid_argument Если размеры гистограммы и эталона не совпадают.
+     */
+    static std::vector<AffineKeyCandidate> rankKeys(const std::vector<uint64_t>& counts,
+                                                    const std::vector<double>& reference,
+                                                    FrequencyScore method, size_t top);
+
+    /**
+     * @brief Восстанавливает ключ по шифртексту встроенного алфавита (EN или RU).
+     * @param ciphertext Шифртекст.
+     * @param alphabet Алфавит (EN_ALPHABET или RU_ALPHABET).
+     * @param method Способ оценки.
+     * @param top Сколько лучших кандидатов вернуть.
+     * @return Кандидаты, упорядоченные от лучшего к худшему.
+     */
+    static std::vector<AffineKeyCandidate> recoverKeys(const std::wstring& ciphertext,
+                                                       const std::wstring& alphabet,
+                                                       FrequencyScore method = FrequencyScore::ChiSquared,
+                                                       size_t top = 5);
+};
+
+#endif // AFFINE_KEY_SEARCH_H
@@ -0,0 +1,67 @@
+/**
+ * @file alloc_tracker.cpp
+ * @brief Замена глобальных operator new/delete, считающая выделения (только для doctest).
+ */
+
+#include "alloc_tracker.h"
+#include <cstdlib>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#include <new>
+
+namespace
+{
+    void* allocate(std::size_t size)
+    {
+        alloc_tracker::threadStats.count += 1;
+        alloc_tracker::threadStats.bytes += size;
+        return std::malloc(size ? size : 1);
+    }
+
+    void* allocateAligned(std::size_t size, std::align_val_t align)
+    {
+        alloc_tracker::threadStats.count += 1;
+        alloc_tracker::threadStats.bytes += size;
+        std::size_t alignment = static_cast<std::size_t>(align);
+#ifdef _WIN32
+        return _aligned_malloc(size ? size : 1, alignment);
+#else
+        std::size_t rounded = (size + alignment - 1) / alignment * alignment;
+        return std::aligned_alloc(alignment, rounded ? rounded : alignment);
+#endif
+    }
+
+    void freeAligned(void* p)
+    {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+
+    void* checked(void* p)
+    {
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+}
+
+void* operator new(std::size_t size) { return checked(allocate(size)); }
+void* operator new[](std::size_t size) { return checked(allocate(size)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return checked(allocateAligned(size, align)); }
+void* operator new[](std::size_t size, std::align_val_t align) { return checked(allocateAligned(size, align)); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { freeAligned(p); }
@@ -0,0 +1,56 @@
+/**
+ * @file alloc_tracker.h
+ * @brief Подсчёт выделений памяти в тестах: число вызовов operator new и байты.
+ *
+ * Глобальные operator new/delete заменяются в alloc_tracker.cpp, который
+ * собирается только в цель doctest. Счётчики свои у каждого потока, поэтому
+ * фоновые потоки (пул, сервер) не влияют на измерение в потоке теста.
+ */
+
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <cstddef>
+
+namespace alloc_tracker
+{
+    /**
+     * @brief Число выделений и запрошенные байты.
+     */
+    struct Stats {
+        std::size_t count = 0;
+        std::size_t bytes = 0;
+    };
+
+    /// Счётчики текущего потока с момента его запуска.
+    inline thread_local Stats threadStats;
+
+    /**
+     * @brief Выделения текущего потока за один вызов f.
+     *
+     * f сначала вызывается один раз без учёта: так в измерение не попадают
+     * однократные инициализации (статические таблицы, блок метрик потока).
+     */
+    template <class F>
+    Stats measure(F&& f)
+    {
+        f();
+        Stats before = threadStats;
+        f();
+        return {threadStats.count - before.count, threadStats.bytes - before.bytes};
+    }
+}
+
+/**
+ * @brief Проверяет, что выражение выделяет память не более max_count раз.
+ */
+#define CHECK_ALLOCATIONS(expr, max_count) \
+    CHECK(alloc_tracker::measure([&] { (void)(expr); }).count <= static_cast<std::size_t>(max_count))
+
+/**
+ * @brief Проверяет, что выражение запрашивает не более max_bytes байт.
+ */
+#define CHECK_ALLOCATED_BYTES(expr, max_bytes) \
+    CHECK(alloc_tracker::measure([&] { (void)(expr); }).bytes <= static_cast<std::size_t>(max_bytes))
+
+#endif // ALLOC_TRACKER_H
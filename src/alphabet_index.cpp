@@ -0,0 +1,40 @@
+/**
+ * @file alphabet_index.cpp
+ * @brief Реализация класса AlphabetIndex.
+ */
+
+#include "alphabet_index.h"
+#include <algorithm>
+
+namespace
+{
+    constexpr unsigned long MAX_DENSE_SPAN = 1UL << 16; ///< Максимальный диапазон кодов для плотной таблицы
+    constexpr size_t MAX_DENSE_SIZE = 32767;           ///< Индексы плотной таблицы хранятся в short
+}
+
+/**
+ * @brief Строит таблицу индексов для алфавита.
+ *
+ * Если символ встречается в алфавите несколько раз, используется первое вхождение,
+ * как и при поиске через std::wstring::find.
+ */
+AlphabetIndex::AlphabetIndex(const std::wstring& alphabet) : alphabet_(alphabet) {
+    if (alphabet_.empty()) {
+        return;
+    }
+
+    auto [lo, hi] = std::minmax_element(alphabet_.begin(), alphabet_.end());
+    first_ = *lo;
+    unsigned long span = static_cast<unsigned long>(*hi) - static_cast<unsigned long>(*lo) + 1;
+
+    if (span <= MAX_DENSE_SPAN && alphabet_.size() <= MAX_DENSE_SIZE) {
+        table_.assign(span, -1);
+        for (int i = size() - 1; i >= 0; --i) {
+            table_[static_cast<unsigned long>(alphabet_[i]) - static_cast<unsigned long>(first_)] = static_cast<short>(i);
+        }
+    } else {
+        for (int i = size() - 1; i >= 0; --i) {
+            sparse_[alphabet_[i]] = i;
+        }
+    }
+}
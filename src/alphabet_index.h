@@ -0,0 +1,65 @@
+/**
+ * @file alphabet_index.h
+ * @brief Заголовочный файл для класса AlphabetIndex — быстрый поиск индекса символа в алфавите.
+ */
+
+#ifndef ALPHABET_INDEX_H
+#define ALPHABET_INDEX_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/**
+ * @class AlphabetIndex
+ * @brief Отображение символ → индекс в алфавите за O(1).
+ *
+ * Вместо линейного поиска (alphabet.find) строится плотная таблица
+ * на диапазон кодов от минимального до максимального символа алфавита.
+ * Для алфавитов с очень широким диапазоном кодов используется хеш-таблица.
+ */
+class AlphabetIndex {
+public:
+    /**
+     * @brief Конструктор.
+     * @param alphabet Алфавит (для пустого алфавита indexOf всегда возвращает -1).
+     */
+    explicit AlphabetIndex(const std::wstring& alphabet);
+
+    /**
+     * @brief Индекс символа в алфавите.
+     * @param c Символ.
+     * @return Индекс или -1, если символа нет в алфавите.
+     */
+    int indexOf(wchar_t c) const {
+        unsigned long offset = static_cast<unsigned long>(c) - static_cast<unsigned long>(first_);
+        if (!table_.empty()) {
+            return offset < table_.size() ? table_[offset] : -1;
+        }
+        auto it = sparse_.find(c);
+        return it != sparse_.end() ? it->second : -1;
+    }
+
+    /**
+     * @brief Символ алфавита по индексу.
+     */
+    wchar_t at(int i) const { return alphabet_[i]; }
+
+    /**
+     * @brief Размер алфавита.
+     */
+    int size() const { return static_cast<int>(alphabet_.size()); }
+
+    /**
+     * @brief Исходная строка алфавита.
+     */
+    const std::wstring& alphabet() const { return alphabet_; }
+
+private:
+    std::wstring alphabet_;
+    wchar_t first_ = 0;                          ///< Минимальный код символа алфавита
+    std::vector<short> table_;                   ///< Плотная таблица индексов (-1 — нет символа)
+    std::unordered_map<wchar_t, int> sparse_;    ///< Запасной вариант для широких диапазонов
+};
+
+#endif // ALPHABET_INDEX_H
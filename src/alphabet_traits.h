@@ -0,0 +1,112 @@
+/**
+ * @file alphabet_traits.h
+ * @brief Встроенные алфавиты EN/RU и их специализации времени компиляции.
+ *
+ * EN_ALPHABET (A–Z) и RU_ALPHABET (А–Я без Ё) — непрерывные диапазоны кодов,
+ * поэтому проверка принадлежности и индекс символа сводятся к вычитанию и
+ * одному сравнению. Шифры выбирают специализацию один раз и вызывают
+ * шаблонное ядро; для остальных алфавитов используется RuntimeAlphabet.
+ */
+
+#ifndef ALPHABET_TRAITS_H
+#define ALPHABET_TRAITS_H
+
+#include "alphabet_index.h"
+#include <cwctype>
+#include <string>
+#include <type_traits>
+
+/// Русский алфавит без Ё (непрерывный диапазон А–Я).
+inline const std::wstring RU_ALPHABET = L"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+/// Английский алфавит (непрерывный диапазон A–Z).
+inline const std::wstring EN_ALPHABET = L"ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+/**
+ * @brief Какой встроенный алфавит используется.
+ */
+enum class BuiltinAlphabet {
+    None,       ///< Пользовательский алфавит
+    English,    ///< EN_ALPHABET
+    Russian     ///< RU_ALPHABET
+};
+
+/**
+ * @brief Определяет, совпадает ли алфавит с одним из встроенных.
+ */
+inline BuiltinAlphabet detectBuiltinAlphabet(const std::wstring& alphabet) {
+    if (alphabet == EN_ALPHABET) return BuiltinAlphabet::English;
+    if (alphabet == RU_ALPHABET) return BuiltinAlphabet::Russian;
+    return BuiltinAlphabet::None;
+}
+
+/**
+ * @brief Алфавит из непрерывного диапазона кодов [First, Last].
+ */
+template <wchar_t First, wchar_t Last>
+struct ContiguousAlphabet {
+    static constexpr wchar_t first = First;
+    static constexpr int count = static_cast<int>(Last - First) + 1;
+
+    /// Индекс символа или -1: одно вычитание и одно беззнаковое сравнение.
+    static constexpr int indexOf(wchar_t c) {
+        unsigned long offset = static_cast<unsigned long>(c) - static_cast<unsigned long>(First);
+        return offset < static_cast<unsigned long>(count) ? static_cast<int>(offset) : -1;
+    }
+
+    static constexpr wchar_t at(int i) { return static_cast<wchar_t>(First + i); }
+
+    static constexpr int size() { return count; }
+};
+
+using EnAlphabet = ContiguousAlphabet<L'A', L'Z'>;
+using RuAlphabet = ContiguousAlphabet<L'А', L'Я'>;
+
+/**
+ * @brief Пользовательский алфавит: поиск через таблицу AlphabetIndex.
+ */
+class RuntimeAlphabet {
+public:
+    explicit RuntimeAlphabet(const AlphabetIndex& index) : index_(&index) {}
+
+    int indexOf(wchar_t c) const { return index_->indexOf(c); }
+    wchar_t at(int i) const { return index_->at(i); }
+    int size() const { return index_->size(); }
+
+private:
+    const AlphabetIndex* index_;
+};
+
+/**
+ * @brief Вызывает f со специализацией алфавита: EnAlphabet, RuAlphabet или RuntimeAlphabet.
+ * @param kind Результат detectBuiltinAlphabet для алфавита.
+ * @param index Таблица индексов того же алфавита (для пользовательского случая).
+ * @param f Обобщённая лямбда, принимающая алфавит.
+ */
+template <class F>
+decltype(auto) dispatchAlphabet(BuiltinAlphabet kind, const AlphabetIndex& index, F&& f) {
+    switch (kind) {
+    case BuiltinAlphabet::English:
+        return f(EnAlphabet{});
+    case BuiltinAlphabet::Russian:
+        return f(RuAlphabet{});
+    default:
+        return f(RuntimeAlphabet(index));
+    }
+}
+
+/**
+ * @brief Индекс символа после приведения к верхнему регистру (towupper).
+ *
+ * Буквы встроенных алфавитов — заглавные и не меняются towupper, поэтому
+ * для них towupper вызывается только для символов вне диапазона.
+ */
+template <class Alphabet>
+int upperIndexOf(const Alphabet& alph, wchar_t c) {
+    if constexpr (!std::is_same_v<Alphabet, RuntimeAlphabet>) {
+        int i = alph.indexOf(c);
+        if (i >= 0) return i;
+    }
+    return alph.indexOf(static_cast<wchar_t>(towupper(c)));
+}
+
+#endif // ALPHABET_TRAITS_H
@@ -0,0 +1,245 @@
+/**
+ * @file block_io.cpp
+ * @brief Очереди pread/pwrite и io_uring (системные вызовы напрямую, без liburing).
+ */
+
+#include "block_io.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define BLOCK_IO_URING
+#endif
+
+namespace
+{
+    /**
+     * @brief pread/pwrite: операция выполняется при постановке, wait() отдаёт результаты по порядку.
+     */
+    class PreadQueue : public IoQueue {
+    public:
+        const char* name() const override { return "pread"; }
+        unsigned depth() const override { return 1; }
+
+        void read(int fd, char* dest, size_t size, std::uint64_t offset, int, void* tag) override {
+            size_t done = 0;
+            while (done < size) {
+                ssize_t n = ::pread(fd, dest + done, size - done, static_cast<off_t>(offset + done));
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) {
+                    completed_.push_back({tag, -errno});
+                    return;
+                }
+                if (n == 0) break; // конец файла
+                done += static_cast<size_t>(n);
+            }
+            completed_.push_back({tag, static_cast<std::int64_t>(done)});
+        }
+
+        void write(int fd, const char* src, size_t size, std::uint64_t offset, void* tag) override {
+            ssize_t n;
+            do {
+                n = ::pwrite(fd, src, size, static_cast<off_t>(offset));
+            } while (n < 0 && errno == EINTR);
+            completed_.push_back({tag, n < 0 ? -errno : static_cast<std::int64_t>(n)});
+        }
+
+        Completion wait() override {
+            if (completed_.empty()) {
+                throw std::logic_error("IoQueue::wait without pending operations.");
+            }
+            Completion c = completed_.front();
+            completed_.pop_front();
+            return c;
+        }
+
+    private:
+        std::deque<Completion> completed_;
+    };
+
+#ifdef BLOCK_IO_URING
+    /**
+     * @brief Кольца io_uring, отображённые в память процесса.
+     *
+     * Очередь отправки пишет только этот поток, очередь завершений читает только
+     * он же (хвост ядра — acquire). Поставленные записи заполняются за локальным
+     * хвостом и публикуются ядру одной release-записью хвоста в submit() при wait(),
+     * поэтому ядро (в том числе поток SQPOLL) не видит незаполненных записей.
+     */
+    class UringQueue : public IoQueue {
+    public:
+        static std::unique_ptr<IoQueue> create(unsigned entries) {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+            int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+            if (fd < 0) {
+                return nullptr; // ENOSYS, EPERM (запрещён sysctl или seccomp), ENOMEM
+            }
+            std::unique_ptr<UringQueue> queue(new UringQueue(fd, params));
+            // IORING_OP_READ/WRITE появились в 5.6 вместе с этим признаком.
+            if (!(params.features & IORING_FEAT_RW_CUR_POS) || !queue->map()) {
+                return nullptr;
+            }
+            return queue;
+        }
+
+        ~UringQueue() override {
+            if (sqes_ != MAP_FAILED) ::munmap(sqes_, sqesSize_);
+            if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_) ::munmap(cqRing_, cqSize_);
+            if (sqRing_ != MAP_FAILED) ::munmap(sqRing_, sqSize_);
+            ::close(fd_);
+        }
+
+        const char* name() const override { return "io_uring"; }
+        unsigned depth() const override { return params_.sq_entries; }
+
+        bool registerBuffers(char* const* buffers, size_t count, size_t size) override {
+            std::vector<iovec> vectors(count);
+            for (size_t i = 0; i < count; ++i) {
+                vectors[i].iov_base = buffers[i];
+                vectors[i].iov_len = size;
+            }
+            // Страницы закрепляются в памяти; при нехватке RLIMIT_MEMLOCK читаем без регистрации.
+            registered_ = ::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, vectors.data(),
+                                    static_cast<unsigned>(count)) == 0;
+            return registered_;
+        }
+
+        void read(int fd, char* dest, size_t size, std::uint64_t offset, int buffer, void* tag) override {
+            io_uring_sqe& sqe = nextSqe();
+            sqe.opcode = registered_ && buffer >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+            sqe.fd = fd;
+            sqe.addr = reinterpret_cast<std::uint64_t>(dest);
+            sqe.len = static_cast<unsigned>(size);
+            sqe.off = offset;
+            sqe.buf_index = static_cast<std::uint16_t>(std::max(buffer, 0));
+            sqe.user_data = reinterpret_cast<std::uint64_t>(tag);
+        }
+
+        void write(int fd, const char* src, size_t size, std::uint64_t offset, void* tag) override {
+            io_uring_sqe& sqe = nextSqe();
+            sqe.opcode = IORING_OP_WRITE;
+            sqe.fd = fd;
+            sqe.addr = reinterpret_cast<std::uint64_t>(src);
+            sqe.len = static_cast<unsigned>(size);
+            sqe.off = offset;
+            sqe.user_data = reinterpret_cast<std::uint64_t>(tag);
+        }
+
+        Completion wait() override {
+            submit();
+            for (;;) {
+                const unsigned head = *cqHead_;
+                const bool ready = head != __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+                if (ready && unsubmitted_ == 0) {
+                    const io_uring_cqe& cqe = cqes_[head & *cqMask_];
+                    Completion c{reinterpret_cast<void*>(cqe.user_data), cqe.res};
+                    __atomic_store_n(cqHead_, head + 1, __ATOMIC_RELEASE);
+                    return c;
+                }
+                int n = static_cast<int>(::syscall(__NR_io_uring_enter, fd_, unsubmitted_, ready ? 0u : 1u,
+                                                   IORING_ENTER_GETEVENTS, nullptr, 0));
+                if (n < 0) {
+                    if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+                    throw std::runtime_error(std::string("io_uring_enter failed: ") + std::strerror(errno));
+                }
+                unsubmitted_ -= static_cast<unsigned>(n);
+            }
+        }
+
+    private:
+        UringQueue(int fd, const io_uring_params& params) : fd_(fd), params_(params) {}
+
+        bool map() {
+            sqSize_ = params_.sq_off.array + params_.sq_entries * sizeof(unsigned);
+            cqSize_ = params_.cq_off.cqes + params_.cq_entries * sizeof(io_uring_cqe);
+            const bool single = (params_.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single) {
+                sqSize_ = cqSize_ = std::max(sqSize_, cqSize_);
+            }
+            sqRing_ = ::mmap(nullptr, sqSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                             IORING_OFF_SQ_RING);
+            if (sqRing_ == MAP_FAILED) return false;
+            cqRing_ = single ? sqRing_
+                             : ::mmap(nullptr, cqSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                                      IORING_OFF_CQ_RING);
+            if (cqRing_ == MAP_FAILED) return false;
+            sqesSize_ = params_.sq_entries * sizeof(io_uring_sqe);
+            sqes_ = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                           IORING_OFF_SQES);
+            if (sqes_ == MAP_FAILED) return false;
+
+            char* sq = static_cast<char*>(sqRing_);
+            sqTail_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.tail);
+            sqMask_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.ring_mask);
+            sqArray_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.array);
+            localTail_ = *sqTail_;
+            char* cq = static_cast<char*>(cqRing_);
+            cqHead_ = reinterpret_cast<unsigned*>(cq + params_.cq_off.head);
+            cqTail_ = reinterpret_cast<unsigned*>(cq + params_.cq_off.tail);
+            cqMask_ = reinterpret_cast<unsigned*>(cq + params_.cq_off.ring_mask);
+            cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params_.cq_off.cqes);
+            return true;
+        }
+
+        /// Вызывающий код держит не больше depth() операций, поэтому место в кольце есть всегда.
+        /// Запись становится видна ядру только после submit().
+        io_uring_sqe& nextSqe() {
+            const unsigned index = localTail_ & *sqMask_;
+            io_uring_sqe& sqe = static_cast<io_uring_sqe*>(sqes_)[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqArray_[index] = index;
+            ++localTail_;
+            ++unsubmitted_;
+            return sqe;
+        }
+
+        /// Публикует заполненные записи: release упорядочивает их перед новым хвостом.
+        void submit() {
+            if (*sqTail_ != localTail_) __atomic_store_n(sqTail_, localTail_, __ATOMIC_RELEASE);
+        }
+
+        int fd_;
+        io_uring_params params_;
+        void* sqRing_ = MAP_FAILED;
+        void* cqRing_ = MAP_FAILED;
+        void* sqes_ = MAP_FAILED;
+        size_t sqSize_ = 0;
+        size_t cqSize_ = 0;
+        size_t sqesSize_ = 0;
+        unsigned* sqTail_ = nullptr;
+        unsigned* sqMask_ = nullptr;
+        unsigned* sqArray_ = nullptr;
+        unsigned* cqHead_ = nullptr;
+        unsigned* cqTail_ = nullptr;
+        unsigned* cqMask_ = nullptr;
+        io_uring_cqe* cqes_ = nullptr;
+        unsigned localTail_ = 0;   ///< Хвост с ещё не опубликованными записями
+        unsigned unsubmitted_ = 0;
+        bool registered_ = false;
+    };
+#endif
+}
+
+std::unique_ptr<IoQueue> makePreadQueue() {
+    return std::make_unique<PreadQueue>();
+}
+
+std::unique_ptr<IoQueue> makeUringQueue(unsigned depth) {
+#ifdef BLOCK_IO_URING
+    return UringQueue::create(std::max(depth, 1u));
+#else
+    (void)depth;
+    return nullptr;
+#endif
+}
@@ -0,0 +1,84 @@
+/**
+ * @file block_io.h
+ * @brief Очереди блочного ввода-вывода по смещениям для конвейера файлов (file_pipeline.h).
+ *
+ * Операции ставятся в очередь без ожидания, завершения забираются wait() в любом
+ * порядке и опознаются по tag. Реализации:
+ * - makeUringQueue — io_uring (Linux 5.6+): много операций «в полёте», один системный
+ *   вызов на пачку, чтение в зарегистрированные буферы без их отображения на каждой операции;
+ * - makePreadQueue — pread/pwrite: операция выполняется сразу при постановке (POSIX);
+ * - потоковая очередь поверх std::istream/std::ostream живёт в file_pipeline.cpp.
+ */
+
+#ifndef BLOCK_IO_H
+#define BLOCK_IO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @class IoQueue
+ * @brief Очередь операций чтения и записи одного потока. Не потокобезопасна.
+ */
+class IoQueue {
+public:
+    /**
+     * @brief Завершённая операция.
+     */
+    struct Completion {
+        void* tag = nullptr;      ///< Значение, переданное при постановке
+        std::int64_t result = 0;  ///< Число байтов или -errno
+    };
+
+    virtual ~IoQueue() = default;
+
+    /**
+     * @brief Имя реализации: "io_uring", "pread" или "stream".
+     */
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief Сколько операций можно держать поставленными и незабранными.
+     */
+    virtual unsigned depth() const = 0;
+
+    /**
+     * @brief Регистрирует буферы одинакового размера для чтения по индексу (read с buffer >= 0).
+     * @return false, если реализация или ядро буферы не регистрирует (чтение работает и так).
+     */
+    virtual bool registerBuffers(char* const* buffers, size_t count, size_t size) {
+        (void)buffers; (void)count; (void)size;
+        return false;
+    }
+
+    /**
+     * @brief Чтение size байтов со смещения offset в dest; buffer — индекс зарегистрированного
+     *        буфера, содержащего dest, или -1. Результат — прочитано байт (меньше size только в конце файла).
+     */
+    virtual void read(int fd, char* dest, size_t size, std::uint64_t offset, int buffer, void* tag) = 0;
+
+    /**
+     * @brief Запись size байтов из src по смещению offset. Результат может быть меньше size:
+     *        остаток дописывается следующей операцией.
+     */
+    virtual void write(int fd, const char* src, size_t size, std::uint64_t offset, void* tag) = 0;
+
+    /**
+     * @brief Отправляет поставленные операции и ждёт хотя бы одно завершение.
+     */
+    virtual Completion wait() = 0;
+};
+
+/**
+ * @brief Очередь pread/pwrite (глубина 1).
+ */
+std::unique_ptr<IoQueue> makePreadQueue();
+
+/**
+ * @brief Очередь io_uring на depth операций.
+ * @return nullptr, если ядро не поддерживает io_uring (или нужные операции) либо он запрещён.
+ */
+std::unique_ptr<IoQueue> makeUringQueue(unsigned depth);
+
+#endif // BLOCK_IO_H
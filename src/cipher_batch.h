@@ -0,0 +1,107 @@
+/**
+ * @file cipher_batch.h
+ * @brief Пакетная обработка коротких сообщений: много входов — один непрерывный буфер результатов.
+ *
+ * Для сообщений в десятки символов накладные расходы одного вызова (строка-результат,
+ * выбор алфавита, временные буферы) сопоставимы с самим шифрованием. Пакетные методы
+ * шифров (processBatch) выбирают специализацию алфавита один раз на пакет, дописывают
+ * результаты подряд в CipherBatch::data и берут временные буферы из пула пакета,
+ * поэтому память освобождённого буфера одного сообщения достаётся следующему.
+ */
+
+#ifndef CIPHER_BATCH_H
+#define CIPHER_BATCH_H
+
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class TextBatch
+ * @brief Непрерывная последовательность входных сообщений (аналог std::span<const std::wstring_view>).
+ *
+ * Не владеет ни массивом, ни текстами сообщений.
+ */
+class TextBatch {
+public:
+    TextBatch(const std::wstring_view* texts, size_t count) : texts_(texts), count_(count) {}
+    TextBatch(const std::vector<std::wstring_view>& texts) : texts_(texts.data()), count_(texts.size()) {}
+
+    const std::wstring_view* begin() const { return texts_; }
+    const std::wstring_view* end() const { return texts_ + count_; }
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    std::wstring_view operator[](size_t i) const { return texts_[i]; }
+
+private:
+    const std::wstring_view* texts_;
+    size_t count_;
+};
+
+/**
+ * @class CipherBatch
+ * @brief Результаты пакета: все сообщения подряд в data, границы — в offsets.
+ *
+ * Сообщение i занимает data[offsets[i], offsets[i + 1]). Объект рассчитан на повторное
+ * использование: clear() сохраняет ёмкость буферов и память пула, так что пакеты
+ * одинакового размера после первого не обращаются к куче. Не потокобезопасен.
+ */
+class CipherBatch {
+public:
+    explicit CipherBatch(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : pool_(upstream), data(&pool_), offsets(1, 0, &pool_) {}
+
+    CipherBatch(const CipherBatch&) = delete;
+    CipherBatch& operator=(const CipherBatch&) = delete;
+
+    /// Число готовых сообщений.
+    size_t size() const { return offsets.size() - 1; }
+
+    /// Результат сообщения i.
+    std::wstring_view operator[](size_t i) const {
+        return std::wstring_view(data).substr(offsets[i], offsets[i + 1] - offsets[i]);
+    }
+
+    /// Удаляет результаты, сохраняя выделенную память.
+    void clear() {
+        data.clear();
+        offsets.resize(1);
+    }
+
+    /// Резервирует место под messages сообщений общей длиной chars символов.
+    void reserve(size_t messages, size_t chars) {
+        offsets.reserve(offsets.size() + messages);
+        data.reserve(data.size() + chars);
+    }
+
+    /**
+     * @brief Дописывает результаты process(text, data) для каждого сообщения.
+     *
+     * process дописывает результат одного сообщения в конец data. Если он бросает
+     * исключение, частичный результат этого сообщения удаляется, готовые остаются,
+     * а исключение передаётся вызывающему.
+     */
+    template <class Process>
+    void appendEach(const TextBatch& texts, Process&& process) {
+        offsets.reserve(offsets.size() + texts.size());
+        for (std::wstring_view text : texts) {
+            try {
+                process(text, data);
+            } catch (...) {
+                data.resize(offsets.back());
+                throw;
+            }
+            offsets.push_back(data.size());
+        }
+    }
+
+private:
+    std::pmr::unsynchronized_pool_resource pool_; ///< Буферы пакета и временные данные шифров
+
+public:
+    std::pmr::wstring data;            ///< Результаты всех сообщений подряд
+    std::pmr::vector<size_t> offsets;  ///< Границы сообщений, offsets.front() == 0
+};
+
+#endif // CIPHER_BATCH_H
@@ -0,0 +1,218 @@
+/**
+ * @file cipher_chain.cpp
+ * @brief Реализация цепочки шифров с объединением подстановочных ступеней.
+ */
+
+#include "cipher_chain.h"
+#include "affine_cipher.h"
+#include "gronsfeld_cipher.h"
+#include <cwctype>
+#include <numeric>
+#include <utility>
+
+/**
+ * @brief Добавляет ступень аффинного шифра.
+ *
+ * Аффинный шифр не зависит от позиции (период 1) и приводит символы к верхнему
+ * регистру, поэтому таблица для символов «после towupper» совпадает с основной.
+ */
+CipherChain& CipherChain::addAffine(int a, int b, const std::wstring& alphabet, bool encrypt) {
+    AffineCipher cipher(a, b, alphabet);
+    std::wstring mapped = encrypt ? cipher.encrypt(alphabet) : cipher.decrypt(alphabet);
+
+    SubstitutionTable table;
+    table.index = AlphabetIndex(alphabet);
+    table.kind = detectBuiltinAlphabet(alphabet);
+    table.period = 1;
+    table.foldsCase = true;
+    table.exact.resize(alphabet.size());
+    for (size_t i = 0; i < alphabet.size(); ++i) {
+        table.exact[i] = table.index.indexOf(mapped[i]);
+    }
+    table.lower = table.exact;
+
+    addSubstitution(std::move(table));
+    return *this;
+}
+
+/**
+ * @brief Добавляет ступень шифра Гронсфельда.
+ *
+ * Сдвиг зависит от позиции по модулю длины ключа. Таблица строится одним вызовом
+ * шифра на строке, где в позиции l * P + p стоит буква l: так каждая буква
+ * попадает в каждую фазу p ключа.
+ */
+CipherChain& CipherChain::addGronsfeld(const std::vector<int>& key, const std::wstring& alphabet, bool encrypt) {
+    GronsfeldCipher cipher(key, alphabet);
+    const size_t m = alphabet.size();
+    const size_t period = key.size();
+
+    std::wstring probe;
+    probe.reserve(m * period);
+    for (wchar_t letter : alphabet) {
+        probe.append(period, letter);
+    }
+    std::wstring mapped = cipher.process(probe, encrypt);
+
+    SubstitutionTable table;
+    table.index = AlphabetIndex(alphabet);
+    table.kind = detectBuiltinAlphabet(alphabet);
+    table.period = period;
+    table.foldsCase = false;
+    table.exact.resize(m * period);
+    table.lower.assign(m * period, -1);
+    for (size_t l = 0; l < m; ++l) {
+        for (size_t p = 0; p < period; ++p) {
+            table.exact[p * m + l] = table.index.indexOf(mapped[l * period + p]);
+        }
+    }
+
+    addSubstitution(std::move(table));
+    return *this;
+}
+
+/**
+ * @brief Добавляет произвольную ступень.
+ */
+CipherChain& CipherChain::addStage(OpaqueStage stage) {
+    Pass pass;
+    pass.opaque = std::move(stage);
+    passes.push_back(std::move(pass));
+    return *this;
+}
+
+/**
+ * @brief Объединяет ступень с предыдущим проходом, если у них общий алфавит
+ * и объединённая таблица не превышает MAX_TABLE_SIZE.
+ */
+void CipherChain::addSubstitution(SubstitutionTable table) {
+    if (!passes.empty() && passes.back().fused) {
+        const SubstitutionTable& prev = passes.back().table;
+        size_t period = std::lcm(prev.period, table.period);
+        if (prev.index.alphabet() == table.index.alphabet() &&
+            period * static_cast<size_t>(table.index.size()) <= MAX_TABLE_SIZE) {
+            passes.back().table = compose(prev, table);
+            return;
+        }
+    }
+
+    Pass pass;
+    pass.fused = true;
+    pass.table = std::move(table);
+    passes.push_back(std::move(pass));
+}
+
+/**
+ * @brief Композиция двух подстановок: сначала first, затем second.
+ *
+ * Символ «после towupper» остаётся таким, пока его не обработает ступень,
+ * приводящая регистр; после этого он становится обычной буквой алфавита.
+ */
+CipherChain::SubstitutionTable CipherChain::compose(const SubstitutionTable& first,
+                                                    const SubstitutionTable& second) {
+    const size_t m = static_cast<size_t>(first.index.size());
+    SubstitutionTable result;
+    result.index = first.index;
+    result.kind = first.kind;
+    result.period = std::lcm(first.period, second.period);
+    result.foldsCase = first.foldsCase || second.foldsCase;
+    result.exact.resize(result.period * m);
+    result.lower.resize(result.period * m);
+
+    for (size_t p = 0; p < result.period; ++p) {
+        const int* firstExact = first.exact.data() + (p % first.period) * m;
+        const int* firstLower = first.lower.data() + (p % first.period) * m;
+        const int* secondExact = second.exact.data() + (p % second.period) * m;
+        const int* secondLower = second.lower.data() + (p % second.period) * m;
+        int* exact = result.exact.data() + p * m;
+        int* lower = result.lower.data() + p * m;
+
+        for (size_t i = 0; i < m; ++i) {
+            exact[i] = secondExact[firstExact[i]];
+            lower[i] = firstLower[i] >= 0 ? secondExact[firstLower[i]] : secondLower[i];
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Один проход объединённой подстановки; результат дописывается в out.
+ */
+template <class String>
+void CipherChain::applyTable(const SubstitutionTable& table, std::wstring_view text, String& out) {
+    out.reserve(out.size() + text.size());
+    dispatchAlphabet(table.kind, table.index, [&](const auto& alph) {
+        const size_t m = static_cast<size_t>(alph.size());
+        size_t phase = 0;
+        for (wchar_t c : text) {
+            int i = alph.indexOf(c);
+            if (i >= 0) {
+                out += alph.at(table.exact[phase * m + i]);
+            } else if (table.foldsCase && (i = alph.indexOf(static_cast<wchar_t>(towupper(c)))) >= 0) {
+                int r = table.lower[phase * m + i];
+                out += r >= 0 ? alph.at(r) : c;
+            } else {
+                out += c;
+            }
+            if (++phase == table.period) phase = 0;
+        }
+    });
+}
+
+/**
+ * @brief Выполняет все проходы; промежуточные строки используют аллокатор out.
+ */
+template <class String>
+void CipherChain::runInto(const std::wstring& text, String& out) const {
+    if (passes.empty()) {
+        out.append(text);
+        return;
+    }
+
+    String current(out.get_allocator());
+    String next(out.get_allocator());
+    std::wstring_view input = text;
+
+    for (size_t k = 0; k < passes.size(); ++k) {
+        const bool last = k + 1 == passes.size();
+        String& target = last ? out : next;
+
+        if (passes[k].fused) {
+            applyTable(passes[k].table, input, target);
+        } else {
+            std::wstring result = passes[k].opaque(std::wstring(input));
+            target.append(result.begin(), result.end());
+        }
+
+        if (!last) {
+            std::swap(current, next);
+            next.clear();
+            input = current;
+        }
+    }
+}
+
+/**
+ * @brief Применяет цепочку к тексту.
+ */
+std::wstring CipherChain::run(const std::wstring& text) const {
+    std::wstring result;
+    runInto(text, result);
+    return result;
+}
+
+/**
+ * @brief Применяет цепочку, беря память из mr.
+ */
+std::pmr::wstring CipherChain::run(const std::wstring& text, std::pmr::memory_resource* mr) const {
+    std::pmr::wstring result(mr);
+    runInto(text, result);
+    return result;
+}
+
+/**
+ * @brief Число проходов по данным после объединения.
+ */
+size_t CipherChain::passCount() const {
+    return passes.size();
+}
@@ -0,0 +1,123 @@
+/**
+ * @file cipher_chain.h
+ * @brief Заголовочный файл для класса CipherChain — цепочки шифров с объединением ступеней.
+ */
+
+#ifndef CIPHER_CHAIN_H
+#define CIPHER_CHAIN_H
+
+#include "alphabet_index.h"
+#include "alphabet_traits.h"
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Произвольная ступень цепочки, которую нельзя объединить с соседними.
+ */
+using OpaqueStage = std::function<std::wstring(const std::wstring& text)>;
+
+/**
+ * @class CipherChain
+ * @brief Последовательное применение нескольких шифров за минимальное число проходов.
+ *
+ * Аффинный шифр и шифр Гронсфельда — подстановки, зависящие только от символа и
+ * номера позиции по модулю периода (1 для аффинного, длина ключа для Гронсфельда).
+ * Подряд идущие такие ступени над одним алфавитом сворачиваются в одну таблицу
+ * с периодом НОК(P1, P2), и весь участок цепочки выполняется за один проход.
+ * Таблицы строятся запросами к самим шифрам, поэтому результат совпадает с
+ * последовательным применением ступеней.
+ */
+class CipherChain {
+public:
+    /**
+     * @brief Добавляет ступень аффинного шифра.
+     * @param a Ключ a.
+     * @param b Ключ b.
+     * @param alphabet Алфавит.
+     * @param encrypt true — шифрование, false — дешифрование.
+     * @return Ссылка на цепочку.
+     * @throw std::invalid_argument Если ключ некорректен (как в AffineCipher).
+     */
+    CipherChain& addAffine(int a, int b, const std::wstring& alphabet, bool encrypt = true);
+
+    /**
+     * @brief Добавляет ступень шифра Гронсфельда.
+     * @param key Числовой ключ.
+     * @param alphabet Алфавит.
+     * @param encrypt true — шифрование, false — дешифрование.
+     * @return Ссылка на цепочку.
+     * @throw std::invalid_argument Если ключ или алфавит некорректны (как в GronsfeldCipher).
+     */
+    CipherChain& addGronsfeld(const std::vector<int>& key, const std::wstring& alphabet, bool encrypt = true);
+
+    /**
+     * @brief Добавляет произвольную ступень; она разделяет объединяемые участки.
+     * @param stage Функция преобразования текста.
+     * @return Ссылка на цепочку.
+     */
+    CipherChain& addStage(OpaqueStage stage);
+
+    /**
+     * @brief Применяет цепочку к тексту.
+     * @param text Входной текст.
+     * @return Результат всех ступеней.
+     */
+    std::wstring run(const std::wstring& text) const;
+
+    /**
+     * @brief Применяет цепочку, размещая результат и промежуточные строки в ресурсе памяти mr.
+     */
+    std::pmr::wstring run(const std::wstring& text, std::pmr::memory_resource* mr) const;
+
+    /**
+     * @brief Число проходов по данным после объединения ступеней.
+     */
+    size_t passCount() const;
+
+    /**
+     * @brief Максимальный размер объединённой таблицы (период × размер алфавита).
+     *
+     * Если НОК периодов превышает этот предел, ступень начинает новый проход.
+     */
+    static constexpr size_t MAX_TABLE_SIZE = 1u << 20;
+
+private:
+    /**
+     * @brief Объединённая подстановка над одним алфавитом.
+     *
+     * exact[p * m + i] — индекс результата для буквы алфавита i в фазе p.
+     * lower[p * m + i] — то же для символа, который входит в алфавит только после
+     * towupper; -1 означает, что символ остаётся без изменений.
+     */
+    struct SubstitutionTable {
+        AlphabetIndex index{std::wstring()};
+        BuiltinAlphabet kind = BuiltinAlphabet::None;
+        size_t period = 1;
+        bool foldsCase = false;
+        std::vector<int> exact;
+        std::vector<int> lower;
+    };
+
+    struct Pass {
+        bool fused = false;
+        SubstitutionTable table;
+        OpaqueStage opaque;
+    };
+
+    std::vector<Pass> passes;
+
+    void addSubstitution(SubstitutionTable table);
+
+    static SubstitutionTable compose(const SubstitutionTable& first, const SubstitutionTable& second);
+
+    template <class String>
+    static void applyTable(const SubstitutionTable& table, std::wstring_view text, String& out);
+
+    template <class String>
+    void runInto(const std::wstring& text, String& out) const;
+};
+
+#endif // CIPHER_CHAIN_H
@@ -0,0 +1,65 @@
+/**
+ * @file cipher_client.cpp
+ * @brief Реализация клиента серверного режима.
+ */
+
+#include "cipher_client.h"
+#include "unix_socket.h"
+#include "utf8.h"
+#include <stdexcept>
+#include <unistd.h>
+
+CipherClient::CipherClient(const std::string& socketPath) : fd(connectUnix(socketPath)) {}
+
+CipherClient::~CipherClient() {
+    ::close(fd);
+}
+
+std::wstring CipherClient::encrypt(const CipherSpec& spec, const std::wstring& text) {
+    return call(spec, text, true);
+}
+
+std::wstring CipherClient::decrypt(const CipherSpec& spec, const std::wstring& text) {
+    return call(spec, text, false);
+}
+
+void CipherClient::send(const CipherRequest& request) {
+    sendAll(fd, encodeRequest(request));
+}
+
+CipherResponse CipherClient::receive() {
+    char header[4];
+    if (!recvExact(fd, header, sizeof(header))) {
+        throw std::runtime_error("Server closed the connection.");
+    }
+    std::uint32_t size = frameBodySize(header);
+    if (size > MAX_FRAME_SIZE) {
+        throw std::runtime_error("Response frame is too large.");
+    }
+    std::string body(size, '\0');
+    if (size > 0 && !recvExact(fd, &body[0], size)) {
+        throw std::runtime_error("Server closed the connection.");
+    }
+    return decodeResponse(body);
+}
+
+/**
+ * @brief Синхронный запрос: отправка и ожидание ответа с тем же номером.
+ */
+std::wstring CipherClient::call(const CipherSpec& spec, const std::wstring& text, bool encrypt) {
+    CipherRequest request;
+    request.id = nextId++;
+    request.encrypt = encrypt;
+    request.spec = spec;
+    request.text = text;
+    send(request);
+
+    CipherResponse response = receive();
+    while (response.id != request.id) {
+        response = receive();
+    }
+    if (!response.ok) {
+        throw std::runtime_error(toUtf8(response.payload));
+    }
+    return response.payload;
+}
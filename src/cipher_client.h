@@ -0,0 +1,63 @@
+/**
+ * @file cipher_client.h
+ * @brief Клиент серверного режима (только POSIX).
+ */
+
+#ifndef CIPHER_CLIENT_H
+#define CIPHER_CLIENT_H
+
+#include "cipher_protocol.h"
+#include <cstdint>
+#include <string>
+
+/**
+ * @class CipherClient
+ * @brief Соединение с CipherServer.
+ *
+ * encrypt/decrypt ждут ответа на каждый запрос. Для конвейерной отправки
+ * можно вызывать send несколько раз подряд, а затем receive; ответы
+ * сопоставляются по CipherRequest::id. Объект не потокобезопасен.
+ */
+class CipherClient {
+public:
+    /**
+     * @brief Подключается к серверу.
+     * @throw std::runtime_error Если подключиться не удалось.
+     */
+    explicit CipherClient(const std::string& socketPath);
+    ~CipherClient();
+
+    CipherClient(const CipherClient&) = delete;
+    CipherClient& operator=(const CipherClient&) = delete;
+
+    /**
+     * @brief Шифрует текст на сервере.
+     * @throw std::runtime_error Если сервер вернул ошибку или соединение оборвалось.
+     */
+    std::wstring encrypt(const CipherSpec& spec, const std::wstring& text);
+
+    /**
+     * @brief Дешифрует текст на сервере.
+     * @throw std::runtime_error Если сервер вернул ошибку или соединение оборвалось.
+     */
+    std::wstring decrypt(const CipherSpec& spec, const std::wstring& text);
+
+    /**
+     * @brief Отправляет запрос, не дожидаясь ответа.
+     */
+    void send(const CipherRequest& request);
+
+    /**
+     * @brief Получает следующий ответ.
+     * @throw std::runtime_error Если соединение закрыто.
+     */
+    CipherResponse receive();
+
+private:
+    std::wstring call(const CipherSpec& spec, const std::wstring& text, bool encrypt);
+
+    int fd;
+    std::uint32_t nextId = 1;
+};
+
+#endif // CIPHER_CLIENT_H
@@ -0,0 +1,71 @@
+/**
+ * @file cipher_daemon.cpp
+ * @brief Точка входа серверного режима: cipher_daemon <socket> [workers] [batch] [metrics-file].
+ *
+ * Сервер работает до SIGINT или SIGTERM, затем удаляет файл сокета.
+ * Если задан metrics-file, счётчики шифров записываются в него в формате
+ * Prometheus по SIGUSR1 и при остановке.
+ */
+
+#include "cipher_server.h"
+#include "metrics.h"
+#include <clocale>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <pthread.h>
+#include <string>
+
+namespace
+{
+    void dumpMetrics(const std::string& path)
+    {
+        if (path.empty()) return;
+        try {
+            metrics::writePrometheusFile(path);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <socket-path> [workers] [batch] [metrics-file]\n";
+        return 2;
+    }
+    std::setlocale(LC_ALL, "");
+
+    CipherServerOptions options;
+    options.socketPath = argv[1];
+    if (argc > 2) options.workers = std::strtoul(argv[2], nullptr, 10);
+    if (argc > 3) options.maxBatch = std::strtoul(argv[3], nullptr, 10);
+    std::string metricsPath = argc > 4 ? argv[4] : "";
+
+    // Сигналы блокируются до запуска потоков, чтобы их получал только sigwait.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    CipherServer server(options);
+    try {
+        server.start();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    std::cerr << "Listening on " << options.socketPath << "\n";
+
+    int received = 0;
+    while (sigwait(&signals, &received) == 0 && received == SIGUSR1) {
+        dumpMetrics(metricsPath);
+    }
+
+    server.stop();
+    dumpMetrics(metricsPath);
+    std::cerr << "Stopped after " << server.processedCount() << " requests\n";
+    return 0;
+}
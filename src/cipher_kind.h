@@ -0,0 +1,61 @@
+/**
+ * @file cipher_kind.h
+ * @brief Перечисление шифров проекта и их названия.
+ */
+
+#ifndef CIPHER_KIND_H
+#define CIPHER_KIND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Тип шифра. Значения используются в сетевом протоколе и не должны меняться.
+ */
+enum class CipherKind : std::uint8_t {
+    Xor = 1,        ///< Ключ — строка; шифрование даёт HEX, дешифрование принимает HEX
+    Gronsfeld = 2,  ///< Ключ — числа через пробел или запятую, например "3 1 4"
+    Vigenere = 3,   ///< Ключ — строка
+    Affine = 4,     ///< Ключ — "a b"
+    RailFence = 5,  ///< Ключ — число рельс
+    TurnGrid = 6,   ///< Ключ — размер решётки
+    Reverser = 7,   ///< Ключ — "размер_блока уменьшение(0/1)"
+    Polybius = 8,   ///< Ключ — сдвиг по модулю 64
+    Pi = 9          ///< Ключ — позиция в числе Пи
+};
+
+/// Число видов шифров.
+constexpr std::size_t CIPHER_KIND_COUNT = 9;
+
+/**
+ * @brief Порядковый номер шифра от 0 до CIPHER_KIND_COUNT - 1.
+ */
+constexpr std::size_t cipherKindIndex(CipherKind kind) {
+    return static_cast<std::size_t>(kind) - 1;
+}
+
+/**
+ * @brief Название шифра для сообщений, метрик и командной строки ("affine", "xor", ...).
+ */
+inline const char* cipherKindName(CipherKind kind) {
+    static const char* const names[CIPHER_KIND_COUNT] = {
+        "xor", "gronsfeld", "vigenere", "affine", "railfence", "turngrid", "reverser", "polybius", "pi"};
+    size_t index = cipherKindIndex(kind);
+    return index < CIPHER_KIND_COUNT ? names[index] : "unknown";
+}
+
+/**
+ * @brief Тип шифра по названию.
+ * @throw std::invalid_argument Если название неизвестно.
+ */
+inline CipherKind parseCipherKind(const std::string& name) {
+    for (std::size_t i = 0; i < CIPHER_KIND_COUNT; ++i) {
+        CipherKind kind = static_cast<CipherKind>(i + 1);
+        if (name == cipherKindName(kind)) return kind;
+    }
+    throw std::invalid_argument("Unknown cipher: " + name);
+}
+
+#endif // CIPHER_KIND_H
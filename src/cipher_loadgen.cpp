@@ -0,0 +1,147 @@
+/**
+ * @file cipher_loadgen.cpp
+ * @brief Генератор нагрузки для серверного режима.
+ *
+ * cipher_loadgen <socket> [connections] [requests] [length] [depth] [cipher] [key]
+ *
+ * Каждое соединение держит до depth запросов «в полёте» и отправляет requests
+ * запросов со случайным текстом длины length. В конце выводятся пропускная
+ * способность и перцентили задержки.
+ */
+
+#include "cipher_client.h"
+#include "alphabet_traits.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Settings {
+        std::string socketPath;
+        size_t connections = 4;
+        size_t requests = 10000;
+        size_t length = 64;
+        size_t depth = 16;
+        CipherSpec spec{CipherKind::Affine, L"5 8", L""};
+    };
+
+    /**
+     * @brief Один клиент: конвейер глубины depth; задержки пишутся в latencies (мкс).
+     */
+    void runConnection(const Settings& settings, unsigned seed, std::vector<double>& latencies)
+    {
+        CipherClient client(settings.socketPath);
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> letter(0, static_cast<int>(EN_ALPHABET.size()));
+
+        std::vector<Clock::time_point> sentAt(settings.requests);
+        latencies.reserve(settings.requests);
+
+        CipherRequest request;
+        request.spec = settings.spec;
+        request.text.resize(settings.length);
+
+        size_t sent = 0;
+        size_t received = 0;
+        while (received < settings.requests) {
+            while (sent < settings.requests && sent - received < settings.depth) {
+                for (auto& c : request.text) {
+                    int i = letter(rng);
+                    c = i == static_cast<int>(EN_ALPHABET.size()) ? L' ' : EN_ALPHABET[i];
+                }
+                request.id = static_cast<std::uint32_t>(sent);
+                sentAt[sent] = Clock::now();
+                client.send(request);
+                ++sent;
+            }
+
+            CipherResponse response = client.receive();
+            if (!response.ok) {
+                throw std::runtime_error("Server returned an error for request " + std::to_string(response.id));
+            }
+            auto elapsed = Clock::now() - sentAt[response.id];
+            latencies.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+            ++received;
+        }
+    }
+
+    double percentile(std::vector<double>& values, double p)
+    {
+        if (values.empty()) return 0.0;
+        size_t index = static_cast<size_t>(p * (values.size() - 1));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <socket-path> [connections] [requests] [length] [depth] [cipher] [key]\n";
+        return 2;
+    }
+
+    Settings settings;
+    settings.socketPath = argv[1];
+    if (argc > 2) settings.connections = std::max(1ul, std::strtoul(argv[2], nullptr, 10));
+    if (argc > 3) settings.requests = std::strtoul(argv[3], nullptr, 10);
+    if (argc > 4) settings.length = std::strtoul(argv[4], nullptr, 10);
+    if (argc > 5) settings.depth = std::max(1ul, std::strtoul(argv[5], nullptr, 10));
+    try {
+        if (argc > 6) settings.spec.kind = parseCipherKind(argv[6]);
+        if (argc > 7) {
+            std::string key = argv[7];
+            settings.spec.key.assign(key.begin(), key.end());
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 2;
+    }
+
+    std::vector<std::vector<double>> latencies(settings.connections);
+    std::vector<std::thread> threads;
+    std::vector<std::string> errors(settings.connections);
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < settings.connections; ++i) {
+        threads.emplace_back([&, i] {
+            try {
+                runConnection(settings, static_cast<unsigned>(i + 1), latencies[i]);
+            } catch (const std::exception& e) {
+                errors[i] = e.what();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (const auto& error : errors) {
+        if (!error.empty()) {
+            std::cerr << "Error: " << error << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<double> all;
+    for (const auto& part : latencies) {
+        all.insert(all.end(), part.begin(), part.end());
+    }
+
+    std::cout << "cipher:      " << cipherKindName(settings.spec.kind) << "\n"
+              << "requests:    " << all.size() << " over " << settings.connections << " connections\n"
+              << "throughput:  " << static_cast<double>(all.size()) / seconds << " req/s, "
+              << static_cast<double>(all.size() * settings.length) / seconds / 1e6 << " Mchar/s\n"
+              << "latency p50: " << percentile(all, 0.50) << " us\n"
+              << "latency p99: " << percentile(all, 0.99) << " us\n";
+    return 0;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file cipher_protocol.cpp
+ * @brief Кодирование и разбор кадров серверного протокола.
+ */
+
+#include "cipher_protocol.h"
+#include "utf8.h"
+#include <stdexcept>
+
+namespace
+{
+    void putU32(std::string& out, std::uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i) {
+            out += static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    void putString(std::string& out, std::wstring_view text)
+    {
+        std::string bytes = toUtf8(text);
+        putU32(out, static_cast<std::uint32_t>(bytes.size()));
+        out += bytes;
+    }
+
+    /**
+     * @brief Последовательное чтение полей тела с проверкой границ.
+     */
+    class Reader {
+    public:
+        explicit Reader(std::string_view body) : body(body) {}
+
+        std::uint8_t u8()
+        {
+            need(1);
+            return static_cast<std::uint8_t>(body[pos++]);
+        }
+
+        std::uint32_t u32()
+        {
+            need(4);
+            std::uint32_t value = frameBodySize(body.data() + pos);
+            pos += 4;
+            return value;
+        }
+
+        std::wstring string()
+        {
+            std::uint32_t size = u32();
+            need(size);
+            std::wstring text = fromUtf8(body.substr(pos, size));
+            pos += size;
+            return text;
+        }
+
+        void finish() const
+        {
+            if (pos != body.size()) {
+                throw std::invalid_argument("Trailing bytes in frame.");
+            }
+        }
+
+    private:
+        void need(size_t count) const
+        {
+            if (body.size() - pos < count) {
+                throw std::invalid_argument("Truncated frame.");
+            }
+        }
+
+        std::string_view body;
+        size_t pos = 0;
+    };
+
+    void finishFrame(std::string& frame)
+    {
+        std::uint32_t size = static_cast<std::uint32_t>(frame.size() - 4);
+        for (int i = 0; i < 4; ++i) {
+            frame[i] = static_cast<char>((size >> (8 * i)) & 0xFF);
+        }
+    }
+}
+
+std::uint32_t frameBodySize(const char* header) {
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<std::uint32_t>(static_cast<unsigned char>(header[i])) << (8 * i);
+    }
+    return value;
+}
+
+std::string encodeRequest(const CipherRequest& request) {
+    std::string frame(4, '\0');
+    frame.reserve(4 + 18 + request.text.size() + request.spec.key.size() + request.spec.alphabet.size());
+    putU32(frame, request.id);
+    frame += static_cast<char>(request.encrypt ? 1 : 2);
+    frame += static_cast<char>(request.spec.kind);
+    putString(frame, request.spec.key);
+    putString(frame, request.spec.alphabet);
+    putString(frame, request.text);
+    finishFrame(frame);
+    return frame;
+}
+
+CipherRequest decodeRequest(std::string_view body) {
+    Reader reader(body);
+    CipherRequest request;
+    request.id = reader.u32();
+
+    std::uint8_t op = reader.u8();
+    if (op != 1 && op != 2) {
+        throw std::invalid_argument("Unknown operation.");
+    }
+    request.encrypt = op == 1;
+
+    std::uint8_t kind = reader.u8();
+    if (kind < static_cast<std::uint8_t>(CipherKind::Xor) || kind > static_cast<std::uint8_t>(CipherKind::Pi)) {
+        throw std::invalid_argument("Unknown cipher kind.");
+    }
+    request.spec.kind = static_cast<CipherKind>(kind);
+    request.spec.key = reader.string();
+    request.spec.alphabet = reader.string();
+    request.text = reader.string();
+    reader.finish();
+    return request;
+}
+
+std::string encodeResponse(const CipherResponse& response) {
+    return encodeResponse(response.id, response.ok, response.payload);
+}
+
+std::string encodeResponse(std::uint32_t id, bool ok, std::wstring_view payload) {
+    std::string frame(4, '\0');
+    frame.reserve(4 + 9 + payload.size());
+    putU32(frame, id);
+    frame += static_cast<char>(ok ? 0 : 1);
+    putString(frame, payload);
+    finishFrame(frame);
+    return frame;
+}
+
+CipherResponse decodeResponse(std::string_view body) {
+    Reader reader(body);
+    CipherResponse response;
+    response.id = reader.u32();
+    response.ok = reader.u8() == 0;
+    response.payload = reader.string();
+    reader.finish();
+    return response;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file cipher_protocol.h
+ * @brief Двоичный протокол серверного режима: кадры с префиксом длины.
+ *
+ * Кадр: u32 длина тела (little-endian), затем тело.
+ *
+ * Тело запроса:  u32 id, u8 операция (1 — шифрование, 2 — дешифрование), u8 CipherKind,
+ *                затем три строки UTF-8 с префиксом u32: ключ, алфавит, текст.
+ * Тело ответа:   u32 id, u8 статус (0 — успех, 1 — ошибка), строка UTF-8 с префиксом u32:
+ *                результат или текст ошибки.
+ */
+
+#ifndef CIPHER_PROTOCOL_H
+#define CIPHER_PROTOCOL_H
+
+#include "cipher_service.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Максимальный размер тела кадра; большие кадры считаются ошибкой протокола.
+ */
+constexpr std::uint32_t MAX_FRAME_SIZE = 16u << 20;
+
+/**
+ * @brief Запрос к серверу.
+ */
+struct CipherRequest {
+    std::uint32_t id = 0;   ///< Номер запроса; возвращается в ответе
+    bool encrypt = true;    ///< true — шифрование, false — дешифрование
+    CipherSpec spec;        ///< Шифр и его параметры
+    std::wstring text;      ///< Входной текст
+};
+
+/**
+ * @brief Ответ сервера.
+ */
+struct CipherResponse {
+    std::uint32_t id = 0;   ///< Номер запроса
+    bool ok = true;         ///< false — payload содержит текст ошибки
+    std::wstring payload;   ///< Результат или текст ошибки
+};
+
+/**
+ * @brief Кодирует запрос в кадр (с префиксом длины).
+ */
+std::string encodeRequest(const CipherRequest& request);
+
+/**
+ * @brief Разбирает тело запроса (без префикса длины).
+ * @throw std::invalid_argument Если тело некорректно.
+ */
+CipherRequest decodeRequest(std::string_view body);
+
+/**
+ * @brief Кодирует ответ в кадр (с префиксом длины).
+ */
+std::string encodeResponse(const CipherResponse& response);
+
+/**
+ * @brief Кодирует ответ без промежуточной CipherResponse (результат может лежать в арене).
+ */
+std::string encodeResponse(std::uint32_t id, bool ok, std::wstring_view payload);
+
+/**
+ * @brief Разбирает тело ответа (без префикса длины).
+ * @throw std::invalid_argument Если тело некорректно.
+ */
+CipherResponse decodeResponse(std::string_view body);
+
+/**
+ * @brief Длина тела из первых четырёх байт кадра.
+ */
+std::uint32_t frameBodySize(const char* header);
+
+#endif // CIPHER_PROTOCOL_H
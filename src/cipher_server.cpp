@@ -0,0 +1,371 @@
+/**
+ * @file cipher_server.cpp
+ * @brief Реализация серверного режима на сокете Unix domain.
+ */
+
+#include "cipher_server.h"
+#include "unix_socket.h"
+#include "utf8.h"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <memory_resource>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <unordered_map>
+
+/**
+ * @brief Соединение клиента. Дескриптор закрывается, когда соединение
+ * больше не нужно ни потоку ввода, ни рабочим потокам.
+ */
+struct CipherServer::Connection {
+    explicit Connection(int fd) : fd(fd) {}
+    ~Connection() { ::close(fd); }
+
+    /**
+     * @brief Отправляет из output столько, сколько сокет примет без ожидания. Вызывается под outputMutex.
+     * @return false, если клиент отключился.
+     */
+    bool flush();
+
+    /** @brief Неотправленные байты ответов (под outputMutex). */
+    size_t pendingOutput() const { return output.size() - sent; }
+
+    int fd;
+    std::string input;        ///< Принятые, но ещё не разобранные байты (только поток ввода)
+    std::mutex outputMutex;   ///< Ответы разных потоков не перемешиваются
+    std::string output;       ///< Ответы, ещё не принятые сокетом (под outputMutex)
+    size_t sent = 0;          ///< Сколько байт начала output уже отправлено (под outputMutex)
+    bool broken = false;      ///< Отправка не удалась; соединение закроет поток ввода (под outputMutex)
+    std::atomic<size_t> pendingRequests{0}; ///< Запросов в очереди и в обработке
+    std::atomic<bool> readClosed{false};    ///< Клиент закрыл запись: ждём только отправки ответов
+};
+
+bool CipherServer::Connection::flush() {
+    while (!broken && sent < output.size()) {
+        ssize_t n = ::send(fd, output.data() + sent, output.size() - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        broken = true;
+    }
+    if (broken || sent == output.size()) {
+        output.clear();
+        sent = 0;
+    } else if (sent > output.size() / 2) {
+        output.erase(0, sent); // не сдвигаем буфер после каждой частичной отправки
+        sent = 0;
+    }
+    return !broken;
+}
+
+namespace
+{
+    constexpr size_t READ_CHUNK = 64 * 1024;       ///< Размер одного чтения из сокета
+    constexpr size_t WORKER_ARENA_SIZE = 256 * 1024; ///< Начальный буфер арены рабочего потока
+    constexpr size_t MAX_INPUT = 4 + MAX_FRAME_SIZE;  ///< Больше одного кадра за раз из сокета не читается
+
+    void setFlags(int fd)
+    {
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+
+    std::wstring errorText(const char* what)
+    {
+        try {
+            return fromUtf8(what);
+        } catch (const std::invalid_argument&) {
+            std::string ascii(what);
+            return std::wstring(ascii.begin(), ascii.end());
+        }
+    }
+}
+
+CipherServer::CipherServer(CipherServerOptions options)
+    : options_(std::move(options)), service_(options_.cache) {
+    if (options_.workers == 0) {
+        options_.workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (options_.maxBatch == 0) {
+        options_.maxBatch = 1;
+    }
+}
+
+CipherServer::~CipherServer() {
+    stop();
+}
+
+void CipherServer::start() {
+    if (running_) return;
+
+    listenFd_ = listenUnix(options_.socketPath, 128, &socketFile_);
+    if (::pipe(wakeFds_) < 0) {
+        ::close(listenFd_);
+        listenFd_ = -1;
+        throw std::runtime_error("pipe failed");
+    }
+    setFlags(wakeFds_[0]);
+    setFlags(wakeFds_[1]); // полный канал уже разбудит поток ввода
+
+    running_ = true;
+    ioThread_ = std::thread(&CipherServer::ioLoop, this);
+    for (size_t i = 0; i < options_.workers; ++i) {
+        workers_.emplace_back(&CipherServer::workerLoop, this);
+    }
+}
+
+void CipherServer::stop() {
+    if (!running_.exchange(false)) return;
+
+    wakeIoThread();
+    queueReady_.notify_all();
+
+    ioThread_.join();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        queue_.clear();
+    }
+    ::close(listenFd_);
+    ::close(wakeFds_[0]);
+    ::close(wakeFds_[1]);
+    listenFd_ = wakeFds_[0] = wakeFds_[1] = -1;
+    removeSocketFile(options_.socketPath, socketFile_); // путь мог перейти к другому серверу
+}
+
+void CipherServer::wakeIoThread() {
+    char byte = 0;
+    (void)!::write(wakeFds_[1], &byte, 1);
+}
+
+/**
+ * @brief Поток ввода: принимает соединения, читает кадры со всех клиентов и
+ * досылает ответы, которые сокеты не приняли сразу.
+ *
+ * Запросы, разобранные за один вызов poll, ставятся в очередь одной операцией.
+ * Соединение с переполненным буфером ответов или очередью запросов не читается,
+ * пока рабочие потоки и клиент их не разгрузят.
+ */
+void CipherServer::ioLoop() {
+    std::unordered_map<int, std::shared_ptr<Connection>> connections;
+    std::vector<pollfd> fds;
+    std::vector<Job> jobs;
+
+    while (running_) {
+        fds.clear();
+        fds.push_back({wakeFds_[0], POLLIN, 0});
+        fds.push_back({listenFd_, POLLIN, 0});
+        for (auto it = connections.begin(); it != connections.end();) {
+            Connection& connection = *it->second;
+            size_t output;
+            {
+                std::lock_guard<std::mutex> lock(connection.outputMutex);
+                output = connection.pendingOutput();
+                // Закрытое клиентом на запись соединение живёт, пока не отправлены все ответы.
+                if (connection.broken ||
+                    (connection.readClosed && output == 0 && connection.pendingRequests.load() == 0)) {
+                    it = connections.erase(it);
+                    continue;
+                }
+            }
+            short events = 0;
+            if (!connection.readClosed && output <= options_.maxPendingOutput &&
+                connection.pendingRequests.load() <= options_.maxPendingRequests) {
+                events |= POLLIN;
+            }
+            if (output != 0) events |= POLLOUT;
+            fds.push_back({it->first, events, 0});
+            ++it;
+        }
+
+        if (::poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[0].revents) {
+            char buffer[64];
+            while (::read(wakeFds_[0], buffer, sizeof(buffer)) > 0) {
+            }
+        }
+
+        if (fds[1].revents & POLLIN) {
+            int fd = ::accept(listenFd_, nullptr, nullptr);
+            if (fd >= 0) {
+                setFlags(fd);
+                connections.emplace(fd, std::make_shared<Connection>(fd));
+            }
+        }
+
+        for (size_t i = 2; i < fds.size(); ++i) {
+            if (!fds[i].revents) continue;
+            auto it = connections.find(fds[i].fd);
+            bool open = true;
+            if (it->second->readClosed && (fds[i].revents & (POLLHUP | POLLERR))) {
+                open = false; // клиент закрыл и чтение: ответы доставить некуда
+            } else if (fds[i].revents & POLLOUT) {
+                std::lock_guard<std::mutex> lock(it->second->outputMutex);
+                open = it->second->flush();
+            }
+            if (open && (fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                open = readFrom(it->second, jobs);
+            }
+            if (!open) {
+                connections.erase(it);
+            }
+        }
+        enqueue(jobs);
+    }
+}
+
+/**
+ * @brief Читает доступные байты соединения и выделяет из них полные кадры.
+ *
+ * Конец потока (клиент закрыл запись) только помечает соединение: ответы на
+ * уже принятые запросы ещё отправляются.
+ * @return false, если соединение оборвано или нарушило протокол.
+ */
+bool CipherServer::readFrom(const std::shared_ptr<Connection>& connection, std::vector<Job>& jobs) {
+    std::string& input = connection->input;
+    bool open = true;
+
+    while (input.size() < MAX_INPUT) {
+        size_t old = input.size();
+        input.resize(old + READ_CHUNK);
+        ssize_t n = ::recv(connection->fd, &input[old], READ_CHUNK, MSG_DONTWAIT);
+        input.resize(old + (n > 0 ? static_cast<size_t>(n) : 0));
+        if (n > 0) {
+            if (static_cast<size_t>(n) < READ_CHUNK) break;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n == 0) {
+            connection->readClosed = true;
+        } else {
+            open = false;
+        }
+        break;
+    }
+
+    size_t pos = 0;
+    while (input.size() - pos >= 4) {
+        std::uint32_t size = frameBodySize(input.data() + pos);
+        if (size > MAX_FRAME_SIZE) return false;
+        if (input.size() - pos - 4 < size) break;
+
+        std::string_view body(input.data() + pos + 4, size);
+        pos += 4 + size;
+        try {
+            jobs.push_back({connection, decodeRequest(body)});
+            ++connection->pendingRequests;
+        } catch (const std::exception& e) {
+            std::uint32_t id = body.size() >= 4 ? frameBodySize(body.data()) : 0;
+            std::lock_guard<std::mutex> lock(connection->outputMutex);
+            connection->output += encodeResponse({id, false, errorText(e.what())});
+            if (!connection->flush()) return false;
+        }
+    }
+    input.erase(0, pos);
+    return open;
+}
+
+void CipherServer::enqueue(std::vector<Job>& jobs) {
+    if (jobs.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        for (auto& job : jobs) {
+            queue_.push_back(std::move(job));
+        }
+    }
+    jobs.clear();
+    queueReady_.notify_all();
+}
+
+/**
+ * @brief Ответы пачки одному соединению.
+ */
+struct CipherServer::Outgoing {
+    Connection* connection;
+    std::string frames;
+    size_t requests;
+};
+
+/**
+ * @brief Рабочий поток: обрабатывает запросы пачками.
+ *
+ * Результаты пачки размещаются в одной арене, которая освобождается целиком
+ * после записи ответов. Ответы одному соединению дописываются в его буфер одной
+ * операцией и сразу отправляются, насколько сокет позволяет без ожидания;
+ * остаток досылает поток ввода.
+ */
+void CipherServer::workerLoop() {
+    std::pmr::monotonic_buffer_resource arena(WORKER_ARENA_SIZE);
+    std::vector<Job> batch;
+    std::vector<Outgoing> outgoing;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            queueReady_.wait(lock, [this] { return !running_ || !queue_.empty(); });
+            if (!running_) return;
+            while (!queue_.empty() && batch.size() < options_.maxBatch) {
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+        }
+
+        for (const Job& job : batch) {
+            const CipherRequest& request = job.request;
+            std::string frame;
+            try {
+                std::pmr::wstring result = service_.process(request.spec, request.text, request.encrypt, &arena);
+                frame = encodeResponse(request.id, true, result);
+            } catch (const std::exception& e) {
+                frame = encodeResponse(request.id, false, errorText(e.what()));
+            }
+
+            auto it = std::find_if(outgoing.begin(), outgoing.end(),
+                                   [&job](const auto& entry) { return entry.connection == job.connection.get(); });
+            if (it == outgoing.end()) {
+                outgoing.push_back({job.connection.get(), std::move(frame), 1});
+            } else {
+                it->frames += frame;
+                ++it->requests;
+            }
+        }
+
+        bool wake = false;
+        for (auto& entry : outgoing) {
+            Connection& connection = *entry.connection;
+            {
+                std::lock_guard<std::mutex> lock(connection.outputMutex);
+                if (!connection.broken) {
+                    connection.output += entry.frames;
+                    connection.flush();
+                }
+                // Остаток нужно дослать по POLLOUT; отключившееся соединение — закрыть.
+                wake |= connection.pendingOutput() != 0 || connection.broken;
+            }
+            // Соединение, которое не читалось из-за очереди, снова можно читать;
+            // закрытое клиентом на запись после последнего ответа можно закрыть.
+            const size_t before = connection.pendingRequests.fetch_sub(entry.requests);
+            wake |= before > options_.maxPendingRequests || (before == entry.requests && connection.readClosed);
+        }
+        if (wake) wakeIoThread();
+
+        processed_.fetch_add(batch.size(), std::memory_order_relaxed);
+        outgoing.clear();
+        batch.clear();
+        arena.release();
+    }
+}
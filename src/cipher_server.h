@@ -0,0 +1,110 @@
+/**
+ * @file cipher_server.h
+ * @brief Серверный режим: обработка запросов шифрования через сокет Unix domain (только POSIX).
+ */
+
+#ifndef CIPHER_SERVER_H
+#define CIPHER_SERVER_H
+
+#include "cipher_protocol.h"
+#include "cipher_service.h"
+#include "prepared_cache.h"
+#include "unix_socket.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Параметры сервера.
+ */
+struct CipherServerOptions {
+    std::string socketPath;  ///< Путь к файлу сокета
+    size_t workers = 0;      ///< Число рабочих потоков (0 — по числу ядер)
+    size_t maxBatch = 64;    ///< Сколько запросов рабочий поток забирает за раз
+    PreparedCacheOptions cache; ///< Сегменты и ограничение памяти кэша подготовленных шифров
+    size_t maxPendingOutput = 4u << 20; ///< Сколько байт неотправленных ответов на соединение, пока оно читается
+    size_t maxPendingRequests = 256;    ///< Сколько необработанных запросов на соединение, пока оно читается
+};
+
+/**
+ * @class CipherServer
+ * @brief Долгоживущий сервер с подготовленными шифрами.
+ *
+ * Один поток принимает соединения и читает кадры со всех клиентов; готовые
+ * запросы складываются в общую очередь. Рабочие потоки забирают запросы
+ * пачками (из разных соединений), обрабатывают их с одной переиспользуемой
+ * ареной и дописывают ответы в буфер соединения. Сокеты клиентов неблокирующие:
+ * буфер отправляет тот, кто в него дописал, а остаток — поток ввода по POLLOUT,
+ * так что клиент, не читающий ответы, не задерживает ни рабочие потоки, ни
+ * других клиентов. Пока у соединения больше maxPendingOutput неотправленных
+ * байт или больше maxPendingRequests необработанных запросов, сервер его не
+ * читает. Подготовленные шифры хранятся в кэше CipherService, поэтому разбор
+ * ключа и построение таблиц выполняются один раз на ключ.
+ */
+class CipherServer {
+public:
+    explicit CipherServer(CipherServerOptions options);
+    ~CipherServer();
+
+    CipherServer(const CipherServer&) = delete;
+    CipherServer& operator=(const CipherServer&) = delete;
+
+    /**
+     * @brief Создаёт сокет и запускает потоки.
+     * @throw std::runtime_error Если сокет не удалось создать (в том числе если путь занят работающим сервером).
+     */
+    void start();
+
+    /**
+     * @brief Останавливает потоки, закрывает соединения и удаляет файл сокета (если он всё ещё наш).
+     */
+    void stop();
+
+    /**
+     * @brief Хранилище подготовленных шифров.
+     */
+    CipherService& service() { return service_; }
+
+    /**
+     * @brief Число обработанных запросов.
+     */
+    size_t processedCount() const { return processed_.load(std::memory_order_relaxed); }
+
+private:
+    struct Connection;
+    struct Outgoing;
+
+    struct Job {
+        std::shared_ptr<Connection> connection;
+        CipherRequest request;
+    };
+
+    void ioLoop();
+    void workerLoop();
+    bool readFrom(const std::shared_ptr<Connection>& connection, std::vector<Job>& jobs);
+    void enqueue(std::vector<Job>& jobs);
+    void wakeIoThread();
+
+    CipherServerOptions options_;
+    CipherService service_;
+
+    int listenFd_ = -1;
+    SocketFile socketFile_; ///< Файл нашего сокета: удаляется при остановке, только если не заменён
+    int wakeFds_[2] = {-1, -1}; ///< Байт в канале будит поток ввода (остановка или новые ответы)
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> processed_{0};
+
+    std::thread ioThread_;
+    std::vector<std::thread> workers_;
+
+    std::mutex queueMutex_;
+    std::condition_variable queueReady_;
+    std::deque<Job> queue_;
+};
+
+#endif // CIPHER_SERVER_H
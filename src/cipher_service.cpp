@@ -0,0 +1,313 @@
+/**
+ * @file cipher_service.cpp
+ * @brief Реализация подготовленных шифров и их хранилища.
+ */
+
+#include "cipher_service.h"
+#include "cipher_protocol.h"
+#include "prepared_cache.h"
+#include "affine_cipher.h"
+#include "alphabet_traits.h"
+#include "cipher_batch.h"
+#include "gronsfeld_cipher.h"
+#include "pi_cipher.h"
+#include "polybius_cipher.h"
+#include "rail_fence_cipher.h"
+#include "reverser_cipher.h"
+#include "turn_grid_cipher.h"
+#include "vigenere_cipher.h"
+#include "xor_cipher.h"
+#include <cerrno>
+#include <climits>
+#include <cwchar>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief Разбирает целые числа, разделённые пробелами, запятыми или точками с запятой.
+     * @throw std::invalid_argument Если ключ пуст, содержит что-то кроме чисел или число вне диапазона int.
+     */
+    std::vector<int> parseInts(const std::wstring& key)
+    {
+        std::vector<int> values;
+        const wchar_t* p = key.c_str();
+        while (*p) {
+            if (*p == L' ' || *p == L',' || *p == L';') {
+                ++p;
+                continue;
+            }
+            wchar_t* end = nullptr;
+            errno = 0;
+            long value = std::wcstol(p, &end, 10);
+            if (end == p) {
+                throw std::invalid_argument("Key must consist of integers.");
+            }
+            if (errno == ERANGE || value < INT_MIN || value > INT_MAX) {
+                throw std::invalid_argument("Key value is out of range.");
+            }
+            values.push_back(static_cast<int>(value));
+            p = end;
+        }
+        if (values.empty()) {
+            throw std::invalid_argument("Key must not be empty.");
+        }
+        return values;
+    }
+
+    /**
+     * @brief Разбирает ровно count целых чисел.
+     */
+    std::vector<int> parseInts(const std::wstring& key, size_t count)
+    {
+        std::vector<int> values = parseInts(key);
+        if (values.size() != count) {
+            throw std::invalid_argument("Unexpected number of key values.");
+        }
+        return values;
+    }
+
+    const std::wstring& alphabetOrDefault(const CipherSpec& spec)
+    {
+        return spec.alphabet.empty() ? EN_ALPHABET : spec.alphabet;
+    }
+
+    class PreparedXor : public PreparedCipher {
+    public:
+        explicit PreparedXor(const CipherSpec& spec) : cipher(spec.key, alphabetOrDefault(spec)) {}
+        std::pmr::wstring apply(const std::wstring& text, bool encrypt, std::pmr::memory_resource* mr) const override {
+            return encrypt ? cipher.encryptToHex(text, mr) : cipher.decryptFromHex(text, mr);
+        }
+        void applyBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const override {
+            cipher.processBatch(texts, encrypt, out);
+        }
+        StreamUnit streamUnit() const override { return StreamUnit::Bytes; }
+        void applyBytes(const char* in, size_t size, char* out, std::uint64_t position) const override {
+            cipher.xorBytes(in, size, out, position);
+        }
+    private:
+        XORCipher cipher;
+    };
+
+    class PreparedGronsfeld : public PreparedCipher {
+    public:
+        explicit PreparedGronsfeld(const CipherSpec& spec) : cipher(parseInts(spec.key), alphabetOrDefault(spec)) {}
+        std::pmr::wstring apply(const std::wstring& text, bool encrypt, std::pmr::memory_resource* mr) const override {
+            return cipher.process(text, encrypt, mr);
+        }
+        void applyBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const override {
+            cipher.processBatch(texts, encrypt, out);
+        }
+        StreamUnit streamUnit() const override { return StreamUnit::Text; }
+        std::uint64_t keySteps(std::wstring_view text) const override { return text.size(); }
+        std::pmr::wstring applyAt(const std::wstring& text, bool encrypt, std::uint64_t keyStep,
+                                  std::pmr::memory_resource* mr) const override {
+            return cipher.process(text, encrypt, mr, keyStep);
+        }
+    private:
+        GronsfeldCipher cipher;
+    };
+
+    class PreparedVigenere : public PreparedCipher {
+    public:
+        explicit PreparedVigenere(const CipherSpec& spec) : cipher(spec.key) {}
+        std::pmr::wstring apply(const std::wstring& text, bool encrypt, std::pmr::memory_resource* mr) const override {
+            return encrypt ? cipher.zasifrovat(text, mr) : cipher.rasshifrovat(text, mr);
+        }
+        void applyBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const override {
+            cipher.obrabotatPaket(texts, encrypt, out);
+        }
+        StreamUnit streamUnit() const override { return StreamUnit::Text; }
+        std::uint64_t keySteps(std::wstring_view text) const override { return cipher.shagiKlyucha(text); }
+        std::pmr::wstring applyAt(const std::wstring& text, bool encrypt, std::uint64_t keyStep,
+                                  std::pmr::memory_resource* mr) const override {
+            return cipher.obrabotat(text, encrypt, keyStep, mr);
+        }
+    private:
+        VigenereCipher cipher;
+    };
+
+    class PreparedAffine : public PreparedCipher {
+    public:
+        explicit PreparedAffine(const CipherSpec& spec) : cipher(create(spec)) {}
+        std::pmr::wstring apply(const std::wstring& text, bool encrypt, std::pmr::memory_resource* mr) const override {
+            return encrypt ? cipher.encrypt(text, mr) : cipher.decrypt(text, mr);
+        }
+        void applyBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const override {
+            cipher.processBatch(texts, encrypt, out);
+        }
+        StreamUnit streamUnit() const override { return StreamUnit::Text; }
+    private:
+        static AffineCipher create(const CipherSpec& spec) {
+            std::vector<int> ab = parseInts(spec.key, 2);
+            return AffineCipher(ab[0], ab[1], alphabetOrDefault(spec));
+        }
+        AffineCipher cipher;
+    };
+
+    class PreparedRailFence : public PreparedCipher {
+    public:
+        explicit PreparedRailFence(const CipherSpec& spec) : cipher(parseInts(spec.key, 1)[0]) {}
+        std::pmr::wstring apply(const std::wstring& text, bool encrypt, std::pmr::memory_resource* mr) const override {
+            return encrypt ? cipher.encrypt(text, mr) : cipher.decrypt(text, mr);
+        }
+        void applyBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const override {
+            cipher.processBatch(texts, encrypt, out);
+        }
+    private:
+        RailFenceCipher cipher;
+    };
+
+    /**
+     * @brief Размер решётки из ключа клиента.
+     *
+     * Решётка и сетка занимают size^2 клеток на каждый запрос, а текст длиннее
+     * MAX_FRAME_SIZE символов в кадр не помещается, поэтому большие решётки бесполезны.
+     */
+    int grilleSize(const CipherSpec& spec)
+    {
+        const int size = parseInts(spec.key, 1)[0];
+        if (size <= 0 || static_cast<std::uint64_t>(size) * static_cast<std::uint64_t>(size) > MAX_FRAME_SIZE) {
+            throw std::invalid_argument("Grille size is out of range.");
+        }
+        return size;
+    }
+
+    class PreparedTurnGrid : public PreparedCipher {
+    public:
+        explicit PreparedTurnGrid(const CipherSpec& spec) : cipher(grilleSize(spec)) {}
+        std::pmr::wstring apply(const std::wstring& text, bool encrypt, std::pmr::memory_resource* mr) const override {
+            return cipher.process(text, encrypt, mr);
+        }
+        void applyBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const override {
+            cipher.processBatch(texts, encrypt, out);
+        }
+    private:
+        TurnGridCipher cipher;
+    };
+
+    class PreparedReverser : public PreparedCipher {
+    public:
+        explicit PreparedReverser(const CipherSpec& spec) {
+            std::vector<int> values = parseInts(spec.key, 2);
+            if (values[0] < 1) {
+                throw std::invalid_argument("Block size must be positive");
+            }
+            blockSize = values[0];
+            shrinking = values[1] != 0;
+        }
+        std::pmr::wstring apply(const std::wstring& text, bool encrypt, std::pmr::memory_resource* mr) const override {
+            return encrypt ? ReverserCipher::encrypt(text, blockSize, shrinking, mr)
+                           : ReverserCipher::decrypt(text, blockSize, shrinking, mr);
+        }
+        void applyBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const override {
+            ReverserCipher::processBatch(texts, blockSize, shrinking, encrypt, out);
+        }
+    private:
+        int blockSize = 1;
+        bool shrinking = false;
+    };
+
+    class PreparedPolybius : public PreparedCipher {
+    public:
+        explicit PreparedPolybius(const CipherSpec& spec)
+            : board(PolybiusCipher::build_board(alphabetOrDefault(spec), parseInts(spec.key, 1)[0])) {}
+        std::pmr::wstring apply(const std::wstring& text, bool encrypt, std::pmr::memory_resource* mr) const override {
+            return encrypt ? PolybiusCipher::encrypt(text, board, mr) : PolybiusCipher::decrypt(text, board, mr);
+        }
+        void applyBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const override {
+            PolybiusCipher::processBatch(texts, board, encrypt, out);
+        }
+    private:
+        std::vector<std::vector<wchar_t>> board;
+    };
+
+    class PreparedPi : public PreparedCipher {
+    public:
+        explicit PreparedPi(const CipherSpec& spec) {
+            PiCipher::build_codebooks(parseInts(spec.key, 1)[0], alphabetOrDefault(spec), encMap, decMap);
+        }
+        std::pmr::wstring apply(const std::wstring& text, bool encrypt, std::pmr::memory_resource* mr) const override {
+            return encrypt ? PiCipher::encrypt(text, encMap, mr) : PiCipher::decrypt(text, decMap, mr);
+        }
+        void applyBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const override {
+            if (encrypt) {
+                PiCipher::encryptBatch(texts, encMap, out);
+            } else {
+                PiCipher::decryptBatch(texts, decMap, out);
+            }
+        }
+    private:
+        std::unordered_map<wchar_t, std::wstring> encMap;
+        std::unordered_map<std::wstring, wchar_t> decMap;
+    };
+}
+
+size_t CipherSpecHash::operator()(const CipherSpec& spec) const {
+    size_t h = std::hash<std::wstring>()(spec.key);
+    h ^= std::hash<std::wstring>()(spec.alphabet) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    h ^= static_cast<size_t>(spec.kind) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+void PreparedCipher::applyBytes(const char*, size_t, char*, std::uint64_t) const {
+    throw std::logic_error("Cipher does not process raw bytes.");
+}
+
+/**
+ * @brief Строит подготовленный шифр по описанию.
+ */
+std::shared_ptr<const PreparedCipher> PreparedCipher::create(const CipherSpec& spec) {
+    switch (spec.kind) {
+    case CipherKind::Xor:
+        return std::make_shared<PreparedXor>(spec);
+    case CipherKind::Gronsfeld:
+        return std::make_shared<PreparedGronsfeld>(spec);
+    case CipherKind::Vigenere:
+        return std::make_shared<PreparedVigenere>(spec);
+    case CipherKind::Affine:
+        return std::make_shared<PreparedAffine>(spec);
+    case CipherKind::RailFence:
+        return std::make_shared<PreparedRailFence>(spec);
+    case CipherKind::TurnGrid:
+        return std::make_shared<PreparedTurnGrid>(spec);
+    case CipherKind::Reverser:
+        return std::make_shared<PreparedReverser>(spec);
+    case CipherKind::Polybius:
+        return std::make_shared<PreparedPolybius>(spec);
+    case CipherKind::Pi:
+        return std::make_shared<PreparedPi>(spec);
+    }
+    throw std::invalid_argument("Unknown cipher kind.");
+}
+
+CipherService::CipherService() : CipherService(PreparedCacheOptions{}) {}
+
+CipherService::CipherService(const PreparedCacheOptions& options)
+    : cache(std::make_unique<PreparedCipherCache>(options)) {}
+
+CipherService::~CipherService() = default;
+
+std::shared_ptr<const PreparedCipher> CipherService::prepare(const CipherSpec& spec) {
+    return cache->get(spec);
+}
+
+std::pmr::wstring CipherService::process(const CipherSpec& spec, const std::wstring& text, bool encrypt,
+                                         std::pmr::memory_resource* mr) {
+    return prepare(spec)->apply(text, encrypt, mr);
+}
+
+void CipherService::processBatch(const CipherSpec& spec, const TextBatch& texts, bool encrypt, CipherBatch& out) {
+    prepare(spec)->applyBatch(texts, encrypt, out);
+}
+
+size_t CipherService::preparedCount() const {
+    return cache->stats().entries;
+}
+
+PreparedCacheStats CipherService::cacheStats() const {
+    return cache->stats();
+}
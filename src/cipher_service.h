@@ -0,0 +1,162 @@
+/**
+ * @file cipher_service.h
+ * @brief Описание шифра параметрами (CipherSpec) и подготовленные экземпляры шифров.
+ *
+ * Используется там, где шифр выбирается во время выполнения: серверный режим,
+ * пакетная обработка файлов. Подготовка (разбор ключа, таблицы, доска Полибия,
+ * кодовые таблицы Пи) выполняется один раз на набор параметров.
+ */
+
+#ifndef CIPHER_SERVICE_H
+#define CIPHER_SERVICE_H
+
+#include "cipher_kind.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+class TextBatch;
+class CipherBatch;
+class PreparedCipherCache;
+struct PreparedCacheOptions;
+struct PreparedCacheStats;
+
+/**
+ * @brief Полное описание шифра: тип, ключ в текстовом виде и алфавит.
+ *
+ * Пустой алфавит означает EN_ALPHABET. Для шифров без алфавита он не используется.
+ */
+struct CipherSpec {
+    CipherKind kind = CipherKind::Affine;
+    std::wstring key;
+    std::wstring alphabet;
+
+    bool operator==(const CipherSpec& other) const {
+        return kind == other.kind && key == other.key && alphabet == other.alphabet;
+    }
+};
+
+/**
+ * @brief Хеш CipherSpec для неупорядоченных контейнеров.
+ */
+struct CipherSpecHash {
+    size_t operator()(const CipherSpec& spec) const;
+};
+
+/**
+ * @brief Как шифр обрабатывает поток, разрезанный на блоки (см. file_pipeline.h).
+ */
+enum class StreamUnit {
+    Whole, ///< Только весь текст целиком (перестановки, шифры с кодовыми группами)
+    Text,  ///< Блоки текста по границам символов; позиция ключа переходит из блока в блок
+    Bytes  ///< Блоки байтов; позиция ключа — смещение в потоке
+};
+
+/**
+ * @class PreparedCipher
+ * @brief Шифр с разобранным ключом и готовыми таблицами. Неизменяем и потокобезопасен.
+ */
+class PreparedCipher {
+public:
+    virtual ~PreparedCipher() = default;
+
+    /**
+     * @brief Шифрует или дешифрует текст; результат и временные буферы берутся из mr.
+     */
+    virtual std::pmr::wstring apply(const std::wstring& text, bool encrypt,
+                                    std::pmr::memory_resource* mr) const = 0;
+
+    /**
+     * @brief Шифрует или дешифрует пакет сообщений, дописывая результаты в out (см. cipher_batch.h).
+     * @throw Как apply; готовые до ошибки сообщения остаются в out.
+     */
+    virtual void applyBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const = 0;
+
+    /**
+     * @brief Можно ли обрабатывать поток по блокам и какими.
+     */
+    virtual StreamUnit streamUnit() const { return StreamUnit::Whole; }
+
+    /**
+     * @brief На сколько позиций блок text продвигает ключ (StreamUnit::Text).
+     */
+    virtual std::uint64_t keySteps(std::wstring_view text) const {
+        (void)text;
+        return 0;
+    }
+
+    /**
+     * @brief Как apply, но для блока, перед которым ключ продвинулся на keyStep позиций (StreamUnit::Text).
+     */
+    virtual std::pmr::wstring applyAt(const std::wstring& text, bool encrypt, std::uint64_t keyStep,
+                                      std::pmr::memory_resource* mr) const {
+        (void)keyStep;
+        return apply(text, encrypt, mr);
+    }
+
+    /**
+     * @brief Обрабатывает size байтов с позиции position потока (StreamUnit::Bytes).
+     * @throw std::logic_error Если шифр не работает с байтами.
+     */
+    virtual void applyBytes(const char* in, std::size_t size, char* out, std::uint64_t position) const;
+
+    /**
+     * @brief Разбирает ключ и строит шифр по описанию.
+     * @throw std::invalid_argument Если ключ или алфавит некорректны.
+     * @throw std::runtime_error Если шифр отвергает параметры (например, XOR).
+     */
+    static std::shared_ptr<const PreparedCipher> create(const CipherSpec& spec);
+};
+
+/**
+ * @class CipherService
+ * @brief Хранит подготовленные шифры по параметрам и выполняет запросы.
+ *
+ * Подготовленные шифры лежат в PreparedCipherCache (prepared_cache.h): редко
+ * используемые ключи вытесняются, когда кэш выходит за ограничение памяти.
+ */
+class CipherService {
+public:
+    CipherService();
+    explicit CipherService(const PreparedCacheOptions& options);
+    ~CipherService();
+
+    CipherService(const CipherService&) = delete;
+    CipherService& operator=(const CipherService&) = delete;
+
+    /**
+     * @brief Подготовленный шифр для spec; создаётся при первом обращении.
+     */
+    std::shared_ptr<const PreparedCipher> prepare(const CipherSpec& spec);
+
+    /**
+     * @brief Шифрует или дешифрует text шифром spec.
+     */
+    std::pmr::wstring process(const CipherSpec& spec, const std::wstring& text, bool encrypt,
+                              std::pmr::memory_resource* mr);
+
+    /**
+     * @brief Шифрует или дешифрует пакет сообщений одним шифром spec.
+     *
+     * Шифр ищется в кэше один раз на пакет.
+     */
+    void processBatch(const CipherSpec& spec, const TextBatch& texts, bool encrypt, CipherBatch& out);
+
+    /**
+     * @brief Число подготовленных шифров в кэше.
+     */
+    size_t preparedCount() const;
+
+    /**
+     * @brief Попадания, промахи, вытеснения и занятая память кэша.
+     */
+    PreparedCacheStats cacheStats() const;
+
+private:
+    std::unique_ptr<PreparedCipherCache> cache;
+};
+
+#endif // CIPHER_SERVICE_H
@@ -0,0 +1,286 @@
+/**
+ * @file differential.cpp
+ * @brief Генерация случайных входов, сверка с эталоном и замер ускорения.
+ */
+
+#include "differential.h"
+#include "affine_cipher.h"
+#include "alphabet_traits.h"
+#include "gronsfeld_cipher.h"
+#include "reference_kernels.h"
+#include "vigenere_cipher.h"
+#include "xor_cipher.h"
+#include <algorithm>
+#include <chrono>
+#include <cwctype>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <typeinfo>
+
+namespace
+{
+    using Rng = std::mt19937;
+
+    /// Символы вне любых алфавитов: цифры, пунктуация, управляющие, буквы с диакритикой.
+    const std::wstring OTHER_CHARS = L"0123456789.,!?;:-'\"()[]@#\t\néßЁё";
+
+    /**
+     * @brief Один вход: текст и обе реализации, уже настроенные на ключ и алфавит.
+     */
+    struct Trial {
+        std::wstring input;
+        std::function<std::wstring()> reference;
+        std::function<std::wstring()> fast;
+    };
+
+    /// timing = true: вход для замера скорости, отказы (исключения) не нужны.
+    using TrialFactory = std::function<Trial(Rng& rng, size_t length, bool timing)>;
+
+    struct CaseSpec {
+        const char* name;
+        TrialFactory make;
+    };
+
+    size_t pick(Rng& rng, size_t n)
+    {
+        return std::uniform_int_distribution<size_t>(0, n - 1)(rng);
+    }
+
+    int pickInt(Rng& rng, int lo, int hi)
+    {
+        return std::uniform_int_distribution<int>(lo, hi)(rng);
+    }
+
+    /**
+     * @brief EN_ALPHABET, RU_ALPHABET или случайный набор различных символов
+     * (иногда со строчными буквами, цифрами и пробелом).
+     */
+    std::wstring randomAlphabet(Rng& rng)
+    {
+        switch (pick(rng, 4)) {
+        case 0: return EN_ALPHABET;
+        case 1: return RU_ALPHABET;
+        default: break;
+        }
+        std::wstring pool = EN_ALPHABET + RU_ALPHABET + L"abcxyz0123456789.,!-";
+        if (pick(rng, 4) == 0) pool += L' ';
+        std::shuffle(pool.begin(), pool.end(), rng);
+        return pool.substr(0, 2 + pick(rng, 40));
+    }
+
+    /**
+     * @brief Текст в основном из алфавита, с пробелами, строчными буквами,
+     * буквами других алфавитов и прочими символами.
+     */
+    std::wstring randomText(Rng& rng, const std::wstring& alphabet, size_t length)
+    {
+        std::wstring text(length, L' ');
+        for (wchar_t& c : text) {
+            size_t kind = pick(rng, 10);
+            if (kind < 6) {
+                c = alphabet[pick(rng, alphabet.size())];
+            } else if (kind == 6) {
+                c = std::towlower(alphabet[pick(rng, alphabet.size())]);
+            } else if (kind == 7) {
+                c = L' ';
+            } else if (kind == 8) {
+                c = OTHER_CHARS[pick(rng, OTHER_CHARS.size())];
+            } else {
+                const std::wstring& other = pick(rng, 2) ? EN_ALPHABET : RU_ALPHABET;
+                c = other[pick(rng, other.size())];
+            }
+        }
+        return text;
+    }
+
+    /// Текст только из символов алфавита и пробелов (проходит проверку XORCipher).
+    std::wstring randomValidText(Rng& rng, const std::wstring& alphabet, size_t length)
+    {
+        std::wstring text(length, L' ');
+        for (wchar_t& c : text) {
+            if (pick(rng, 8) != 0) c = alphabet[pick(rng, alphabet.size())];
+        }
+        return text;
+    }
+
+    /**
+     * @brief Результат вызова; исключение превращается в строку с его типом,
+     * чтобы сравнивать и отказы.
+     */
+    std::wstring outcome(const std::function<std::wstring()>& f)
+    {
+        try {
+            return f();
+        } catch (const std::exception& e) {
+            std::string type = typeid(e).name();
+            return L"<exception " + std::wstring(type.begin(), type.end()) + L">";
+        }
+    }
+
+    /**
+     * @brief Лучшее время вызова f на символ входа, нс.
+     */
+    double bestNsPerChar(const std::function<std::wstring()>& f, size_t chars, size_t repeats)
+    {
+        using Clock = std::chrono::steady_clock;
+        double best = std::numeric_limits<double>::infinity();
+        volatile size_t sink = 0; // результат не должен выбрасываться оптимизатором
+        for (size_t r = 0; r < repeats; ++r) {
+            auto start = Clock::now();
+            sink = sink + outcome(f).size();
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            best = std::min(best, ns);
+        }
+        return best / static_cast<double>(std::max<size_t>(chars, 1));
+    }
+
+    std::wstring randomXorKey(Rng& rng, const std::wstring& alphabet)
+    {
+        std::wstring key = randomValidText(rng, alphabet, 1 + pick(rng, 12));
+        if (key.find_first_not_of(L' ') == std::wstring::npos) key[0] = alphabet[0];
+        return key;
+    }
+
+    Trial xorEncryptTrial(Rng& rng, size_t length, bool)
+    {
+        std::wstring alphabet = randomAlphabet(rng);
+        std::wstring key = randomXorKey(rng, alphabet);
+        auto cipher = std::make_shared<XORCipher>(key, alphabet);
+        std::wstring text = randomValidText(rng, alphabet, length);
+        return {text,
+                [=] { return reference::xorProcess(text, key); },
+                [=] { return cipher->encrypt(text); }};
+    }
+
+    Trial xorHexTrial(Rng& rng, size_t length, bool timing)
+    {
+        std::wstring alphabet = randomAlphabet(rng);
+        std::wstring key = randomXorKey(rng, alphabet);
+        auto cipher = std::make_shared<XORCipher>(key, alphabet);
+        // Каждый четвёртый текст содержит символы вне алфавита: оба пути должны отказать.
+        std::wstring text = timing || pick(rng, 4) ? randomValidText(rng, alphabet, length)
+                                                   : randomText(rng, alphabet, length);
+        return {text,
+                [=] { return reference::xorEncryptToHex(text, key, alphabet); },
+                [=] { return cipher->encryptToHex(text); }};
+    }
+
+    Trial xorUnhexTrial(Rng& rng, size_t length, bool timing)
+    {
+        std::wstring alphabet = randomAlphabet(rng);
+        std::wstring key = randomXorKey(rng, alphabet);
+        auto cipher = std::make_shared<XORCipher>(key, alphabet);
+        std::wstring hex = reference::xorEncryptToHex(randomValidText(rng, alphabet, length), key, alphabet);
+        for (wchar_t& c : hex) {
+            if (pick(rng, 8) == 0) c = std::towlower(c);         // строчные HEX-цифры
+            else if (pick(rng, 32) == 0) c = L'G';                // мусор, который отбрасывается
+        }
+        if (!timing && pick(rng, 8) == 0) hex += L'7';            // нечётное число цифр
+        return {hex,
+                [=] { return reference::xorDecryptFromHex(hex, key); },
+                [=] { return cipher->decryptFromHex(hex); }};
+    }
+
+    Trial affineTrial(Rng& rng, size_t length, bool, bool encrypt)
+    {
+        std::wstring alphabet = randomAlphabet(rng);
+        const int m = static_cast<int>(alphabet.size());
+        int a = 0;
+        do {
+            a = pickInt(rng, 1, 2 * m);
+        } while (std::gcd(a, m) != 1);
+        int b = pickInt(rng, 0, m - 1);
+        auto cipher = std::make_shared<AffineCipher>(a, b, alphabet);
+        std::wstring text = randomText(rng, alphabet, length);
+        return {text,
+                [=] { return reference::affine(text, a, b, alphabet, encrypt); },
+                [=] { return encrypt ? cipher->encrypt(text) : cipher->decrypt(text); }};
+    }
+
+    Trial gronsfeldTrial(Rng& rng, size_t length, bool, bool encrypt)
+    {
+        std::wstring alphabet = randomAlphabet(rng);
+        std::vector<int> key(1 + pick(rng, 8));
+        for (int& k : key) k = pickInt(rng, -40, 40);
+        auto cipher = std::make_shared<GronsfeldCipher>(key, alphabet);
+        std::wstring text = randomText(rng, alphabet, length);
+        return {text,
+                [=] { return reference::gronsfeld(text, key, alphabet, encrypt); },
+                [=] { return cipher->process(text, encrypt); }};
+    }
+
+    Trial vigenereTrial(Rng& rng, size_t length, bool, bool encrypt)
+    {
+        // Кириллица в ключе допустима, только если локаль считает её буквами.
+        std::wstring letters = EN_ALPHABET + L"abcdefghijklmnopqrstuvwxyz";
+        if (std::iswalpha(L'Я')) letters += RU_ALPHABET;
+        std::wstring key(1 + pick(rng, 10), L' ');
+        for (wchar_t& c : key) {
+            if (pick(rng, 10) != 0) c = letters[pick(rng, letters.size())];
+        }
+        auto cipher = std::make_shared<VigenereCipher>(key);
+        std::wstring text = randomText(rng, pick(rng, 2) ? EN_ALPHABET : RU_ALPHABET, length);
+        return {text,
+                [=] { return reference::vigenere(text, key, encrypt); },
+                [=] {
+                    std::pmr::wstring out = encrypt ? cipher->zasifrovat(text, std::pmr::new_delete_resource())
+                                                    : cipher->rasshifrovat(text, std::pmr::new_delete_resource());
+                    return std::wstring(out.begin(), out.end());
+                }};
+    }
+
+    const std::vector<CaseSpec>& cases()
+    {
+        using namespace std::placeholders;
+        static const std::vector<CaseSpec> list = {
+            {"xor/encrypt", xorEncryptTrial},
+            {"xor/hex", xorHexTrial},
+            {"xor/unhex", xorUnhexTrial},
+            {"affine/encrypt", std::bind(affineTrial, _1, _2, _3, true)},
+            {"affine/decrypt", std::bind(affineTrial, _1, _2, _3, false)},
+            {"gronsfeld/encrypt", std::bind(gronsfeldTrial, _1, _2, _3, true)},
+            {"gronsfeld/decrypt", std::bind(gronsfeldTrial, _1, _2, _3, false)},
+            {"vigenere/encrypt", std::bind(vigenereTrial, _1, _2, _3, true)},
+            {"vigenere/decrypt", std::bind(vigenereTrial, _1, _2, _3, false)},
+        };
+        return list;
+    }
+}
+
+/**
+ * @brief Сверяет реализации на options.trials случайных входах для каждого случая
+ * и замеряет скорость на одном длинном входе.
+ */
+std::vector<DifferentialReport> runDifferential(const DifferentialOptions& options)
+{
+    std::vector<DifferentialReport> reports;
+    for (const CaseSpec& spec : cases()) {
+        DifferentialReport report;
+        report.name = spec.name;
+        Rng rng(options.seed);
+
+        for (size_t t = 0; t < options.trials; ++t) {
+            Trial trial = spec.make(rng, pick(rng, options.maxLength + 1), false);
+            std::wstring expected = outcome(trial.reference);
+            std::wstring actual = outcome(trial.fast);
+            ++report.trials;
+            if (expected != actual && report.mismatches++ == 0) {
+                report.firstInput = trial.input;
+                report.referenceOut = expected;
+                report.fastOut = actual;
+            }
+        }
+
+        if (options.benchRepeats > 0) {
+            Trial bench = spec.make(rng, options.benchLength, true);
+            report.referenceNs = bestNsPerChar(bench.reference, bench.input.size(), options.benchRepeats);
+            report.fastNs = bestNsPerChar(bench.fast, bench.input.size(), options.benchRepeats);
+        }
+        reports.push_back(std::move(report));
+    }
+    return reports;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file differential.h
+ * @brief Дифференциальная проверка: рабочие реализации шифров против эталонных.
+ *
+ * Случайные тексты, ключи и алфавиты (со знаками препинания, пробелами, строчными
+ * буквами и символами вне алфавита) прогоняются через reference:: и через классы
+ * шифров; результаты, включая выброшенные исключения, должны совпадать символ
+ * в символ. Для каждого случая также замеряется ускорение рабочей реализации.
+ */
+
+#ifndef DIFFERENTIAL_H
+#define DIFFERENTIAL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Параметры прогона.
+ */
+struct DifferentialOptions {
+    std::uint32_t seed = 1;    ///< Зерно генератора: прогон воспроизводим
+    size_t trials = 200;       ///< Случайных входов на случай
+    size_t maxLength = 200;    ///< Максимальная длина случайного текста
+    size_t benchLength = 4096; ///< Длина текста для замера скорости
+    size_t benchRepeats = 20;  ///< Повторов замера (0 — не замерять)
+};
+
+/**
+ * @brief Итог одного случая (шифр и направление).
+ */
+struct DifferentialReport {
+    std::string name;          ///< Например, "affine/decrypt"
+    size_t trials = 0;         ///< Проверено входов
+    size_t mismatches = 0;     ///< Входов с расхождением
+    std::wstring firstInput;   ///< Первый вход с расхождением
+    std::wstring referenceOut; ///< Результат эталона на нём
+    std::wstring fastOut;      ///< Результат рабочей реализации на нём
+    double referenceNs = 0;    ///< Лучшее время эталона на символ, нс
+    double fastNs = 0;         ///< Лучшее время рабочей реализации на символ, нс
+
+    /**
+     * @brief Во сколько раз рабочая реализация быстрее эталона (0, если не замерялось).
+     */
+    double speedup() const { return fastNs > 0 ? referenceNs / fastNs : 0.0; }
+};
+
+/**
+ * @brief Прогоняет все случаи: xor/encrypt, xor/hex, xor/unhex, affine, gronsfeld и vigenere
+ * в обоих направлениях.
+ */
+std::vector<DifferentialReport> runDifferential(const DifferentialOptions& options = {});
+
+#endif // DIFFERENTIAL_H
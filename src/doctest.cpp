@@ -13,9 +13,56 @@
 #include "rail_fence_cipher.h"
 #include "turn_grid_cipher.h"
 
+#include "affine_key_search.h"
+#include "vigenere_analysis.h"
+#include "letter_histogram.h"
+#include "ngram_model.h"
+#include "pi_key_solver.h"
+#include "gronsfeld_key_solver.h"
+#include "thread_pool.h"
+#include "rail_fence_solver.h"
+#include "alphabet_traits.h"
+#include "cipher_chain.h"
+#include "transposition_chain.h"
+#include "cipher_service.h"
+#include "prepared_cache.h"
+#include "cipher_batch.h"
+#include "cipher_protocol.h"
+#include "metrics.h"
+#include "alloc_tracker.h"
+#include "reference_kernels.h"
+#include "differential.h"
+#include "simd_dispatch.h"
+#include "file_pipeline.h"
+#include "utf8.h"
+#ifdef CIPHER_SOCKET_TESTS
+#include "cipher_server.h"
+#include "cipher_client.h"
+#include "unix_socket.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+#ifdef CIPHER_BLOCK_IO
+#include <fstream>
+#include <unistd.h>
+#endif
+
 #include <unordered_map>
 #include <string>
 #include <vector>
+#include <memory_resource>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <numeric>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <set>
+#include <mutex>
+#include <chrono>
 
 // ---------- HELPER FUNCTION ----------
 bool wstrings_equal(const std::wstring& a, const std::wstring& b) {
@@ -41,6 +88,8 @@ TEST_CASE("encrypt - typical usage") { // обычное шифрование
     CHECK(enc.size() == 8); // 4 символа * 2 цифры
     std::wstring dec = PiCipher::decrypt(enc, dec_map);
     CHECK(wstrings_equal(dec, L"ABCA"));
+    CHECK_ALLOCATIONS(PiCipher::encrypt(text, enc_map), 1);   // только результат
+    CHECK_ALLOCATIONS(PiCipher::decrypt(enc, dec_map), 1);    // без строки на каждую пару цифр
 }
 
 TEST_CASE("encrypt - text with non-alphabet chars") { // символы вне алфавита игнорируются
@@ -86,6 +135,7 @@ TEST_CASE("decrypt - unknown codes replaced by question") { // неизвест
     CHECK(dec[0] == L'A');
     CHECK(dec[1] == L'?');
     CHECK(dec[2] == L'B');
+    CHECK_ALLOCATIONS(PiCipher::decrypt(encrypted, dec_map), 1); // неизвестные коды тоже без substr
 }
 
 TEST_CASE("decrypt - empty input") { // пустой вход
@@ -145,6 +195,7 @@ TEST_CASE("decrypt - shrinking roundtrip") { // encrypt/decrypt с shrinking
     std::wstring enc = ReverserCipher::encrypt(text, 5, true);
     std::wstring dec = ReverserCipher::decrypt(enc, 5, true);
     CHECK(dec == text);
+    CHECK_ALLOCATIONS(ReverserCipher::decrypt(enc, 5, true), 1); // блоки разворачиваются на месте
 }
 
 // // --- 1 тест с ошибкой для encrypt ---
@@ -197,6 +248,11 @@ TEST_CASE("decrypt - preserves spaces and ignores bad pairs") { // пробел
     std::wstring enc = L"a1x9b1";
     std::wstring dec = PolybiusCipher::decrypt(enc, board);
     CHECK(dec == L"AB");
+
+    std::wstring plain = L"HAD A BAD HEAD";
+    std::wstring longer = PolybiusCipher::encrypt(plain, board);
+    CHECK_ALLOCATIONS(PolybiusCipher::encrypt(plain, board), 1);
+    CHECK_ALLOCATIONS(PolybiusCipher::decrypt(longer, board), 1); // резерв учитывает пробелы
 }
 
 // // --- 1 тест с ошибкой для encrypt ---
@@ -230,6 +286,8 @@ TEST_CASE("encrypt - multi-digit key") {
     // Индексы:  S(18)+4=22->W, E(4)+3=7->H, C(2)+2=4->E, R(17)+1=18->S, E(4)+4=8->I, T(19)+3=22->W
     std::wstring expected = L"WHESIW";
     CHECK(cipher.process(text, true) == expected);
+    CHECK_ALLOCATIONS(cipher.process(text, true), 2); // результат и развёрнутый ключ
+    CHECK_ALLOCATED_BYTES(cipher.process(text, true), text.size() * (sizeof(wchar_t) + sizeof(int)) + 64);
 }
 
 TEST_CASE("encrypt - with spaces and repeated letters") { // шифрование строки с пробелами и повторяющимися символами
@@ -303,6 +361,7 @@ TEST_CASE("encrypt - typical usage") { // обычное шифрование
     // O: (5*14+8)%26=78%26=0 -> A
     std::wstring expected = L"RCLLA";
     CHECK(cipher.encrypt(text) == expected);
+    CHECK_ALLOCATIONS(cipher.encrypt(text), 1);
 }
 
 TEST_CASE("encrypt - with spaces and unknown chars") { // шифрование с пробелами и неизвестными символами
@@ -340,6 +399,8 @@ TEST_CASE("decrypt - with spaces and unknown chars") { // расшифровка
     std::wstring cipher_text = L"C J?V";
     std::wstring expected = L"A B?Z";
     CHECK(cipher.decrypt(cipher_text) == expected);
+    std::wstring repeated = cipher_text + L", " + cipher_text;
+    CHECK_ALLOCATIONS(cipher.decrypt(repeated), 1); // символы вне алфавита копируются без перевыделений
 }
 
 // --- ERROR TESTS ---
@@ -397,6 +458,8 @@ TEST_CASE("decrypt - with spaces and symbols") { // расшифровка с п
     std::wstring enc = cipher.zasifrovat(L"HI, HOW ARE YOU?");
     std::wstring dec = cipher.rasshifrovat(enc);
     CHECK(dec == L"HI, HOW ARE YOU?");
+    CHECK_ALLOCATIONS(cipher.zasifrovat(enc, std::pmr::new_delete_resource()), 1);
+    CHECK_ALLOCATIONS(cipher.rasshifrovat(enc, std::pmr::new_delete_resource()), 1);
 }
 
 // // === Тест с ошибкой: ключ содержит только пробелы ===
@@ -422,6 +485,7 @@ TEST_CASE("encrypt - typical usage") {
     std::wstring text = L"WEAREDISCOVEREDFLEEATONCE";
     std::wstring expected = L"WECRLTEERDSOEEFEAOCAIVDEN";
     CHECK(cipher.encrypt(text) == expected);
+    CHECK_ALLOCATIONS(cipher.encrypt(text), 1); // без строк для каждого рельса
 }
 
 // Шифрование с 2 рельсами
@@ -438,6 +502,8 @@ TEST_CASE("decrypt - typical usage") {
     std::wstring encrypted = L"WECRLTEERDSOEEFEAOCAIVDEN";
     std::wstring expected = L"WEAREDISCOVEREDFLEEATONCE";
     CHECK(cipher.decrypt(encrypted) == expected);
+    CHECK_ALLOCATIONS(cipher.decrypt(encrypted), 1);
+    CHECK_ALLOCATED_BYTES(cipher.decrypt(encrypted), (encrypted.size() + 1) * sizeof(wchar_t));
 }
 
 // Дешифрование с одним рельсом (текст не меняется)
@@ -476,6 +542,9 @@ TEST_CASE("encrypt - typical usage") { // обычное шифрование
     std::wstring encrypted = cipher.process(text, true);
     // Просто проверяем, что шифруется и длина не меньше входной строки
     CHECK(encrypted.size() >= text.size());
+    // Решётка и сетка: строка-образец, внешний вектор и 4 строки каждая; плюс результат
+    std::wstring full = L"HELLOWORLDABCDEF";
+    CHECK_ALLOCATIONS(cipher.process(full, true, std::pmr::new_delete_resource()), 2 * (4 + 2) + 1);
 }
 
 TEST_CASE("encrypt - short text") { // короткий текст (меньше отверстий)
@@ -502,4 +571,1446 @@ TEST_CASE("decrypt - empty input") { // пустой вход
 //     CHECK_THROWS_AS(TurnGridCipher(-2), std::invalid_argument);
 // }
 
-} // END SUITE TurnGridCipher
\ No newline at end of file
+} // END SUITE TurnGridCipher
+
+// ============================
+// TESTS FOR std::pmr overloads
+// ============================
+TEST_SUITE("PmrOverloads") {
+
+// Арена без запасного ресурса: выход за её пределы приводит к std::bad_alloc,
+// а счётчик показывает, сколько выделений обслужила арена.
+struct CountingArena : std::pmr::memory_resource {
+    alignas(std::max_align_t) unsigned char buffer[64 * 1024];
+    std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer), std::pmr::null_memory_resource()};
+    size_t allocations = 0;
+
+    void* do_allocate(size_t bytes, size_t align) override {
+        ++allocations;
+        return arena.allocate(bytes, align);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t align) override {
+        arena.deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST_CASE("substitution ciphers - same result as std::wstring overloads") {
+    const std::wstring alphabet = L"ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    const std::wstring text = L"ATTACK AT DAWN, RETREAT AT DUSK";
+    CountingArena arena;
+
+    AffineCipher affine(5, 8, alphabet);
+    CHECK(affine.encrypt(text, &arena) == affine.encrypt(text).c_str());
+    CHECK(affine.decrypt(text, &arena) == affine.decrypt(text).c_str());
+
+    GronsfeldCipher gronsfeld({4, 3, 2, 1}, alphabet);
+    CHECK(gronsfeld.process(text, true, &arena) == gronsfeld.process(text, true).c_str());
+
+    VigenereCipher vigenere(L"KEY");
+    CHECK(vigenere.zasifrovat(text, &arena) == vigenere.zasifrovat(text).c_str());
+
+    XORCipher xorCipher(L"KEY", alphabet + L",");
+    std::wstring hex = xorCipher.encryptToHex(text);
+    CHECK(xorCipher.encryptToHex(text, &arena) == hex.c_str());
+    CHECK(xorCipher.decryptFromHex(hex, &arena) == xorCipher.decryptFromHex(hex).c_str());
+
+    CHECK(arena.allocations > 0);
+}
+
+TEST_CASE("transposition ciphers - scratch buffers come from the arena") {
+    const std::wstring text = L"WEAREDISCOVEREDFLEEATONCE";
+    CountingArena arena;
+
+    RailFenceCipher rails(3);
+    std::pmr::wstring enc = rails.encrypt(text, &arena);
+    CHECK(enc == L"WECRLTEERDSOEEFEAOCAIVDEN");
+    size_t before = arena.allocations;
+    CHECK(rails.decrypt(std::wstring(enc.begin(), enc.end()), &arena) == text.c_str());
+    CHECK(arena.allocations == before + 1); // только результат: позиции рельс вычисляются
+
+    CHECK(ReverserCipher::decrypt(ReverserCipher::encrypt(text, 5, true), 5, true, &arena) == text.c_str());
+
+    TurnGridCipher grid(4);
+    before = arena.allocations;
+    CHECK(grid.process(L"ABCD", true, &arena).size() == 4);
+    CHECK(arena.allocations > before + 1); // результат и временные решётка и сетка
+}
+
+TEST_CASE("table ciphers - same result as std::wstring overloads") {
+    CountingArena arena;
+
+    auto board = PolybiusCipher::build_board(L"ABCDEFGH", 0);
+    CHECK(PolybiusCipher::encrypt(L"ABH", board, &arena) == L"a1b1h1");
+    CHECK(PolybiusCipher::decrypt(L"a1x9b1", board, &arena) == L"AB");
+
+    std::unordered_map<wchar_t, std::wstring> enc_map;
+    std::unordered_map<std::wstring, wchar_t> dec_map;
+    PiCipher::build_codebooks(1, L"ABC", enc_map, dec_map);
+    std::wstring enc = PiCipher::encrypt(L"ABCA", enc_map);
+    CHECK(PiCipher::encrypt(L"ABCA", enc_map, &arena) == enc.c_str());
+    CHECK(PiCipher::decrypt(enc + L"99", dec_map, &arena) == L"ABCA?");
+}
+
+} // END SUITE PmrOverloads
+
+// ============================
+// TESTS FOR AffineKeySearch
+// ============================
+TEST_SUITE("AffineKeySearch") {
+
+const std::wstring EN = L"ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+const std::wstring PLAIN =
+    L"IT WAS THE BEST OF TIMES IT WAS THE WORST OF TIMES IT WAS THE AGE OF WISDOM "
+    L"IT WAS THE AGE OF FOOLISHNESS IT WAS THE EPOCH OF BELIEF IT WAS THE EPOCH OF "
+    L"INCREDULITY IT WAS THE SEASON OF LIGHT IT WAS THE SEASON OF DARKNESS IT WAS "
+    L"THE SPRING OF HOPE IT WAS THE WINTER OF DESPAIR";
+
+TEST_CASE("countLetters - follows AffineCipher letter rules") { // пробелы пропускаются, регистр не важен
+    auto counts = AffineKeySearch::countLetters(L"Ab a?Z", EN);
+    CHECK(counts.size() == 26);
+    CHECK(counts[0] == 2);
+    CHECK(counts[1] == 1);
+    CHECK(counts[25] == 1);
+}
+
+TEST_CASE("recoverKeys - chi-squared finds the key") {
+    AffineCipher cipher(5, 8, EN);
+    auto candidates = AffineKeySearch::recoverKeys(cipher.encrypt(PLAIN), EN);
+    REQUIRE(candidates.size() == 5);
+    CHECK(candidates[0].a == 5);
+    CHECK(candidates[0].b == 8);
+    CHECK(candidates[0].score <= candidates[1].score);
+}
+
+TEST_CASE("recoverKeys - log-likelihood finds the key") {
+    AffineCipher cipher(7, 3, EN);
+    auto candidates = AffineKeySearch::recoverKeys(cipher.encrypt(PLAIN), EN, FrequencyScore::LogLikelihood, 312);
+    CHECK(candidates.size() == 312); // phi(26) * 26 ключей
+    CHECK(candidates[0].a == 7);
+    CHECK(candidates[0].b == 3);
+}
+
+TEST_CASE("recoverKeys - throws for alphabet without reference frequencies") { // ошибка: нет эталона
+    CHECK_THROWS_AS(AffineKeySearch::recoverKeys(L"ABC", L"ABC"), std::invalid_argument);
+}
+
+} // END SUITE AffineKeySearch
+
+// ============================
+// TESTS FOR VigenereAnalysis
+// ============================
+TEST_SUITE("VigenereAnalysis") {
+
+const std::wstring PLAIN =
+    L"IT WAS THE BEST OF TIMES, IT WAS THE WORST OF TIMES, IT WAS THE AGE OF WISDOM, "
+    L"IT WAS THE AGE OF FOOLISHNESS, IT WAS THE EPOCH OF BELIEF, IT WAS THE EPOCH OF "
+    L"INCREDULITY, IT WAS THE SEASON OF LIGHT, IT WAS THE SEASON OF DARKNESS, IT WAS "
+    L"THE SPRING OF HOPE, IT WAS THE WINTER OF DESPAIR, WE HAD EVERYTHING BEFORE US, "
+    L"WE HAD NOTHING BEFORE US, WE WERE ALL GOING DIRECT TO HEAVEN, WE WERE ALL GOING "
+    L"DIRECT THE OTHER WAY";
+
+std::wstring encryptQuietly(const std::wstring& key, const std::wstring& text) {
+    std::pmr::wstring enc = VigenereCipher(key).zasifrovat(text, std::pmr::new_delete_resource());
+    return std::wstring(enc.begin(), enc.end());
+}
+
+TEST_CASE("keyPosition - space in key stops key advancement") { // пробел в ключе останавливает ключ
+    CHECK(VigenereAnalysis::keyPosition(L"KEY", 4) == 1);
+    CHECK(VigenereAnalysis::keyPosition(L"AB CD", 1) == 1);
+    CHECK(VigenereAnalysis::keyPosition(L"AB CD", 2) == 2);
+    CHECK(VigenereAnalysis::keyPosition(L"AB CD", 100) == 2);
+}
+
+TEST_CASE("periodicIndexOfCoincidence - spaces take key positions, punctuation does not") {
+    // Буквы в позициях ключа 0 и 2 совпадают: для периода 2 они в одном столбце.
+    auto ic = VigenereAnalysis::periodicIndexOfCoincidence(L"A, A", 2);
+    CHECK(ic[2] == doctest::Approx(1.0));
+}
+
+TEST_CASE("analyze - finds key length") {
+    auto report = VigenereAnalysis::analyze(encryptQuietly(L"LEMON", PLAIN), 12);
+    CHECK(report.bestPeriod == 5);
+    CHECK(report.indexOfCoincidence[5] > report.indexOfCoincidence[3]);
+    CHECK(report.kasiskiVotes[5] > report.kasiskiVotes[3]);
+}
+
+TEST_CASE("analyze - throws on zero period") { // ошибка: нулевой период
+    CHECK_THROWS_AS(VigenereAnalysis::analyze(L"ABC", 0), std::invalid_argument);
+}
+
+} // END SUITE VigenereAnalysis
+
+// ============================
+// TESTS FOR LetterHistogram
+// ============================
+TEST_SUITE("LetterHistogram") {
+
+TEST_CASE("count - bins follow EN_ALPHABET and RU_ALPHABET") { // регистр не важен, Ё и é не считаются
+    const std::wstring text = L"Ab, zZ яЯ Ёё é а";
+    for (simd::Level level : {simd::Level::Scalar, simd::Level::Sse41, simd::Level::Avx2}) {
+        simd::setMaxLevel(level);
+        std::wstring repeated;
+        for (int i = 0; i < 9; ++i) repeated += text; // блоки векторов и скалярные хвосты
+        auto bins = LetterHistogram::count(repeated);
+        CHECK(bins.size() == LetterHistogram::BIN_COUNT);
+        CHECK(bins[0] == 9);
+        CHECK(bins[25] == 18);
+        const int ru = LetterHistogram::firstBin(BuiltinAlphabet::Russian);
+        CHECK(bins[ru + RU_ALPHABET.find(L'Я')] == 18);
+        CHECK(bins[ru] == 9);
+        CHECK(std::accumulate(bins.begin(), bins.end(), uint64_t(0)) == 9 * 7);
+        CHECK(LetterHistogram::countUtf8(toUtf8(repeated)) == bins);
+    }
+    simd::setMaxLevel(simd::Level::Avx2);
+    CHECK(LetterHistogram::countUtf8("A\xD0\x90\xFF\xD0") == LetterHistogram::count(L"AА??"));
+    CHECK_THROWS_AS(LetterHistogram::firstBin(BuiltinAlphabet::None), std::invalid_argument);
+}
+
+TEST_CASE("periodic - columns follow key positions of Gronsfeld and Vigenere") { // пробелы и знаки препинания
+    std::wstring text;
+    for (int i = 0; i < 3000; ++i) text += L"Ab, c d!E\u00e9 ";
+    const size_t period = 3;
+    for (auto step : {LetterHistogram::KeyStep::EveryChar, LetterHistogram::KeyStep::LettersAndSpaces}) {
+        std::vector<uint64_t> expected(period * LetterHistogram::BIN_COUNT, 0);
+        size_t position = 0;
+        for (wchar_t c : text) {
+            int bin = VigenereAnalysis::letterBin(c);
+            if (bin >= 0) ++expected[position % period * LetterHistogram::BIN_COUNT + bin];
+            if (step == LetterHistogram::KeyStep::EveryChar || VigenereAnalysis::consumesKey(c)) ++position;
+        }
+        CHECK(LetterHistogram::periodic(text, period, step) == expected);
+        CHECK(LetterHistogram::periodicUtf8(toUtf8(text), period, step) == expected);
+    }
+    std::vector<uint64_t> upper(period * LetterHistogram::BIN_COUNT, 0); // строчные только занимают позицию
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == L'A' || text[i] == L'E') ++upper[i % period * LetterHistogram::BIN_COUNT + (text[i] - L'A')];
+    }
+    const auto upperOnly = LetterHistogram::LetterCase::UpperOnly;
+    CHECK(LetterHistogram::periodic(text, period, LetterHistogram::KeyStep::EveryChar, upperOnly) == upper);
+    CHECK(LetterHistogram::periodicUtf8(toUtf8(text), period, LetterHistogram::KeyStep::EveryChar, upperOnly) == upper);
+    CHECK_THROWS_AS(LetterHistogram::periodic(text, 0, LetterHistogram::KeyStep::EveryChar), std::invalid_argument);
+}
+
+TEST_CASE("periodic - vector kernels keep the case of Cyrillic letters") { // у Р–Я бит 0x20 установлен, у р–я — нет
+    std::wstring text;
+    for (int i = 0; i < 500; ++i) {
+        text += wchar_t(L'А' + i % 32);
+        text += wchar_t(L'а' + i * 7 % 32);
+        if (i % 5 == 0) text += L" Zz";
+    }
+    const size_t period = 4;
+    const auto step = LetterHistogram::KeyStep::EveryChar;
+    for (auto letterCase : {LetterHistogram::LetterCase::Fold, LetterHistogram::LetterCase::UpperOnly}) {
+        simd::setMaxLevel(simd::Level::Scalar);
+        const auto expected = LetterHistogram::periodic(text, period, step, letterCase);
+        for (simd::Level level : {simd::Level::Sse41, simd::Level::Avx2}) {
+            if (level > simd::supportedLevel()) break;
+            simd::setMaxLevel(level);
+            INFO(simd::levelName(level));
+            CHECK(LetterHistogram::periodic(text, period, step, letterCase) == expected);
+        }
+    }
+    simd::setMaxLevel(simd::Level::Avx2);
+
+    const std::wstring upper(128, L'Я');
+    const auto upperOnly = LetterHistogram::LetterCase::UpperOnly;
+    const int ru = LetterHistogram::firstBin(BuiltinAlphabet::Russian);
+    CHECK(LetterHistogram::periodic(upper, 1, step, upperOnly)[ru + RU_ALPHABET.find(L'Я')] == 128);
+    const auto counts = LetterHistogram::periodic(text, 1, step, upperOnly); // 500 прописных А–Я
+    CHECK(std::accumulate(counts.begin() + ru, counts.begin() + ru + 32, uint64_t(0)) == 500);
+}
+
+} // END SUITE LetterHistogram
+
+// ============================
+// TESTS FOR NgramModel
+// ============================
+TEST_SUITE("NgramModel") {
+
+const std::wstring CORPUS =
+    L"It was the best of times, it was the worst of times, it was the age of wisdom, "
+    L"it was the age of foolishness, it was the epoch of belief, it was the epoch of "
+    L"incredulity, it was the season of Light, it was the season of Darkness, it was "
+    L"the spring of hope, it was the winter of despair.";
+
+TEST_CASE("train - plaintext outscores ciphertext, file round trip keeps scores") { // отображение файла в память
+    NgramModel model = NgramModel::train(CORPUS, BuiltinAlphabet::English, 4);
+    const std::wstring plain = L"IT WAS THE SEASON OF HOPE";
+    const std::wstring shifted = GronsfeldCipher({3}, EN_ALPHABET).process(plain, true);
+    CHECK(model.order() == 4);
+    CHECK(model.score(plain) > model.score(shifted));
+    CHECK(model.score(L"it was") == doctest::Approx(model.score(L"ITWAS")));
+
+    const std::string path =
+        (std::filesystem::temp_directory_path() / ("cipher_ngram_" + std::to_string(std::random_device{}()) + ".bin"))
+            .string();
+    model.save(path);
+    NgramModel loaded = NgramModel::load(path);
+    CHECK(loaded.alphabet() == BuiltinAlphabet::English);
+    CHECK(loaded.floor() == model.floor());
+    CHECK(std::equal(model.table(), model.table() + (size_t(1) << 20), loaded.table()));
+    CHECK(loaded.score(CORPUS) == model.score(CORPUS));
+
+    std::ofstream(path, std::ios::binary) << "NGRM";
+    CHECK_THROWS_AS(NgramModel::load(path), std::runtime_error);
+    std::remove(path.c_str());
+    CHECK_THROWS_AS(NgramModel::train(CORPUS, BuiltinAlphabet::English, 5), std::invalid_argument);
+    CHECK_THROWS_AS(NgramModel::fromLetterFrequency(BuiltinAlphabet::None, 2), std::invalid_argument);
+}
+
+TEST_CASE("NgramScore - single letter changes match full rescoring") { // начало, середина и конец текста
+    for (BuiltinAlphabet alphabet : {BuiltinAlphabet::English, BuiltinAlphabet::Russian}) {
+        for (int order = NgramModel::MIN_ORDER; order <= NgramModel::MAX_ORDER; ++order) {
+            NgramModel model = alphabet == BuiltinAlphabet::English
+                                   ? NgramModel::train(CORPUS, alphabet, order)
+                                   : NgramModel::fromLetterFrequency(alphabet, order);
+            std::vector<uint8_t> letters = model.letters(alphabet == BuiltinAlphabet::English
+                                                             ? L"the season of light"
+                                                             : L"Время надежды и света");
+            NgramScore score(model, letters);
+            std::mt19937 rng(order);
+            for (int step = 0; step < 50; ++step) {
+                size_t pos = step < 2 ? step * (letters.size() - 1) : rng() % letters.size();
+                uint8_t letter = static_cast<uint8_t>(rng() % (alphabet == BuiltinAlphabet::English ? 26 : 32));
+                double delta = score.delta(pos, letter);
+                letters[pos] = letter;
+                CHECK(delta == doctest::Approx(model.score(letters.data(), letters.size()) - score.total()));
+                score.set(pos, letter);
+                CHECK(score.total() == doctest::Approx(model.score(letters.data(), letters.size())));
+            }
+        }
+    }
+}
+
+} // END SUITE NgramModel
+
+// ============================
+// TESTS FOR PiKeySolver
+// ============================
+TEST_SUITE("PiKeySolver") {
+
+TEST_CASE("decodeTables - every key matches build_codebooks") { // таблицы соседних ключей строятся друг из друга
+    for (const std::wstring& alphabet : {EN_ALPHABET, RU_ALPHABET, EN_ALPHABET + RU_ALPHABET + L"0123456789 .,"}) {
+        auto tables = PiKeySolver::decodeTables(alphabet.size());
+        REQUIRE(tables.size() == static_cast<size_t>(PiKeySolver::maxKey()));
+        for (int key = 1; key <= PiKeySolver::maxKey(); ++key) {
+            std::unordered_map<wchar_t, std::wstring> enc_map;
+            std::unordered_map<std::wstring, wchar_t> dec_map;
+            PiCipher::build_codebooks(key, alphabet, enc_map, dec_map);
+            size_t assigned = 0;
+            for (int code = 0; code < 100; ++code) {
+                int letter = tables[key - 1][code];
+                wchar_t digits[] = {static_cast<wchar_t>(L'0' + code / 10), static_cast<wchar_t>(L'0' + code % 10), 0};
+                auto it = dec_map.find(digits);
+                if (letter >= 0) {
+                    ++assigned;
+                    CHECK((it != dec_map.end() && it->second == alphabet[letter]));
+                }
+            }
+            CHECK(assigned == dec_map.size());
+        }
+    }
+}
+
+TEST_CASE("solve - recovers the key of an English message") { // выборка, ранжирование, полная расшифровка
+    const std::wstring plain =
+        L"ITWASTHEBESTOFTIMESITWASTHEWORSTOFTIMESITWASTHEAGEOFWISDOMITWASTHEAGEOFFOOLISHNESS"
+        L"ITWASTHEEPOCHOFBELIEFITWASTHEEPOCHOFINCREDULITYITWASTHESEASONOFLIGHT";
+    std::unordered_map<wchar_t, std::wstring> enc_map;
+    std::unordered_map<std::wstring, wchar_t> dec_map;
+    PiCipher::build_codebooks(137, EN_ALPHABET, enc_map, dec_map);
+    const std::wstring cipher = PiCipher::encrypt(plain, enc_map);
+
+    NgramModel model = NgramModel::fromLetterFrequency(BuiltinAlphabet::English, 2);
+    auto candidates = PiKeySolver::solve(cipher, EN_ALPHABET, model, 3, 64);
+    REQUIRE(candidates.size() == 3);
+    CHECK(candidates[0].key == 137);
+    CHECK(candidates[0].plaintext == plain);
+    CHECK(candidates[0].score > candidates[1].score);
+    CHECK_THROWS_AS(PiKeySolver::solve(cipher, L"", model), std::invalid_argument);
+}
+
+} // END SUITE PiKeySolver
+
+// ============================
+// TESTS FOR GronsfeldKeySolver
+// ============================
+TEST_SUITE("GronsfeldKeySolver") {
+
+TEST_CASE("solve - recovers a digit key, lowercase is left out") { // строчные GronsfeldCipher не сдвигает
+    const std::wstring plain =
+        L"IT WAS THE BEST OF TIMES, IT WAS THE WORST OF TIMES, IT WAS THE AGE OF WISDOM, "
+        L"IT WAS THE AGE OF FOOLISHNESS, IT WAS THE EPOCH OF BELIEF, IT WAS THE EPOCH OF "
+        L"INCREDULITY, IT WAS THE SEASON OF LIGHT, IT WAS THE SEASON OF DARKNESS, IT WAS "
+        L"THE SPRING OF HOPE, it was the winter of despair, WE HAD EVERYTHING BEFORE US, "
+        L"WE HAD NOTHING BEFORE US, WE WERE ALL GOING DIRECT TO HEAVEN, WE WERE ALL GOING "
+        L"DIRECT THE OTHER WAY";
+    GronsfeldCipher cipher({3, 1, 4}, EN_ALPHABET);
+    const std::wstring encrypted = cipher.process(plain, true);
+
+    auto candidates = GronsfeldKeySolver::solve(encrypted, EN_ALPHABET, 3);
+    REQUIRE(candidates.size() == 5);
+    CHECK(candidates[0].key == std::vector<int>{3, 1, 4});
+    for (size_t i = 1; i < candidates.size(); ++i) {
+        CHECK(candidates[i - 1].score <= candidates[i].score);
+        CHECK(candidates[i].key != candidates[0].key);
+    }
+    size_t changed = 0; // второй ключ отличается от лучшего одним столбцом
+    for (size_t c = 0; c < 3; ++c) changed += candidates[1].key[c] != candidates[0].key[c];
+    CHECK(changed == 1);
+
+    auto utf8 = GronsfeldKeySolver::solveUtf8(toUtf8(encrypted), EN_ALPHABET, 3, FrequencyScore::LogLikelihood, 1, 26);
+    REQUIRE(utf8.size() == 1);
+    CHECK(utf8[0].key == std::vector<int>{3, 1, 4});
+    CHECK_THROWS_AS(GronsfeldKeySolver::solve(encrypted, L"ABC", 3), std::invalid_argument);
+    CHECK_THROWS_AS(GronsfeldKeySolver::solve(encrypted, EN_ALPHABET, 0), std::invalid_argument);
+}
+
+TEST_CASE("rankKeys - keys come in order of total score") { // сравнение с полным перебором
+    const size_t period = 3;
+    const size_t n = 4;
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> value(0.0, 100.0);
+    std::vector<double> scores(period * n);
+    for (double& s : scores) s = value(random);
+
+    std::vector<double> sums;
+    for (size_t a = 0; a < n; ++a)
+        for (size_t b = 0; b < n; ++b)
+            for (size_t c = 0; c < n; ++c) sums.push_back(scores[a] + scores[n + b] + scores[2 * n + c]);
+    std::sort(sums.begin(), sums.end());
+
+    auto keys = GronsfeldKeySolver::rankKeys(scores, period, FrequencyScore::ChiSquared, 100);
+    REQUIRE(keys.size() == sums.size());
+    std::set<std::vector<int>> distinct;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        CHECK(keys[i].score == doctest::Approx(sums[i]));
+        distinct.insert(keys[i].key);
+    }
+    CHECK(distinct.size() == keys.size());
+
+    auto best = GronsfeldKeySolver::rankKeys(scores, period, FrequencyScore::LogLikelihood, 1);
+    CHECK(best[0].score == doctest::Approx(sums.back()));
+}
+
+} // END SUITE GronsfeldKeySolver
+
+// ============================
+// TESTS FOR ThreadPool
+// ============================
+TEST_SUITE("ThreadPool") {
+
+TEST_CASE("parallelFor - every index once, nested loops stay on pool threads") { // вложенные циклы не создают потоков
+    ThreadPool pool(ThreadPoolOptions{2, {0}});
+    REQUIRE(pool.concurrency() == 3);
+    std::vector<std::atomic<int>> visits(10000);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    pool.parallelFor(0, 100, 1, [&](size_t first, size_t last) {
+        for (size_t outer = first; outer < last; ++outer) {
+            pool.parallelFor(outer * 100, outer * 100 + 100, 7, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) ++visits[i];
+                std::lock_guard<std::mutex> lock(mutex);
+                threads.insert(std::this_thread::get_id());
+            });
+        }
+    });
+    CHECK(std::all_of(visits.begin(), visits.end(), [](const std::atomic<int>& v) { return v == 1; }));
+    CHECK(threads.size() <= pool.concurrency());
+
+    std::vector<double> values(5000);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = 1.0 / static_cast<double>(i + 1);
+    auto sum = [&](ThreadPool& p) {
+        return p.parallelReduce(0, values.size(), 64, 0.0,
+                                [&](size_t b, size_t e) { return std::accumulate(&values[b], &values[e], 0.0); },
+                                [](double a, double b) { return a + b; });
+    };
+    ThreadPool single(ThreadPoolOptions{0, {}});
+    CHECK(sum(pool) == sum(single)); // части и порядок свёртки не зависят от числа потоков
+    CHECK(pool.parallelReduce(5, 5, 1, 42, [](size_t, size_t) { return 0; }, std::plus<int>()) == 42);
+}
+
+TEST_CASE("parallelFor - exception reaches the caller, shared pool is configured once") { // ошибки
+    ThreadPool pool(ThreadPoolOptions{2, {}});
+    std::atomic<size_t> done{0};
+    CHECK_THROWS_AS(pool.parallelFor(0, 1000, 1, [&](size_t first, size_t) {
+        if (first == 500) throw std::runtime_error("stop");
+        ++done;
+    }), std::runtime_error);
+    CHECK(done < 1000);
+    pool.parallelFor(0, 10, 1, [&](size_t, size_t) { ++done; }); // пул работает и после ошибки
+
+    CHECK_THROWS_AS(ThreadPool(ThreadPoolOptions{1, {-1}}), std::invalid_argument);
+    ThreadPool::shared();
+    CHECK_THROWS_AS(ThreadPool::configureShared(ThreadPoolOptions{}), std::logic_error);
+}
+
+} // END SUITE ThreadPool
+
+// ============================
+// TESTS FOR RailFenceSolver
+// ============================
+TEST_SUITE("RailFenceSolver") {
+
+TEST_CASE("cipherIndex - matches RailFenceCipher permutation") { // позиции совпадают с настоящим шифром
+    for (size_t length : {1u, 2u, 7u, 25u, 64u}) {
+        std::wstring text;
+        for (size_t i = 0; i < length; ++i) text += static_cast<wchar_t>(0x100 + i);
+        for (int rails = 2; rails <= 9; ++rails) {
+            std::wstring enc = RailFenceCipher(rails).encrypt(text);
+            for (size_t i = 0; i < length; ++i) {
+                REQUIRE(enc[RailFenceSolver::cipherIndex(i, length, rails)] == text[i]);
+            }
+        }
+    }
+}
+
+TEST_CASE("solve - recovers rail count") {
+    const std::wstring plain =
+        L"THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG WHILE THE HUNTER RESTS IN THE SHADE "
+        L"AND THINKS ABOUT THE OTHER THINGS THAT HAPPENED ON THAT LONG AND STRANGE EVENING";
+    std::wstring enc = RailFenceCipher(7).encrypt(plain);
+    auto candidates = RailFenceSolver::solve(enc, 40, 3);
+    REQUIRE(candidates.size() == 3);
+    CHECK(candidates[0].rails == 7);
+    CHECK(candidates[0].plaintext == plain);
+}
+
+TEST_CASE("solve - throws on too few rails") { // ошибка: меньше двух рельс
+    CHECK_THROWS_AS(RailFenceSolver::solve(L"ABC", 1), std::invalid_argument);
+}
+
+} // END SUITE RailFenceSolver
+
+// ============================
+// TESTS FOR AlphabetTraits
+// ============================
+TEST_SUITE("AlphabetTraits") {
+
+TEST_CASE("ContiguousAlphabet - matches builtin strings") { // индексы совпадают со строками алфавитов
+    CHECK(EnAlphabet::size() == static_cast<int>(EN_ALPHABET.size()));
+    CHECK(RuAlphabet::size() == static_cast<int>(RU_ALPHABET.size()));
+    for (int i = 0; i < EnAlphabet::size(); ++i) CHECK(EnAlphabet::indexOf(EN_ALPHABET[i]) == i);
+    for (int i = 0; i < RuAlphabet::size(); ++i) CHECK(RuAlphabet::indexOf(RU_ALPHABET[i]) == i);
+    CHECK(EnAlphabet::indexOf(L'@') == -1);
+    CHECK(RuAlphabet::indexOf(L'Ё') == -1);
+    CHECK(detectBuiltinAlphabet(L"ABC") == BuiltinAlphabet::None);
+}
+
+TEST_CASE("AffineCipher - builtin alphabets follow the formula") { // специализация даёт (a*x+b) mod m
+    AffineCipher en(5, 8, EN_ALPHABET);
+    std::wstring expected;
+    for (wchar_t c : std::wstring(L"affine cipher")) {
+        if (c == L' ') { expected += c; continue; }
+        expected += EN_ALPHABET[(5 * (c - L'a') + 8) % 26];
+    }
+    CHECK(en.encrypt(L"affine cipher") == expected);
+
+    AffineCipher ru(7, 3, RU_ALPHABET);
+    CHECK(ru.decrypt(ru.encrypt(L"ШИФР АФИННЫЙ")) == L"ШИФР АФИННЫЙ");
+}
+
+TEST_CASE("PolybiusCipher - builtin board matches generic lookup") { // арифметические координаты = поиск по доске
+    for (int key : {0, 5, 50}) {
+        auto board = PolybiusCipher::build_board(EN_ALPHABET, key);
+        std::wstring expected;
+        for (wchar_t c : std::wstring(L"Hello World")) {
+            if (c == L' ') { expected += L' '; continue; }
+            for (int r = 0; r < 8; ++r)
+                for (int col = 0; col < 8; ++col)
+                    if (board[r][col] == static_cast<wchar_t>(std::towupper(c))) {
+                        expected += static_cast<wchar_t>(L'a' + col);
+                        expected += static_cast<wchar_t>(L'1' + r);
+                    }
+        }
+        CHECK(PolybiusCipher::encrypt(L"Hello World", board) == expected);
+        CHECK(PolybiusCipher::decrypt(expected, board) == L"HELLO WORLD");
+    }
+}
+
+TEST_CASE("PiCipher - dense tables agree with codebooks") { // плотные таблицы дают те же коды
+    std::unordered_map<wchar_t, std::wstring> enc_map;
+    std::unordered_map<std::wstring, wchar_t> dec_map;
+    PiCipher::build_codebooks(3, RU_ALPHABET, enc_map, dec_map);
+
+    std::wstring enc = PiCipher::encrypt(L"ПРИВЕТ, МИР!", enc_map);
+    std::wstring expected;
+    for (wchar_t c : std::wstring(L"ПРИВЕТМИР")) expected += enc_map[c];
+    CHECK(enc == expected);
+    CHECK(PiCipher::decrypt(enc, dec_map) == L"ПРИВЕТМИР");
+    CHECK(PiCipher::decrypt(L"x1", dec_map) == L"?"); // нецифровая пара
+}
+
+TEST_CASE("XORCipher - builtin alphabet rejects foreign chars") { // ошибка: символ вне EN_ALPHABET
+    XORCipher cipher(L"KEY", EN_ALPHABET);
+    CHECK_NOTHROW(cipher.encryptToHex(L"HELLO"));
+    CHECK_THROWS_AS(cipher.encryptToHex(L"HELLo"), std::runtime_error);
+
+    std::wstring text = L"HELLO WORLD";
+    std::wstring hex = cipher.encryptToHex(text);
+    CHECK_ALLOCATIONS(cipher.encrypt(text), 1);
+    CHECK_ALLOCATIONS(cipher.encryptToHex(text), 1);      // без промежуточной строки шифртекста
+    CHECK_ALLOCATIONS(cipher.decryptFromHex(hex), 3);     // очищенный HEX, байты и результат
+}
+
+TEST_CASE("XORCipher - binary mode round-trips bytes and hex format") { // двоичный режим и потоки
+    XORCipher cipher(L"KEY", EN_ALPHABET);
+    std::string data;
+    for (int i = 0; i < 1000; ++i) data += static_cast<char>(i * 37 % 256); // включая 0x00, 0x20, 0xFF
+    std::string encrypted = cipher.encryptBytes(data);
+    CHECK(encrypted.size() == data.size());
+    CHECK(encrypted[0] == 'K');
+    CHECK(cipher.decryptBytes(encrypted) == data);
+
+    // Частями произвольного размера — тот же результат, что и целиком.
+    std::istringstream in(data);
+    std::ostringstream out;
+    CHECK(cipher.processStream(in, out, 7) == data.size());
+    CHECK(out.str() == encrypted);
+
+    // Для текста без пробелов байты совпадают с HEX-режимом, HEX читается обратно.
+    std::wstring hex = cipher.encryptToHex(L"HELLOWORLD");
+    CHECK(XORCipher::bytesToHex(cipher.encryptBytes("HELLOWORLD")) == hex);
+    CHECK(XORCipher::hexToBytes(hex) == cipher.encryptBytes("HELLOWORLD"));
+    CHECK(cipher.decryptFromHex(XORCipher::bytesToHex(cipher.encryptBytes("HELLOWORLD"))) == L"HELLOWORLD");
+    CHECK_THROWS_AS(XORCipher::hexToBytes(L"0A 1"), std::runtime_error);
+}
+
+TEST_CASE("XORCipher - fused validation reports first offending offset") { // проверка в проходе шифрования
+    std::wstring text;
+    for (int i = 0; i < 200; ++i) text += (i % 9 == 0) ? L' ' : wchar_t(L'A' + i % 26);
+    std::wstring bad = text;
+    bad[150] = L'a';
+    bad[170] = L'!';
+
+    XORCipher cipher(L"KEY", EN_ALPHABET);
+    XORCipher custom(L"KEY", EN_ALPHABET + L"Ж");
+    CHECK(cipher.findInvalid(text) == std::wstring_view::npos);
+    CHECK(cipher.findInvalid(bad) == 150);
+    CHECK(custom.findInvalid(bad) == 150);
+    for (simd::Level level : {simd::Level::Scalar, simd::Level::Sse41, simd::Level::Avx2}) {
+        if (level > simd::supportedLevel()) break;
+        simd::setMaxLevel(level);
+        INFO(simd::levelName(level));
+        CHECK(cipher.encrypt(text) == custom.encrypt(text));
+        CHECK_THROWS_WITH(cipher.encrypt(bad), "Текст содержит символы не из алфавита (позиция 150)");
+        CHECK_THROWS_WITH(cipher.encryptToHex(bad), "Текст содержит символы не из алфавита (позиция 150)");
+        CHECK_THROWS_WITH(custom.encrypt(bad), "Текст содержит символы не из алфавита (позиция 150)");
+    }
+    simd::setMaxLevel(simd::Level::Avx2);
+
+    // Ошибка во втором сообщении пакета не оставляет его частичного результата.
+    CipherBatch out;
+    CHECK_THROWS_AS(cipher.processBatch(TextBatch({std::wstring_view(text), std::wstring_view(bad)}), true, out),
+                    std::runtime_error);
+    CHECK(out.size() == 1);
+    CHECK(out.data.size() == 3 * text.size());
+}
+
+} // END SUITE AlphabetTraits
+
+// ============================
+// TESTS FOR CipherChain
+// ============================
+TEST_SUITE("CipherChain") {
+
+TEST_CASE("run - fused stages match sequential ciphers") { // объединённый проход = последовательное применение
+    const std::wstring text = L"Layered encryption, 2 passes: AFFINE then gronsfeld!";
+    AffineCipher first(5, 8, EN_ALPHABET);
+    GronsfeldCipher second({3, 1, 4}, EN_ALPHABET);
+    AffineCipher third(7, 2, EN_ALPHABET);
+    GronsfeldCipher fourth({2, 7}, EN_ALPHABET);
+    std::wstring expected = fourth.process(third.encrypt(second.process(first.encrypt(text), true)), true);
+
+    CipherChain chain;
+    chain.addAffine(5, 8, EN_ALPHABET)
+         .addGronsfeld({3, 1, 4}, EN_ALPHABET)
+         .addAffine(7, 2, EN_ALPHABET)
+         .addGronsfeld({2, 7}, EN_ALPHABET);
+    CHECK(chain.passCount() == 1);
+    CHECK(chain.run(text) == expected);
+}
+
+TEST_CASE("run - Gronsfeld before Affine keeps lowercase until folded") { // регистр приводит только аффинная ступень
+    const std::wstring alphabet = L"ABCDEFGHIJ";
+    GronsfeldCipher first({1, 2}, alphabet);
+    AffineCipher second(3, 1, alphabet);
+    const std::wstring text = L"abc ABC xyz";
+
+    CipherChain chain;
+    chain.addGronsfeld({1, 2}, alphabet).addAffine(3, 1, alphabet);
+    CHECK(chain.run(text) == second.encrypt(first.process(text, true)));
+}
+
+TEST_CASE("run - opaque stages and other alphabets split passes") { // барьеры между проходами
+    CipherChain chain;
+    chain.addAffine(3, 5, EN_ALPHABET)
+         .addStage([](const std::wstring& s) { return std::wstring(s.rbegin(), s.rend()); })
+         .addAffine(3, 5, EN_ALPHABET)
+         .addGronsfeld({1}, RU_ALPHABET);
+    CHECK(chain.passCount() == 4);
+
+    AffineCipher affine(3, 5, EN_ALPHABET);
+    std::wstring step = affine.encrypt(L"ABC ПРИВЕТ");
+    step = affine.encrypt(std::wstring(step.rbegin(), step.rend()));
+    CHECK(chain.run(L"ABC ПРИВЕТ") == GronsfeldCipher({1}, RU_ALPHABET).process(step, true));
+}
+
+TEST_CASE("run - decrypting chain inverts encrypting chain") { // обратная цепочка
+    CipherChain enc, dec;
+    enc.addAffine(5, 8, RU_ALPHABET).addGronsfeld({1, 4, 8}, RU_ALPHABET);
+    dec.addGronsfeld({1, 4, 8}, RU_ALPHABET, false).addAffine(5, 8, RU_ALPHABET, false);
+    std::pmr::monotonic_buffer_resource arena;
+    CHECK(dec.run(std::wstring(enc.run(L"ШИФР ГРОНСФЕЛЬДА", &arena))) == L"ШИФР ГРОНСФЕЛЬДА");
+}
+
+TEST_CASE("addAffine - invalid key throws") { // ошибка: a не взаимно просто с m
+    CipherChain chain;
+    CHECK_THROWS_AS(chain.addAffine(2, 1, EN_ALPHABET), std::invalid_argument);
+    CHECK(chain.passCount() == 0);
+}
+
+} // END SUITE CipherChain
+
+// ============================
+// TESTS FOR TranspositionChain
+// ============================
+TEST_SUITE("TranspositionChain") {
+
+TEST_CASE("permutation - exports match ciphers") { // экспорт перестановок совпадает с шифрами
+    std::wstring text;
+    for (int i = 0; i < 16; ++i) text += static_cast<wchar_t>(L'A' + i);
+    for (size_t length : {1u, 5u, 16u}) {
+        std::wstring t = text.substr(0, length);
+        auto gather = [&t](const std::vector<size_t>& src) {
+            std::wstring r;
+            for (size_t k : src) r += t[k];
+            return r;
+        };
+        CHECK(gather(RailFenceCipher(3).permutation(length)) == RailFenceCipher(3).encrypt(t));
+        CHECK(gather(ReverserCipher::permutation(length, 4, true)) == ReverserCipher::encrypt(t, 4, true));
+        std::pmr::monotonic_buffer_resource arena;
+        CHECK(gather(TurnGridCipher(4).permutation(length)) == std::wstring(TurnGridCipher(4).process(t, true, &arena)));
+    }
+}
+
+TEST_CASE("encrypt - single gather equals sequential stages") { // один проход = последовательное применение
+    const std::wstring text = L"TRANSPOSITIONCHAIN";
+    TranspositionChain chain;
+    chain.addRailFence(3).addReverser(5, true).addRailFence(4);
+    std::wstring expected = RailFenceCipher(4).encrypt(ReverserCipher::encrypt(RailFenceCipher(3).encrypt(text), 5, true));
+    CHECK(chain.encrypt(text) == expected);
+    CHECK(chain.decrypt(expected) == text);
+}
+
+TEST_CASE("permutation - cached per length") { // кэш составных перестановок
+    TranspositionChain chain(2);
+    chain.addRailFence(3);
+    auto first = chain.permutation(10);
+    CHECK(chain.permutation(10) == first);
+    chain.permutation(11);
+    chain.permutation(12); // вытесняет длину 10
+    CHECK(chain.permutation(10) != first);
+    CHECK(*chain.permutation(10) == *first);
+}
+
+TEST_CASE("addTurnGrid - invalid grille throws") { // ошибка: размер 6 не проходит проверку отверстий
+    TranspositionChain chain;
+    CHECK_THROWS_AS(chain.addTurnGrid(6), std::runtime_error);
+    CHECK_THROWS_AS(chain.addReverser(0, false), std::invalid_argument);
+}
+
+} // END SUITE TranspositionChain
+
+// ============================
+// TESTS FOR CipherService / CipherServer
+// ============================
+TEST_SUITE("CipherService") {
+
+TEST_CASE("prepare - results match direct cipher calls") { // подготовленные шифры = прямые вызовы
+    CipherService service;
+    std::pmr::monotonic_buffer_resource arena;
+    const std::wstring text = L"HELLO WORLD";
+
+    auto run = [&](const CipherSpec& spec, const std::wstring& input, bool encrypt) {
+        return std::wstring(service.process(spec, input, encrypt, &arena));
+    };
+
+    CHECK(run({CipherKind::Affine, L"5 8", L""}, text, true) == AffineCipher(5, 8, EN_ALPHABET).encrypt(text));
+    CHECK(run({CipherKind::Gronsfeld, L"3,1,4", RU_ALPHABET}, L"ПРИВЕТ", true) ==
+          GronsfeldCipher({3, 1, 4}, RU_ALPHABET).process(L"ПРИВЕТ", true));
+    CHECK(run({CipherKind::RailFence, L"3", L""}, text, true) == RailFenceCipher(3).encrypt(text));
+    CHECK(run({CipherKind::Reverser, L"4 1", L""}, text, false) == ReverserCipher::decrypt(text, 4, true));
+    CHECK(run({CipherKind::Xor, L"KEY", L""}, text, true) == XORCipher(L"KEY", EN_ALPHABET).encryptToHex(text));
+
+    service.prepare({CipherKind::Affine, L"5 8", L""});
+    CHECK(service.preparedCount() == 5);
+}
+
+TEST_CASE("prepare - negative Polybius key wraps around the board") { // ключ клиента не выходит за доску
+    CipherService service;
+    std::pmr::monotonic_buffer_resource arena;
+    const std::wstring enc(service.process({CipherKind::Polybius, L"-5", L""}, L"HELLO", true, &arena));
+    CHECK(enc == PolybiusCipher::encrypt(L"HELLO", PolybiusCipher::build_board(EN_ALPHABET, 59)));
+    CHECK(std::wstring(service.process({CipherKind::Polybius, L"-5", L""}, enc, false, &arena)) == L"HELLO");
+}
+
+TEST_CASE("protocol - request and response round trip") { // кодирование и разбор кадров
+    CipherRequest request;
+    request.id = 77;
+    request.encrypt = false;
+    request.spec = {CipherKind::Pi, L"3", RU_ALPHABET};
+    request.text = L"ТЕКСТ";
+    std::string frame = encodeRequest(request);
+    REQUIRE(frameBodySize(frame.data()) == frame.size() - 4);
+
+    CipherRequest decoded = decodeRequest(std::string_view(frame).substr(4));
+    CHECK(decoded.id == 77);
+    CHECK_FALSE(decoded.encrypt);
+    CHECK(decoded.spec == request.spec);
+    CHECK(decoded.text == request.text);
+
+    std::string response = encodeResponse({5, false, L"ошибка"});
+    CipherResponse back = decodeResponse(std::string_view(response).substr(4));
+    CHECK(back.id == 5);
+    CHECK_FALSE(back.ok);
+    CHECK(back.payload == L"ошибка");
+}
+
+TEST_CASE("protocol - malformed frames are rejected") { // ошибка: обрезанный кадр и неизвестный шифр
+    std::string frame = encodeRequest(CipherRequest{});
+    CHECK_THROWS_AS(decodeRequest(std::string_view(frame).substr(4, frame.size() - 5)), std::invalid_argument);
+    frame[9] = 42;
+    CHECK_THROWS_AS(decodeRequest(std::string_view(frame).substr(4)), std::invalid_argument);
+    CHECK_THROWS_AS(PreparedCipher::create({CipherKind::Affine, L"5", L""}), std::invalid_argument);
+    CHECK_THROWS_AS(PreparedCipher::create({CipherKind::RailFence, L"4294967301", L""}), std::invalid_argument);
+    CHECK_THROWS_AS(PreparedCipher::create({CipherKind::TurnGrid, L"60000", L""}), std::invalid_argument);
+    CHECK_THROWS_AS(PreparedCipher::create({CipherKind::TurnGrid, L"-4", L""}), std::invalid_argument);
+}
+
+TEST_CASE("cache - hits return the same prepared cipher") { // повторный ключ не готовится заново
+    PreparedCipherCache cache;
+    CipherSpec spec{CipherKind::Polybius, L"6", L""};
+    auto first = cache.get(spec);
+    auto second = cache.get(spec);
+    auto other = cache.get({CipherKind::Pi, L"2", RU_ALPHABET});
+    CHECK(first == second);
+    CHECK(first != other);
+
+    PreparedCacheStats stats = cache.stats();
+    CHECK(stats.hits == 1);
+    CHECK(stats.misses == 2);
+    CHECK(stats.entries == 2);
+    CHECK(stats.bytes == PreparedCipherCache::entryBytes(spec) +
+                         PreparedCipherCache::entryBytes({CipherKind::Pi, L"2", RU_ALPHABET}));
+
+    CHECK_THROWS_AS(cache.get({CipherKind::Gronsfeld, L"1,x", L""}), std::invalid_argument);
+    CHECK(cache.stats().entries == 2); // ошибочный ключ не кэшируется
+
+    // Таблицы векторного ядра Виженера: четыре копии ключа, продолженного на ширину вектора.
+    const std::wstring longKey(1000, L'K');
+    CHECK(PreparedCipherCache::entryBytes({CipherKind::Vigenere, longKey, L""}) >=
+          4 * (longKey.size() + simd::MAX_LANES) * sizeof(wchar_t));
+    CHECK(PreparedCipherCache::entryBytes({CipherKind::Xor, longKey, L""}) >
+          PreparedCipherCache::entryBytes({CipherKind::Xor, L"K", L""}) + 2 * longKey.size() * sizeof(wchar_t));
+}
+
+TEST_CASE("cache - least recently used entries are evicted over the memory cap") { // вытеснение LRU
+    auto spec = [](int b) { return CipherSpec{CipherKind::Affine, L"5 " + std::to_wstring(b), L""}; };
+    const size_t entry = PreparedCipherCache::entryBytes(spec(0));
+    PreparedCipherCache cache({1, 3 * entry});
+
+    for (int b = 0; b < 3; ++b) cache.get(spec(b));
+    cache.get(spec(0));                  // 0 снова свежий, давнее всех — 1
+    cache.get(spec(3));
+    PreparedCacheStats stats = cache.stats();
+    CHECK(stats.evictions == 1);
+    CHECK(stats.entries == 3);
+    CHECK(stats.bytes <= 3 * entry);
+
+    cache.get(spec(0));
+    CHECK(cache.stats().hits == 2);
+    cache.get(spec(1));
+    CHECK(cache.stats().misses == 5);
+
+    PreparedCipherCache tiny({1, entry / 2});
+    auto cipher = tiny.get(spec(7));     // больше бюджета: возвращается, но не кэшируется
+    CHECK(cipher != nullptr);
+    CHECK(tiny.stats().entries == 0);
+}
+
+TEST_CASE("cache - concurrent lookups share prepared ciphers") { // несколько потоков, общие ключи
+    PreparedCipherCache cache({4, 1 << 20});
+    const std::wstring text = L"CONCURRENT";
+    const std::wstring expected = AffineCipher(5, 8, EN_ALPHABET).encrypt(text);
+    std::atomic<int> wrong{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            std::pmr::monotonic_buffer_resource arena;
+            for (int i = 0; i < 200; ++i) {
+                auto cipher = cache.get({CipherKind::Affine, L"5 8", L""});
+                cache.get({CipherKind::RailFence, std::to_wstring(2 + (i + t) % 5), L""});
+                if (std::wstring(cipher->apply(text, true, &arena)) != expected) ++wrong;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    CHECK(wrong == 0);
+    PreparedCacheStats stats = cache.stats();
+    CHECK(stats.entries == 6);
+    CHECK(stats.hits + stats.misses == 4 * 200 * 2);
+}
+
+#ifdef CIPHER_METRICS
+TEST_CASE("cache - hits and misses are exported as metrics") { // счётчики кэша по шифрам
+    metrics::reset();
+    CipherService service;
+    service.prepare({CipherKind::Vigenere, L"KEY", L""});
+    service.prepare({CipherKind::Vigenere, L"KEY", L""});
+    metrics::Snapshot s = metrics::snapshot();
+    const auto& row = s[cipherKindIndex(CipherKind::Vigenere)];
+    CHECK(row[static_cast<size_t>(metrics::Counter::CacheMisses)] == 1);
+    CHECK(row[static_cast<size_t>(metrics::Counter::CacheHits)] == 1);
+    CHECK(service.cacheStats().hits == 1);
+}
+#endif
+
+#ifdef CIPHER_SOCKET_TESTS
+TEST_CASE("CipherServer - client round trip over unix socket") { // клиент и сервер через сокет
+    std::string path = "/tmp/cipher_test_" + std::to_string(::getpid()) + ".sock";
+    CipherServerOptions options;
+    options.socketPath = path;
+    options.workers = 2;
+    options.maxBatch = 8;
+    CipherServer server(options);
+    server.start();
+
+    CipherClient client(path);
+    CipherSpec spec{CipherKind::Vigenere, L"KEY", L""};
+    std::wstring enc = client.encrypt(spec, L"ATTACK AT DAWN");
+    CHECK(enc == std::wstring(VigenereCipher(L"KEY").zasifrovat(L"ATTACK AT DAWN", std::pmr::new_delete_resource())));
+    CHECK(client.decrypt(spec, enc) == L"ATTACK AT DAWN");
+
+    for (std::uint32_t id = 100; id < 132; ++id) {
+        client.send({id, true, {CipherKind::Affine, L"5 8", L""}, L"PIPELINE"});
+    }
+    const std::wstring expected = AffineCipher(5, 8, EN_ALPHABET).encrypt(L"PIPELINE");
+    std::vector<bool> seen(32, false);
+    for (int i = 0; i < 32; ++i) {
+        CipherResponse response = client.receive();
+        CHECK(response.ok);
+        CHECK(response.payload == expected);
+        seen[response.id - 100] = true;
+    }
+    CHECK(std::all_of(seen.begin(), seen.end(), [](bool b) { return b; }));
+
+    CHECK_THROWS_AS(client.encrypt({CipherKind::Affine, L"2 1", L""}, L"X"), std::runtime_error);
+    server.stop();
+    CHECK(server.processedCount() == 35);
+}
+
+TEST_CASE("CipherServer - socket path is taken over only from a stale socket") { // чужой сокет и обычный файл не удаляются
+    std::string path = "/tmp/cipher_test_owner_" + std::to_string(::getpid()) + ".sock";
+    CipherServerOptions options;
+    options.socketPath = path;
+    options.workers = 1;
+
+    ::close(listenUnix(path)); // сокет без процесса: подключиться нельзя
+    CipherServer first(options);
+    first.start();
+    CipherServer second(options);
+    CHECK_THROWS_AS(second.start(), std::runtime_error);
+    CHECK(CipherClient(path).encrypt({CipherKind::RailFence, L"2", L""}, L"ABCD") == L"ACBD");
+
+    ::unlink(path.c_str()); // путь переходит к другому серверу до остановки первого
+    second.start();
+    first.stop();
+    CHECK(CipherClient(path).encrypt({CipherKind::RailFence, L"2", L""}, L"ABCD") == L"ACBD");
+    second.stop();
+    CHECK(::access(path.c_str(), F_OK) != 0);
+
+    { std::ofstream(path) << "data"; }
+    CHECK_THROWS_AS(listenUnix(path), std::runtime_error);
+    CHECK(::access(path.c_str(), F_OK) == 0);
+    ::unlink(path.c_str());
+}
+
+TEST_CASE("CipherServer - client that does not read responses does not stall the server") { // обратное давление
+    std::string path = "/tmp/cipher_test_slow_" + std::to_string(::getpid()) + ".sock";
+    CipherServerOptions options;
+    options.socketPath = path;
+    options.workers = 2;
+    options.maxBatch = 8;
+    options.maxPendingOutput = 64 * 1024;
+    options.maxPendingRequests = 16;
+    CipherServer server(options);
+    server.start();
+
+    constexpr std::uint32_t REQUESTS = 1024;
+    const std::wstring text(16 * 1024, L'A');
+    int fd = connectUnix(path);
+    std::thread writer([&] {
+        for (std::uint32_t id = 0; id < REQUESTS; ++id) {
+            sendAll(fd, encodeRequest({id, true, {CipherKind::RailFence, L"3", L""}, text}));
+        }
+    });
+
+    // Клиент не читает ответы: сервер перестаёт читать его запросы, а не ждёт в send.
+    size_t processed = 0;
+    for (int i = 0; i < 100; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const size_t now = server.processedCount();
+        if (now != 0 && now == processed) break;
+        processed = now;
+    }
+    CHECK(processed < REQUESTS / 4);
+    CHECK(CipherClient(path).encrypt({CipherKind::RailFence, L"2", L""}, L"ABCD") == L"ACBD");
+
+    // Когда клиент начинает читать, сервер досылает ответы и продолжает читать запросы.
+    std::vector<bool> seen(REQUESTS, false);
+    std::string body;
+    for (std::uint32_t i = 0; i < REQUESTS; ++i) {
+        char header[4];
+        REQUIRE(recvExact(fd, header, 4));
+        body.resize(frameBodySize(header));
+        REQUIRE(recvExact(fd, &body[0], body.size()));
+        CipherResponse response = decodeResponse(body);
+        CHECK(response.ok);
+        CHECK(response.payload.size() == text.size());
+        seen[response.id] = true;
+    }
+    writer.join();
+    CHECK(std::all_of(seen.begin(), seen.end(), [](bool b) { return b; }));
+    ::close(fd);
+    server.stop();
+}
+
+TEST_CASE("CipherServer - responses are delivered after the client closes its write side") { // shutdown(SHUT_WR)
+    std::string path = "/tmp/cipher_test_half_" + std::to_string(::getpid()) + ".sock";
+    CipherServerOptions options;
+    options.socketPath = path;
+    options.workers = 2;
+    options.maxBatch = 4;
+    CipherServer server(options);
+    server.start();
+
+    constexpr std::uint32_t REQUESTS = 64;
+    const std::wstring text(16 * 1024, L'B'); // ответы не помещаются в буфер сокета
+    int fd = connectUnix(path);
+    for (std::uint32_t id = 0; id < REQUESTS; ++id) {
+        sendAll(fd, encodeRequest({id, true, {CipherKind::Vigenere, L"KEY", L""}, text}));
+    }
+    sendAll(fd, std::string("\2\0\0\0xx", 6)); // ошибка разбора тоже получает ответ
+    REQUIRE(::shutdown(fd, SHUT_WR) == 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)); // сервер упирается в EAGAIN
+
+    std::vector<bool> seen(REQUESTS, false);
+    size_t errors = 0;
+    std::string body;
+    char header[4];
+    for (std::uint32_t i = 0; i <= REQUESTS; ++i) {
+        REQUIRE(recvExact(fd, header, 4));
+        body.resize(frameBodySize(header));
+        REQUIRE(recvExact(fd, &body[0], body.size()));
+        CipherResponse response = decodeResponse(body);
+        if (!response.ok) {
+            ++errors;
+            continue;
+        }
+        CHECK(response.payload.size() == text.size());
+        seen[response.id] = true;
+    }
+    CHECK(errors == 1);
+    CHECK(std::all_of(seen.begin(), seen.end(), [](bool b) { return b; }));
+    CHECK_FALSE(recvExact(fd, header, 4)); // после последнего ответа сервер закрывает соединение
+    ::close(fd);
+    server.stop();
+}
+#endif
+
+} // END SUITE CipherService
+
+// ============================
+// TESTS FOR FilePipeline
+// ============================
+TEST_SUITE("FilePipeline") {
+
+TEST_CASE("runFilePipeline - blocks continue the key of the whole text") { // фаза ключа между блоками
+    std::wstring text;
+    for (int i = 0; i < 300; ++i) {
+        text += (i % 7 == 0) ? L' ' : (i % 3 == 0) ? wchar_t(L'А' + i % 32) : wchar_t(L'A' + i % 26);
+    }
+    const std::string input = toUtf8(text);
+
+    const CipherSpec specs[] = {
+        {CipherKind::Gronsfeld, L"3 1 4 1 5", RU_ALPHABET},
+        {CipherKind::Vigenere, L"KEY", L""},
+        {CipherKind::Vigenere, L"LONGKEY X", L""}, // позиция ключа останавливается на пробеле
+        {CipherKind::Affine, L"5 8", L""},
+        {CipherKind::RailFence, L"3", L""},        // Whole: весь текст одним блоком
+    };
+    std::pmr::monotonic_buffer_resource arena;
+    for (const CipherSpec& spec : specs) {
+        auto cipher = PreparedCipher::create(spec);
+        const std::string expected = toUtf8(cipher->apply(text, true, &arena));
+        for (size_t blockSize : {5, 64}) { // 5 байт режут двухбайтовые буквы; 64 — векторные ядра
+            INFO(cipherKindName(spec.kind), " block ", blockSize);
+            FilePipelineOptions options;
+            options.blockSize = blockSize;
+            options.workers = 3;
+            std::istringstream in(input);
+            std::ostringstream out;
+            FilePipelineReport report = runFilePipeline(*cipher, true, in, out, options);
+            CHECK(out.str() == expected);
+            CHECK(report.bytesIn == input.size());
+            CHECK(report.bytesOut == expected.size());
+
+            std::istringstream back(out.str());
+            std::ostringstream plain;
+            runFilePipeline(*cipher, false, back, plain, options);
+            CHECK(plain.str() == toUtf8(cipher->apply(fromUtf8(expected), false, &arena)));
+        }
+    }
+}
+
+TEST_CASE("runFilePipeline - XOR bytes and error propagation") { // двоичный режим, ошибки стадий
+    std::string data;
+    for (int i = 0; i < 5000; ++i) data += static_cast<char>(i * 131 % 256);
+    auto cipher = PreparedCipher::create({CipherKind::Xor, L"KEY", L""});
+    std::string expected(data.size(), '\0');
+    cipher->applyBytes(data.data(), data.size(), &expected[0], 0);
+
+    FilePipelineOptions options;
+    options.blockSize = 100;
+    options.workers = 4;
+    std::istringstream in(data);
+    std::ostringstream out;
+    FilePipelineReport report = runFilePipeline(*cipher, true, in, out, options);
+    CHECK(out.str() == expected);
+    CHECK(report.blocks == 50);
+    CHECK(report.workers == 4);
+
+    // Пустой вход — пустой выход.
+    std::istringstream empty("");
+    std::ostringstream none;
+    CHECK(runFilePipeline(*cipher, true, empty, none, options).blocks == 0);
+    CHECK(none.str().empty());
+
+    // Некорректный UTF-8 в середине потока: ошибка рабочего потока пробрасывается, конвейер останавливается.
+    auto gronsfeld = PreparedCipher::create({CipherKind::Gronsfeld, L"1 2", L""});
+    std::istringstream broken(std::string(1000, 'A') + "\xFF" + std::string(1000, 'B'));
+    std::ostringstream sink;
+    CHECK_THROWS_AS(runFilePipeline(*gronsfeld, true, broken, sink, options), std::invalid_argument);
+    CHECK_THROWS_AS(gronsfeld->applyBytes(data.data(), 1, &expected[0], 0), std::logic_error);
+}
+
+#ifdef CIPHER_BLOCK_IO
+TEST_CASE("runFilePipelineFiles - pread and io_uring match buffered streams") { // бэкенды ввода-вывода
+    const std::string base = "/tmp/cipher_pipeline_" + std::to_string(::getpid());
+    std::wstring text;
+    for (int i = 0; i < 20000; ++i) text += (i % 5 == 0) ? L' ' : (i % 2) ? wchar_t(L'Б' + i % 30) : wchar_t(L'a' + i % 26);
+    std::ofstream(base + ".in", std::ios::binary) << toUtf8(text);
+    auto readFile = [](const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), {});
+    };
+
+    for (const CipherSpec& spec : {CipherSpec{CipherKind::Gronsfeld, L"2 7 1 8", RU_ALPHABET},
+                                   CipherSpec{CipherKind::Xor, L"KEY", L""},
+                                   CipherSpec{CipherKind::Pi, L"3", L""}}) {
+        auto cipher = PreparedCipher::create(spec);
+        FilePipelineOptions options;
+        options.blockSize = 4096 + 3; // O_DIRECT округляет до 8192
+        options.workers = 2;
+        options.ioDepth = 4;
+        options.backend = IoBackend::Stream;
+        runFilePipelineFiles(*cipher, true, base + ".in", base + ".stream", options);
+        const std::string expected = readFile(base + ".stream");
+
+        for (IoBackend backend : {IoBackend::Pread, IoBackend::Uring}) {
+            for (bool direct : {false, true}) {
+                INFO(cipherKindName(spec.kind), " backend ", static_cast<int>(backend), " direct ", direct);
+                options.backend = backend;
+                options.directIo = direct;
+                FilePipelineReport report = runFilePipelineFiles(*cipher, true, base + ".in", base + ".out", options);
+                CHECK(readFile(base + ".out") == expected);
+                CHECK(report.bytesOut == expected.size());
+                if (backend == IoBackend::Pread) CHECK(std::string(report.backend) == "pread");
+            }
+        }
+    }
+    std::remove((base + ".in").c_str());
+    std::remove((base + ".stream").c_str());
+    std::remove((base + ".out").c_str());
+    CHECK_THROWS_AS(runFilePipelineFiles(*PreparedCipher::create({CipherKind::Xor, L"KEY", L""}), true,
+                                         base + ".missing", base + ".out"), std::runtime_error);
+}
+#endif
+
+} // END SUITE FilePipeline
+
+// ============================
+// TESTS FOR CipherBatch
+// ============================
+TEST_SUITE("CipherBatch") {
+
+TEST_CASE("processBatch - every cipher matches single calls") { // пакет = отдельные вызовы
+    CipherService service;
+    const std::vector<std::wstring> messages = {L"HELLO WORLD", L"", L"ATTACK AT 5, AM", L"X", L"ПРИВЕТ МИР"};
+    const std::vector<std::wstring_view> views(messages.begin(), messages.end());
+    const std::vector<CipherSpec> specs = {
+        {CipherKind::Xor, L"KEY", EN_ALPHABET + RU_ALPHABET + L",5"},
+        {CipherKind::Gronsfeld, L"3,1,4", L""},
+        {CipherKind::Vigenere, L"LEMON", L""},
+        {CipherKind::Affine, L"5 8", L""},
+        {CipherKind::RailFence, L"3", L""},
+        {CipherKind::TurnGrid, L"4", L""},
+        {CipherKind::Reverser, L"4 1", L""},
+        {CipherKind::Polybius, L"3", L""},
+        {CipherKind::Pi, L"2", EN_ALPHABET + RU_ALPHABET},
+    };
+
+    for (const CipherSpec& spec : specs) {
+        std::string kind = cipherKindName(spec.kind);
+        CAPTURE(kind);
+        CipherBatch encrypted;
+        service.processBatch(spec, views, true, encrypted);
+        REQUIRE(encrypted.size() == messages.size());
+        CHECK(encrypted.offsets.back() == encrypted.data.size());
+
+        std::vector<std::wstring_view> cipherViews;
+        for (size_t i = 0; i < messages.size(); ++i) {
+            auto single = service.process(spec, messages[i], true, std::pmr::new_delete_resource());
+            CHECK(encrypted[i] == std::wstring_view(single));
+            cipherViews.push_back(encrypted[i]);
+        }
+
+        CipherBatch decrypted;
+        service.processBatch(spec, cipherViews, false, decrypted);
+        for (size_t i = 0; i < messages.size(); ++i) {
+            auto single = service.process(spec, std::wstring(cipherViews[i]), false, std::pmr::new_delete_resource());
+            CHECK(decrypted[i] == std::wstring_view(single));
+        }
+    }
+}
+
+TEST_CASE("processBatch - failed message keeps finished results") { // ошибка: сообщение вне алфавита
+    XORCipher cipher(L"KEY", EN_ALPHABET);
+    const std::vector<std::wstring_view> texts = {L"HELLO", L"WORLD", L"BAD!", L"NEVER"};
+    CipherBatch batch;
+    CHECK_THROWS_AS(cipher.processBatch(texts, true, batch), std::runtime_error);
+    REQUIRE(batch.size() == 2);
+    CHECK(batch.data.size() == batch.offsets.back());
+    CHECK(batch[1] == std::wstring_view(cipher.encryptToHex(L"WORLD", std::pmr::new_delete_resource())));
+}
+
+TEST_CASE("processBatch - reused batch does not touch the heap") { // буферы и временные ключи из пула
+    GronsfeldCipher gronsfeld({3, 1, 4}, EN_ALPHABET);
+    RailFenceCipher railFence(3);
+    std::vector<std::wstring> messages(64, L"SHORT MESSAGE NUMBER");
+    const std::vector<std::wstring_view> texts(messages.begin(), messages.end());
+
+    CipherBatch batch;
+    CHECK_ALLOCATIONS((batch.clear(), gronsfeld.processBatch(texts, true, batch)), 0);
+    CHECK(batch.size() == texts.size());
+    CHECK_ALLOCATIONS((batch.clear(), railFence.processBatch(texts, false, batch)), 0);
+    CHECK(batch[63] == std::wstring_view(railFence.decrypt(messages[63], std::pmr::new_delete_resource())));
+}
+
+} // END SUITE CipherBatch
+
+// ============================
+// TESTS FOR alloc_tracker
+// ============================
+TEST_SUITE("AllocTracker") {
+
+TEST_CASE("measure - counts allocations of the second call only") { // первый вызов не учитывается
+    int calls = 0;
+    auto stats = alloc_tracker::measure([&] {
+        std::vector<int> v(calls++ == 0 ? 1000 : 10);
+    });
+    CHECK(calls == 2);
+    CHECK(stats.count == 1);
+    CHECK(stats.bytes == 10 * sizeof(int));
+    CHECK_ALLOCATIONS(std::wstring_view(L"no allocation here"), 0);
+}
+
+} // END SUITE AllocTracker
+
+// ============================
+// TESTS FOR reference kernels / differential harness
+// ============================
+TEST_SUITE("Differential") {
+
+TEST_CASE("reference kernels - known ciphertexts") { // эталоны дают те же результаты, что и примеры выше
+    CHECK(reference::affine(L"HELLO", 5, 8, EN_ALPHABET, true) == L"RCLLA");
+    CHECK(reference::affine(L"C J?V", 7, 2, EN_ALPHABET, false) == L"A B?Z");
+    CHECK(reference::gronsfeld(L"SECRET", {4, 3, 2, 1}, EN_ALPHABET, true) == L"WHESIW");
+    CHECK(reference::vigenere(L"HELLO", L"KEY", true) == L"RIJVS");
+    CHECK(reference::xorDecryptFromHex(reference::xorEncryptToHex(L"HELLO WORLD", L"KEY", EN_ALPHABET), L"KEY") ==
+          L"HELLO WORLD");
+    CHECK_THROWS_AS(reference::xorEncryptToHex(L"HELLo", L"KEY", EN_ALPHABET), std::runtime_error);
+}
+
+TEST_CASE("runDifferential - fast paths match reference") { // случайные тексты, ключи и алфавиты
+    DifferentialOptions options;
+    options.seed = 2024;
+    options.trials = 150;
+    options.maxLength = 80;
+    options.benchRepeats = 0;
+    auto reports = runDifferential(options);
+    CHECK(reports.size() == 9);
+    for (const auto& report : reports) {
+        INFO(report.name);
+        CHECK(report.trials == 150);
+        CHECK(report.mismatches == 0);
+        CHECK(report.speedup() == 0.0); // замер отключён
+    }
+}
+
+TEST_CASE("runDifferential - every SIMD level matches reference") { // скалярный, SSE4.1 и AVX2 варианты
+    DifferentialOptions options;
+    options.seed = 7;
+    options.trials = 100;
+    options.maxLength = 120;
+    options.benchRepeats = 0;
+    for (simd::Level level : {simd::Level::Scalar, simd::Level::Sse41, simd::Level::Avx2}) {
+        if (level > simd::supportedLevel()) break;
+        simd::setMaxLevel(level);
+        for (const auto& report : runDifferential(options)) {
+            INFO(simd::levelName(level), " ", report.name);
+            CHECK(report.mismatches == 0);
+        }
+    }
+    simd::setMaxLevel(simd::Level::Avx2);
+}
+
+TEST_CASE("shiftContiguous - vector and scalar paths agree on passthrough") { // символы вне алфавита
+    std::wstring text;
+    for (int i = 0; i < 100; ++i) text += (i % 7 == 0) ? L'.' : (i % 5 == 0) ? L'ж' : wchar_t(L'A' + i % 26);
+    const std::vector<int> key = {3, 1, 4, 1, 5};
+    const std::wstring expected = reference::gronsfeld(text, key, EN_ALPHABET, true);
+
+    std::vector<wchar_t> shifts(key.size() + simd::MAX_LANES);
+    for (size_t t = 0; t < shifts.size(); ++t) shifts[t] = static_cast<wchar_t>(key[t % key.size()]);
+    for (simd::Level level : {simd::Level::Scalar, simd::Level::Sse41, simd::Level::Avx2}) {
+        if (level > simd::supportedLevel()) break;
+        simd::setMaxLevel(level);
+        std::wstring out(text.size(), L'\0');
+        size_t passthrough = simd::shiftContiguous(text.data(), text.size(), &out[0], L'A', 26, shifts.data(),
+                                                   key.size());
+        INFO(simd::levelName(level));
+        CHECK(out == expected);
+        CHECK(passthrough == 15 + 17);
+    }
+    simd::setMaxLevel(simd::Level::Avx2);
+}
+
+TEST_CASE("VigenereCipher - vector blocks keep key position across fallbacks") { // пробел в ключе, é и Ё
+    std::wstring text;
+    for (int i = 0; i < 300; ++i) {
+        text += (i % 41 == 0) ? L'é' : (i % 11 == 0) ? L' ' : (i % 13 == 0) ? L'.' : (i % 17 == 0) ? L'Ё'
+                : (i % 3 == 0) ? wchar_t(L'a' + i % 26) : wchar_t(L'A' + i * 7 % 26);
+    }
+    for (const std::wstring key : {L"KEY", L"LongerKeyThanOneVector", L"Ab cD"}) {
+        VigenereCipher cipher(key);
+        for (simd::Level level : {simd::Level::Scalar, simd::Level::Sse41, simd::Level::Avx2}) {
+            if (level > simd::supportedLevel()) break;
+            simd::setMaxLevel(level);
+            INFO(simd::levelName(level));
+            CHECK(cipher.zasifrovat(text, std::pmr::new_delete_resource()) ==
+                  reference::vigenere(text, key, true).c_str());
+            CHECK(cipher.rasshifrovat(text, std::pmr::new_delete_resource()) ==
+                  reference::vigenere(text, key, false).c_str());
+        }
+    }
+    simd::setMaxLevel(simd::Level::Avx2);
+}
+
+TEST_CASE("AffineCipher - vector path matches reference for any key") { // b вне [0, m), строчные, é
+    std::wstring text;
+    for (int i = 0; i < 300; ++i) {
+        text += (i % 37 == 0) ? L'é' : (i % 11 == 0) ? L' ' : (i % 13 == 0) ? L'!' : (i % 29 == 0) ? L'ı'
+                : (i % 3 == 0) ? wchar_t(L'a' + i % 26) : wchar_t(L'A' + i * 7 % 26);
+    }
+    for (auto [a, b] : {std::pair{5, 8}, std::pair{25, 26}, std::pair{3, 40}, std::pair{53, 100}}) {
+        // При b > m дешифрование исходной формулой расходится с эталоном: сравниваем со скалярным кодом.
+        AffineCipher cipher(a, b, EN_ALPHABET);
+        simd::setMaxLevel(simd::Level::Scalar);
+        const std::wstring encrypted = cipher.encrypt(text);
+        const std::wstring decrypted = cipher.decrypt(text);
+        CHECK(encrypted == reference::affine(text, a, b, EN_ALPHABET, true));
+        for (simd::Level level : {simd::Level::Sse41, simd::Level::Avx2}) {
+            if (level > simd::supportedLevel()) break;
+            simd::setMaxLevel(level);
+            INFO(simd::levelName(level), " a=", a, " b=", b);
+            CHECK(cipher.encrypt(text) == encrypted);
+            CHECK(cipher.decrypt(text) == decrypted);
+        }
+    }
+    simd::setMaxLevel(simd::Level::Avx2);
+}
+
+} // END SUITE Differential
+
+// ============================
+// TESTS FOR metrics
+// ============================
+TEST_SUITE("Metrics") {
+
+TEST_CASE("kind names round trip") { // имена шифров для меток и протокола
+    for (size_t i = 1; i <= CIPHER_KIND_COUNT; ++i) {
+        CipherKind kind = static_cast<CipherKind>(i);
+        CHECK(parseCipherKind(cipherKindName(kind)) == kind);
+        CHECK(cipherKindIndex(kind) == i - 1);
+    }
+    CHECK_THROWS_AS(parseCipherKind("enigma"), std::invalid_argument);
+}
+
+#ifdef CIPHER_METRICS
+TEST_CASE("counters - passthrough, dropped and substituted characters") { // счётчики по шифрам
+    auto at = [](const metrics::Snapshot& s, CipherKind kind, metrics::Counter counter) {
+        return s[cipherKindIndex(kind)][static_cast<size_t>(counter)];
+    };
+    metrics::reset();
+
+    AffineCipher affine(5, 8, EN_ALPHABET);
+    affine.encrypt(L"HI, BOB!");                                 // ',', ' ', '!' копируются
+    std::unordered_map<wchar_t, std::wstring> enc;
+    std::unordered_map<std::wstring, wchar_t> dec;
+    PiCipher::build_codebooks(1, EN_ALPHABET, enc, dec);
+    PiCipher::encrypt(L"AB-C", enc);                             // '-' отбрасывается
+    PiCipher::decrypt(enc[L'A'] + L"xy" + enc[L'B'], dec);       // "xy" -> '?'
+
+    metrics::Snapshot s = metrics::snapshot();
+    CHECK(at(s, CipherKind::Affine, metrics::Counter::Calls) == 1);
+    CHECK(at(s, CipherKind::Affine, metrics::Counter::CharsIn) == 8);
+    CHECK(at(s, CipherKind::Affine, metrics::Counter::CharsOut) == 8);
+    CHECK(at(s, CipherKind::Affine, metrics::Counter::Passthrough) == 3);
+    CHECK(at(s, CipherKind::Pi, metrics::Counter::Calls) == 2);
+    CHECK(at(s, CipherKind::Pi, metrics::Counter::Dropped) == 1);
+    CHECK(at(s, CipherKind::Pi, metrics::Counter::Substituted) == 1);
+    CHECK(at(s, CipherKind::Xor, metrics::Counter::Calls) == 0);
+
+    std::ostringstream out;
+    metrics::writePrometheus(out);
+    CHECK(out.str().find("cipher_chars_passthrough_total{cipher=\"affine\"} 3\n") != std::string::npos);
+    CHECK(out.str().find("# TYPE cipher_substitutions_total counter\n") != std::string::npos);
+}
+
+TEST_CASE("counters - contributions of finished threads are kept") { // блоки потоков не теряются
+    metrics::reset();
+    std::thread worker([] { RailFenceCipher(3).encrypt(L"WEAREDISCOVERED"); });
+    worker.join();
+    RailFenceCipher(2).decrypt(L"ABCD");
+    metrics::Snapshot s = metrics::snapshot();
+    CHECK(s[cipherKindIndex(CipherKind::RailFence)][static_cast<size_t>(metrics::Counter::Calls)] == 2);
+    CHECK(s[cipherKindIndex(CipherKind::RailFence)][static_cast<size_t>(metrics::Counter::CharsIn)] == 19);
+}
+#endif
+
+} // END SUITE Metrics
@@ -0,0 +1,628 @@
+/**
+ * @file file_pipeline.cpp
+ * @brief Реализация конвейера чтение → шифрование → запись на кольцах без блокировок.
+ *
+ * Стадии чтения и записи работают через IoQueue: поток, pread/pwrite или io_uring.
+ */
+
+#include "file_pipeline.h"
+#include "block_io.h"
+#include "cipher_service.h"
+#include "utf8.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef CIPHER_BLOCK_IO
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Ограниченная очередь многих производителей и потребителей (кольцо Вьюкова).
+     *
+     * Каждая ячейка хранит номер хода: производитель занимает позицию head, если номер
+     * ячейки равен head, потребитель — позицию tail, если номер равен tail + 1. Позиции
+     * захватываются compare_exchange, значения передаются через release/acquire номера.
+     */
+    template <class T>
+    class BoundedQueue {
+    public:
+        explicit BoundedQueue(size_t minCapacity) {
+            size_t capacity = 2;
+            while (capacity < minCapacity) capacity <<= 1;
+            mask_ = capacity - 1;
+            cells_ = std::make_unique<Cell[]>(capacity);
+            for (size_t i = 0; i < capacity; ++i) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        bool tryPush(T value) {
+            size_t pos = head_.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = cells_[pos & mask_];
+                size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+                if (diff == 0) {
+                    if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        cell.value = value;
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false; // заполнена
+                } else {
+                    pos = head_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool tryPop(T& value) {
+            size_t pos = tail_.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = cells_[pos & mask_];
+                size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+                if (diff == 0) {
+                    if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        value = cell.value;
+                        cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false; // пуста
+                } else {
+                    pos = tail_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence{0};
+            T value{};
+        };
+
+        std::unique_ptr<Cell[]> cells_;
+        size_t mask_ = 0;
+        alignas(64) std::atomic<size_t> head_{0};
+        alignas(64) std::atomic<size_t> tail_{0};
+    };
+
+    /**
+     * @brief Ожидание соседней стадии: сначала отдаёт квант, потом засыпает.
+     */
+    class Backoff {
+    public:
+        void pause() {
+            if (++rounds_ < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+
+    private:
+        unsigned rounds_ = 0;
+    };
+
+    constexpr size_t IO_ALIGNMENT = 4096; ///< Выравнивание буферов чтения и блоков для O_DIRECT
+    constexpr std::uint64_t UNKNOWN_SIZE = std::numeric_limits<std::uint64_t>::max();
+
+    struct AlignedDelete {
+        void operator()(char* p) const { ::operator delete[](p, std::align_val_t(IO_ALIGNMENT)); }
+    };
+
+    /**
+     * @brief Переиспользуемый блок: буферы сохраняют ёмкость между оборотами.
+     *
+     * Чтение идёт в storage со смещения IO_ALIGNMENT; место перед данными занимает
+     * незаконченный символ UTF-8 с конца предыдущего блока, так что буфер не копируется
+     * и может быть зарегистрирован в io_uring.
+     */
+    struct Block {
+        std::unique_ptr<char[], AlignedDelete> storage;
+        int index = 0;                 ///< Номер зарегистрированного буфера
+        std::string_view input;        ///< Данные для шифра (в storage или во всём потоке для Whole)
+        std::string output;
+        std::wstring text;
+        std::uint64_t sequence = 0;    ///< Номер блока в потоке (порядок записи)
+        std::uint64_t position = 0;    ///< Смещение первого байта блока в потоке
+        std::uint64_t readIndex = 0;   ///< Номер операции чтения (блоки без данных номера не получают)
+        size_t got = 0;                ///< Прочитано байт
+        std::uint64_t writeOffset = 0; ///< Смещение результата в выходном файле
+        size_t written = 0;            ///< Записано байт результата
+
+        char* data() { return storage.get() + IO_ALIGNMENT; }
+    };
+
+    double since(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    /**
+     * @brief Очередь поверх std::istream / std::ostream: операции синхронны, смещения
+     *        совпадают с текущей позицией потока.
+     */
+    class StreamQueue : public IoQueue {
+    public:
+        StreamQueue(std::istream* in, std::ostream* out) : in_(in), out_(out) {}
+
+        const char* name() const override { return "stream"; }
+        unsigned depth() const override { return 1; }
+
+        void read(int, char* dest, size_t size, std::uint64_t, int, void* tag) override {
+            in_->read(dest, static_cast<std::streamsize>(size));
+            completed_ = {tag, in_->bad() ? -EIO : static_cast<std::int64_t>(in_->gcount())};
+        }
+
+        void write(int, const char* src, size_t size, std::uint64_t, void* tag) override {
+            out_->write(src, static_cast<std::streamsize>(size));
+            completed_ = {tag, *out_ ? static_cast<std::int64_t>(size) : -EIO};
+        }
+
+        Completion wait() override { return completed_; }
+
+    private:
+        std::istream* in_;
+        std::ostream* out_;
+        Completion completed_;
+    };
+
+    /**
+     * @brief Общее состояние конвейера одного запуска.
+     */
+    class Pipeline {
+    public:
+        Pipeline(const PreparedCipher& cipher, bool encrypt, const FilePipelineOptions& options)
+            : cipher_(cipher),
+              encrypt_(encrypt),
+              unit_(cipher.streamUnit()),
+              blockSize_(options.directIo ? (std::max<size_t>(options.blockSize, 1) + IO_ALIGNMENT - 1) /
+                                                IO_ALIGNMENT * IO_ALIGNMENT
+                                          : std::max<size_t>(options.blockSize, 4)),
+              workers_(options.workers != 0 ? options.workers : std::max(1u, std::thread::hardware_concurrency())),
+              blockCount_(std::max<size_t>(workers_ * std::max<size_t>(options.blocksPerWorker, 1), 3)),
+              blocks_(blockCount_),
+              slots_(std::make_unique<std::atomic<Block*>[]>(blockCount_)),
+              free_(blockCount_),
+              work_(blockCount_ + workers_) {
+            for (size_t i = 0; i < blockCount_; ++i) {
+                Block& block = blocks_[i];
+                block.storage.reset(static_cast<char*>(
+                    ::operator new[](IO_ALIGNMENT + blockSize_, std::align_val_t(IO_ALIGNMENT))));
+                block.index = static_cast<int>(i);
+                slots_[i].store(nullptr, std::memory_order_relaxed);
+                free_.tryPush(&block);
+            }
+        }
+
+        /**
+         * @brief Регистрирует буферы чтения в очереди reader (io_uring).
+         */
+        bool registerBuffers(IoQueue& reader) {
+            std::vector<char*> buffers;
+            for (Block& block : blocks_) {
+                buffers.push_back(block.storage.get());
+            }
+            registered_ = reader.registerBuffers(buffers.data(), buffers.size(), IO_ALIGNMENT + blockSize_);
+            return registered_;
+        }
+
+        /**
+         * @brief Запускает стадии: чтение inSize байт (UNKNOWN_SIZE — до конца) из inFd
+         *        очередью reader, запись в outFd очередью writer в вызывающем потоке.
+         */
+        FilePipelineReport run(IoQueue& reader, int inFd, std::uint64_t inSize, IoQueue& writer, int outFd) {
+            const Clock::time_point start = Clock::now();
+            std::vector<double> workerBusy(workers_, 0.0);
+            double readerBusy = 0.0;
+            std::vector<std::thread> threads;
+            threads.reserve(workers_ + 1);
+            threads.emplace_back([&] {
+                guarded([&] { readLoop(reader, inFd, inSize, readerBusy); });
+                sendStop();
+            });
+            for (size_t w = 0; w < workers_; ++w) {
+                threads.emplace_back([&, w] { guarded([&] { workLoop(workerBusy[w]); }); });
+            }
+            double writerBusy = 0.0;
+            guarded([&] { writeLoop(writer, outFd, writerBusy); });
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            if (error_) {
+                std::rethrow_exception(error_);
+            }
+
+            FilePipelineReport report;
+            report.bytesIn = bytesIn_;
+            report.bytesOut = bytesOut_;
+            report.blocks = total_.load(std::memory_order_relaxed);
+            report.workers = workers_;
+            report.seconds = since(start);
+            report.backend = reader.name();
+            report.registeredBuffers = registered_;
+            if (report.seconds > 0.0) {
+                double busy = 0.0;
+                for (double b : workerBusy) busy += b;
+                report.readerBusy = readerBusy / report.seconds;
+                report.workersBusy = busy / (report.seconds * static_cast<double>(workers_));
+                report.writerBusy = writerBusy / report.seconds;
+            }
+            return report;
+        }
+
+    private:
+        /// Первая ошибка останавливает все стадии; она же пробрасывается из run().
+        template <class Stage>
+        void guarded(Stage stage) {
+            try {
+                stage();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex_);
+                if (!error_) error_ = std::current_exception();
+                aborted_.store(true, std::memory_order_release);
+            }
+        }
+
+        bool aborted() const { return aborted_.load(std::memory_order_acquire); }
+
+        /// nullptr в кольце работ — сигнал завершения рабочему потоку.
+        void sendStop() {
+            for (size_t w = 0; w < workers_; ++w) {
+                work_.tryPush(nullptr); // ёмкость кольца работ: все блоки и все сигналы
+            }
+        }
+
+        /**
+         * @brief Держит до depth чтений «в полёте»; завершения приходят в любом порядке,
+         *        в кольцо работ блоки уходят по порядку смещений.
+         */
+        void readLoop(IoQueue& io, int fd, std::uint64_t size, double& busy) {
+            const size_t depth = std::min<size_t>(std::max(io.depth(), 1u), blockCount_);
+            std::vector<Block*> ready(blockCount_, nullptr); // прочитанные блоки по readIndex % blockCount_
+            std::string carry; // незаконченная последовательность UTF-8 с конца прошлого блока
+            std::uint64_t submitted = 0;
+            std::uint64_t published = 0;
+            std::uint64_t sequence = 0;
+            size_t inflight = 0;
+            bool end = size == 0;
+            for (;;) {
+                while (!end && inflight < depth) {
+                    Block* block = nullptr;
+                    if (!free_.tryPop(block)) {
+                        if (inflight > 0) break; // сначала заберём завершения
+                        for (Backoff backoff; !free_.tryPop(block); backoff.pause()) {
+                            if (aborted()) return;
+                        }
+                    }
+                    const Clock::time_point start = Clock::now();
+                    const std::uint64_t offset = submitted * blockSize_;
+                    block->readIndex = submitted++;
+                    block->got = 0;
+                    io.read(fd, block->data(), blockSize_, offset, registered_ ? block->index : -1, block);
+                    ++inflight;
+                    end = size != UNKNOWN_SIZE && offset + blockSize_ >= size;
+                    busy += since(start);
+                }
+                if (inflight == 0) break;
+
+                const Clock::time_point start = Clock::now();
+                IoQueue::Completion done = io.wait();
+                --inflight;
+                if (done.result < 0) {
+                    throw std::runtime_error(std::string("Failed to read input: ") +
+                                             std::strerror(static_cast<int>(-done.result)));
+                }
+                Block* block = static_cast<Block*>(done.tag);
+                const std::uint64_t offset = block->readIndex * blockSize_;
+                block->got += static_cast<size_t>(done.result);
+                if (block->got < blockSize_) {
+                    const bool expected = size != UNKNOWN_SIZE && offset + block->got < size;
+                    if (done.result > 0 && (size == UNKNOWN_SIZE || expected)) {
+                        // Короткое чтение не значит конец файла: дочитываем остаток блока, как pread.
+                        io.read(fd, block->data() + block->got, blockSize_ - block->got, offset + block->got,
+                                registered_ ? block->index : -1, block);
+                        ++inflight;
+                        busy += since(start);
+                        continue;
+                    }
+                    if (expected) {
+                        throw std::runtime_error("Unexpected end of input file.");
+                    }
+                    end = true; // конец потока; уже поставленные чтения вернут 0 байт
+                }
+                ready[block->readIndex % blockCount_] = block;
+                for (Block* next; (next = ready[published % blockCount_]) != nullptr;) {
+                    ready[published++ % blockCount_] = nullptr;
+                    publish(next, size, carry, sequence);
+                }
+                busy += since(start);
+            }
+
+            if (unit_ == StreamUnit::Whole && !wholeInput_.empty()) {
+                Block* block = nullptr;
+                for (Backoff backoff; !free_.tryPop(block); backoff.pause()) {
+                    if (aborted()) return;
+                }
+                block->input = wholeInput_;
+                block->sequence = sequence++;
+                block->position = 0;
+                bytesIn_ = wholeInput_.size();
+                work_.tryPush(block);
+            }
+            total_.store(sequence, std::memory_order_release);
+        }
+
+        /**
+         * @brief Передаёт прочитанный блок рабочим: дописывает перед ним хвост прошлого
+         *        блока и отрезает свой незаконченный символ (Text).
+         */
+        void publish(Block* block, std::uint64_t size, std::string& carry, std::uint64_t& sequence) {
+            if (unit_ == StreamUnit::Whole) {
+                wholeInput_.append(block->data(), block->got);
+                free_.tryPush(block);
+                return;
+            }
+            char* begin = block->data() - carry.size();
+            std::memcpy(begin, carry.data(), carry.size());
+            size_t length = carry.size() + block->got;
+            carry.clear();
+
+            const bool last = block->got < blockSize_ ||
+                              (size != UNKNOWN_SIZE && (block->readIndex + 1) * blockSize_ >= size);
+            if (unit_ == StreamUnit::Text && !last) {
+                const size_t keep = utf8CompletePrefix(std::string_view(begin, length));
+                carry.assign(begin + keep, length - keep);
+                length = keep;
+            }
+            if (length == 0) {
+                free_.tryPush(block);
+                return;
+            }
+            block->input = std::string_view(begin, length);
+            block->sequence = sequence++;
+            block->position = bytesIn_;
+            bytesIn_ += length;
+            work_.tryPush(block);
+        }
+
+        void workLoop(double& busy) {
+            std::pmr::unsynchronized_pool_resource pool;
+            for (;;) {
+                Block* block = nullptr;
+                for (Backoff backoff; !work_.tryPop(block); backoff.pause()) {
+                    if (aborted()) return;
+                }
+                if (block == nullptr) return;
+
+                Clock::time_point start = Clock::now();
+                if (unit_ == StreamUnit::Bytes) {
+                    block->output.resize(block->input.size());
+                    cipher_.applyBytes(block->input.data(), block->input.size(), &block->output[0], block->position);
+                } else {
+                    block->text.clear();
+                    appendFromUtf8(block->text, block->input);
+                    std::uint64_t keyStep = 0;
+                    if (unit_ == StreamUnit::Text) {
+                        // Шаги блока считаются параллельно; ждём только начало от предыдущего блока.
+                        const std::uint64_t steps = cipher_.keySteps(block->text);
+                        busy += since(start);
+                        for (Backoff backoff; chainSequence_.load(std::memory_order_acquire) != block->sequence;
+                             backoff.pause()) {
+                            if (aborted()) return;
+                        }
+                        start = Clock::now();
+                        keyStep = chainStart_;
+                        chainStart_ = keyStep + steps;
+                        chainSequence_.store(block->sequence + 1, std::memory_order_release);
+                    }
+                    std::pmr::wstring result = cipher_.applyAt(block->text, encrypt_, keyStep, &pool);
+                    block->output.clear();
+                    appendUtf8(block->output, result);
+                }
+                busy += since(start);
+                slots_[block->sequence % blockCount_].store(block, std::memory_order_release);
+            }
+        }
+
+        /**
+         * @brief Ставит записи готовых блоков строго по порядку, до depth «в полёте»;
+         *        недописанный остаток блока ставится повторно.
+         */
+        void writeLoop(IoQueue& io, int fd, double& busy) {
+            const size_t depth = std::min<size_t>(std::max(io.depth(), 1u), blockCount_);
+            std::uint64_t offset = 0;
+            size_t inflight = 0;
+            Backoff idle;
+            for (std::uint64_t next = 0;;) {
+                Block* block = nullptr;
+                if (inflight < depth &&
+                    (block = slots_[next % blockCount_].exchange(nullptr, std::memory_order_acquire)) != nullptr) {
+                    const Clock::time_point start = Clock::now();
+                    block->writeOffset = offset;
+                    block->written = 0;
+                    io.write(fd, block->output.data(), block->output.size(), offset, block);
+                    offset += block->output.size();
+                    bytesOut_ += block->output.size();
+                    ++next;
+                    ++inflight;
+                    busy += since(start);
+                    idle = Backoff();
+                    continue;
+                }
+                if (inflight > 0) {
+                    const Clock::time_point start = Clock::now();
+                    IoQueue::Completion done = io.wait();
+                    if (done.result < 0) {
+                        throw std::runtime_error(std::string("Failed to write output: ") +
+                                                 std::strerror(static_cast<int>(-done.result)));
+                    }
+                    Block* written = static_cast<Block*>(done.tag);
+                    written->written += static_cast<size_t>(done.result);
+                    const size_t left = written->output.size() - written->written;
+                    if (left == 0) {
+                        --inflight;
+                        free_.tryPush(written);
+                    } else if (done.result == 0) {
+                        throw std::runtime_error("Failed to write output: no progress.");
+                    } else {
+                        io.write(fd, written->output.data() + written->written, left,
+                                 written->writeOffset + written->written, written);
+                    }
+                    busy += since(start);
+                    continue;
+                }
+                if (aborted() || next >= total_.load(std::memory_order_acquire)) return;
+                idle.pause();
+            }
+        }
+
+        const PreparedCipher& cipher_;
+        const bool encrypt_;
+        const StreamUnit unit_;
+        const size_t blockSize_;
+        const size_t workers_;
+        const size_t blockCount_;
+
+        std::vector<Block> blocks_;
+        std::unique_ptr<std::atomic<Block*>[]> slots_; ///< Готовые блоки по номеру: slots_[sequence % blockCount_]
+        BoundedQueue<Block*> free_;
+        BoundedQueue<Block*> work_;
+        bool registered_ = false;
+        std::string wholeInput_; ///< Весь поток для StreamUnit::Whole
+
+        std::atomic<std::uint64_t> total_{UNKNOWN_SIZE}; ///< Число блоков; известно, когда чтение закончено
+        std::uint64_t bytesIn_ = 0;                      ///< Пишет только поток чтения
+        std::uint64_t bytesOut_ = 0;                     ///< Пишет только записывающий поток
+
+        /// Цепочка позиций ключа: блок chainSequence_ начинается с позиции chainStart_.
+        alignas(64) std::atomic<std::uint64_t> chainSequence_{0};
+        std::uint64_t chainStart_ = 0;
+
+        std::atomic<bool> aborted_{false};
+        std::mutex errorMutex_;
+        std::exception_ptr error_;
+    };
+
+#ifdef CIPHER_BLOCK_IO
+    /**
+     * @brief Дескриптор файла, закрываемый при выходе из области видимости.
+     */
+    struct FileHandle {
+        int fd = -1;
+        ~FileHandle() {
+            if (fd >= 0) ::close(fd);
+        }
+    };
+
+    std::unique_ptr<IoQueue> makeQueue(IoBackend backend, unsigned depth) {
+        std::unique_ptr<IoQueue> queue;
+        if (backend == IoBackend::Uring) {
+            queue = makeUringQueue(depth);
+        }
+        return queue ? std::move(queue) : makePreadQueue();
+    }
+#endif
+}
+
+const char* FilePipelineReport::bottleneck() const {
+    if (workersBusy >= readerBusy && workersBusy >= writerBusy) return "cipher";
+    return readerBusy >= writerBusy ? "read" : "write";
+}
+
+FilePipelineReport runFilePipeline(const PreparedCipher& cipher, bool encrypt, std::istream& in, std::ostream& out,
+                                   const FilePipelineOptions& options) {
+    FilePipelineOptions streamOptions = options;
+    streamOptions.directIo = false;
+    Pipeline pipeline(cipher, encrypt, streamOptions);
+    StreamQueue reader(&in, nullptr);
+    StreamQueue writer(nullptr, &out);
+    return pipeline.run(reader, -1, UNKNOWN_SIZE, writer, -1);
+}
+
+FilePipelineReport runFilePipelineFiles(const PreparedCipher& cipher, bool encrypt, const std::string& inPath,
+                                        const std::string& outPath, const FilePipelineOptions& options) {
+    if (options.backend == IoBackend::Stream) {
+        std::ifstream in(inPath, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Cannot open " + inPath);
+        }
+        std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot create " + outPath);
+        }
+        FilePipelineReport report = runFilePipeline(cipher, encrypt, in, out, options);
+        out.close();
+        if (!out) {
+            throw std::runtime_error("Failed to write " + outPath);
+        }
+        return report;
+    }
+
+#ifdef CIPHER_BLOCK_IO
+    FilePipelineOptions fileOptions = options;
+    FileHandle in;
+#ifdef O_DIRECT
+    if (fileOptions.directIo) {
+        in.fd = ::open(inPath.c_str(), O_RDONLY | O_DIRECT);
+        fileOptions.directIo = in.fd >= 0 || errno != EINVAL; // EINVAL: файловая система без O_DIRECT
+    }
+#else
+    fileOptions.directIo = false;
+#endif
+    if (in.fd < 0) {
+        in.fd = ::open(inPath.c_str(), O_RDONLY);
+    }
+    struct stat info;
+    if (in.fd < 0 || ::fstat(in.fd, &info) != 0) {
+        throw std::runtime_error("Cannot open " + inPath + ": " + std::strerror(errno));
+    }
+    if (!S_ISREG(info.st_mode)) {
+        throw std::runtime_error(inPath + " is not a regular file; use the stream backend.");
+    }
+    FileHandle out;
+    out.fd = ::open(outPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out.fd < 0) {
+        throw std::runtime_error("Cannot create " + outPath + ": " + std::strerror(errno));
+    }
+
+    Pipeline pipeline(cipher, encrypt, fileOptions);
+    std::unique_ptr<IoQueue> reader = makeQueue(options.backend, options.ioDepth);
+    std::unique_ptr<IoQueue> writer = makeQueue(options.backend, options.ioDepth);
+    pipeline.registerBuffers(*reader);
+    FilePipelineReport report =
+        pipeline.run(*reader, in.fd, static_cast<std::uint64_t>(info.st_size), *writer, out.fd);
+    report.directIo = fileOptions.directIo;
+    const int closed = ::close(out.fd);
+    out.fd = -1;
+    if (closed != 0) {
+        throw std::runtime_error("Failed to write " + outPath + ": " + std::strerror(errno));
+    }
+    return report;
+#else
+    (void)cipher; (void)encrypt; (void)outPath;
+    throw std::runtime_error("pread and io_uring backends need a POSIX build.");
+#endif
+}
@@ -0,0 +1,107 @@
+/**
+ * @file file_pipeline.h
+ * @brief Конвейерная обработка файлов: поток чтения, рабочие потоки шифрования и упорядоченная запись.
+ *
+ * Поток читается блоками фиксированного размера. Блоки с буферами переиспользуются:
+ * поток чтения берёт свободный блок из кольца, заполняет его и кладёт в кольцо работ;
+ * рабочие потоки шифруют блоки параллельно; записывающий поток (вызывающий) выводит
+ * их строго по порядку и возвращает в кольцо свободных. Кольца ограничены и без
+ * блокировок, поэтому чтение, шифрование и запись идут одновременно.
+ *
+ * Как резать поток, определяет PreparedCipher::streamUnit():
+ * - Text — блоки по границам символов UTF-8; позиция ключа периодических шифров
+ *   переходит из блока в блок по цепочке keySteps() (считается параллельно, ждёт
+ *   только публикация начала следующего блока);
+ * - Bytes — блоки байтов, позиция ключа равна смещению в потоке (XOR в двоичном режиме);
+ * - Whole — перестановки и шифры с кодовыми группами получают весь поток одним блоком.
+ *
+ * Чтение и запись идут через очереди IoQueue (block_io.h): для файлов — io_uring с
+ * несколькими операциями «в полёте» и зарегистрированными буферами чтения или
+ * pread/pwrite, если io_uring недоступен; для std::istream/std::ostream — обычные потоки.
+ */
+
+#ifndef FILE_PIPELINE_H
+#define FILE_PIPELINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+class PreparedCipher;
+
+/**
+ * @brief Как конвейер читает и пишет файлы.
+ */
+enum class IoBackend {
+    Stream, ///< std::ifstream / std::ofstream с буферизацией
+    Pread,  ///< pread / pwrite, одна операция за раз
+    Uring   ///< io_uring; если ядро его не поддерживает — Pread
+};
+
+/**
+ * @brief Параметры конвейера.
+ */
+struct FilePipelineOptions {
+    size_t blockSize = 1 << 20;           ///< Размер блока чтения, байт (не меньше 4)
+    size_t workers = 0;                   ///< Число рабочих потоков (0 — по числу ядер)
+    size_t blocksPerWorker = 3;           ///< Блоков в обороте на рабочий поток: читается, шифруется, пишется
+    IoBackend backend = IoBackend::Uring; ///< Ввод-вывод для файлов (runFilePipelineFiles)
+    unsigned ioDepth = 32;                ///< Операций io_uring «в полёте» на чтение и на запись
+    bool directIo = false;                ///< Читать входной файл с O_DIRECT, минуя страничный кэш
+};
+
+/**
+ * @brief Объём работы и загрузка стадий конвейера.
+ *
+ * Загрузка — доля времени работы конвейера, которую стадия действительно читала,
+ * шифровала или писала, а не ждала соседей. Стадия с наибольшей загрузкой — узкое место.
+ */
+struct FilePipelineReport {
+    std::uint64_t bytesIn = 0;      ///< Прочитано байт
+    std::uint64_t bytesOut = 0;     ///< Записано байт
+    std::uint64_t blocks = 0;       ///< Число блоков
+    size_t workers = 0;             ///< Число рабочих потоков
+    double seconds = 0.0;           ///< Время работы конвейера
+    double readerBusy = 0.0;        ///< Загрузка потока чтения (0..1)
+    double workersBusy = 0.0;       ///< Средняя загрузка рабочих потоков (0..1)
+    double writerBusy = 0.0;        ///< Загрузка записи (0..1)
+    const char* backend = "stream"; ///< Фактический ввод-вывод: "stream", "pread" или "io_uring"
+    bool registeredBuffers = false; ///< Буферы чтения зарегистрированы в io_uring
+    bool directIo = false;          ///< Вход читался с O_DIRECT
+
+    /**
+     * @brief Узкое место: "read", "cipher" или "write".
+     */
+    const char* bottleneck() const;
+};
+
+/**
+ * @brief Шифрует или дешифрует поток in в out шифром cipher.
+ *
+ * Результат совпадает с обработкой всего содержимого одним вызовом (для Text и
+ * Whole — apply() над текстом UTF-8, для Bytes — applyBytes() с позиции 0).
+ *
+ * @throw std::invalid_argument Если вход не является корректным UTF-8 (Text, Whole).
+ * @throw std::runtime_error При ошибке чтения или записи.
+ * @throw Исключения шифра; конвейер останавливается, потоки завершаются до выхода.
+ */
+FilePipelineReport runFilePipeline(const PreparedCipher& cipher, bool encrypt, std::istream& in, std::ostream& out,
+                                   const FilePipelineOptions& options = FilePipelineOptions{});
+
+/**
+ * @brief Шифрует или дешифрует файл inPath в outPath через options.backend.
+ *
+ * Stream открывает файлы потоками; Pread и Uring требуют обычного файла на входе
+ * (размер известен заранее) и POSIX. Если O_DIRECT не поддерживается файловой
+ * системой, файл читается через кэш (report.directIo == false). Выходной файл
+ * пишется через страничный кэш: длина блоков результата не кратна размеру сектора.
+ *
+ * @throw std::runtime_error Если файл не открывается или бэкенд недоступен в этой сборке.
+ * @throw Как runFilePipeline для потоков.
+ */
+FilePipelineReport runFilePipelineFiles(const PreparedCipher& cipher, bool encrypt, const std::string& inPath,
+                                        const std::string& outPath,
+                                        const FilePipelineOptions& options = FilePipelineOptions{});
+
+#endif // FILE_PIPELINE_H
@@ -1,4 +1,8 @@
 #include "gronsfeld_cipher.h"
+#include "cipher_batch.h"
+#include "metrics.h"
+#include "scratch_alloc.h"
+#include "simd_dispatch.h"
 #include <cmath>
 #include <stdexcept>
 
@@ -7,7 +11,7 @@
  * Инициализирует ключ и алфавит, нормализует ключ и проверяет корректность.
  */
 GronsfeldCipher::GronsfeldCipher(const std::vector<int>& k, const std::wstring& alph)
-    : key(k), alphabet(alph) {
+    : key(k), alphabet(alph), alphabetIndex(alph), alphabetKind(detectBuiltinAlphabet(alph)) {
     if (alphabet.empty()) {
         throw std::invalid_argument("Alphabet must not be empty.");
     }
@@ -16,6 +20,7 @@ GronsfeldCipher::GronsfeldCipher(const std::vector<int>& k, const std::wstring&
     }
     normalizeKey();
     validateKey();
+    buildShiftTables();
 }
 
 /**
@@ -38,45 +43,150 @@ void GronsfeldCipher::validateKey() {
     }
 }
 
+/**
+ * @brief Таблицы сдвигов длины 2 * key.size() + simd::MAX_LANES: вектор сдвигов для
+ * любой позиции ключа читается одной загрузкой без сборки по индексам, а текст,
+ * начинающийся с позиции ключа p, получает таблицу со смещением p.
+ */
+void GronsfeldCipher::buildShiftTables() {
+    if (alphabetKind == BuiltinAlphabet::None) {
+        return;
+    }
+    const int m = static_cast<int>(alphabet.size());
+    const size_t length = 2 * key.size() + simd::MAX_LANES;
+    encryptShifts.resize(length);
+    decryptShifts.resize(length);
+    for (size_t t = 0; t < length; ++t) {
+        int k = key[t % key.size()];
+        encryptShifts[t] = static_cast<wchar_t>(k);
+        decryptShifts[t] = static_cast<wchar_t>((m - k) % m);
+    }
+}
+
 /**
  * @brief Создает полный повторённый ключ, соответствующий длине текста.
  * @param length Длина текста.
+ * @param keyPhase Позиция ключа для первого символа.
+ * @param alloc Аллокатор для вектора ключа.
  * @return Повторённый ключ.
  */
-std::vector<int> GronsfeldCipher::createFullKey(size_t length) const {
-    std::vector<int> fullKey(length);
+template <class Alloc>
+std::vector<int, Alloc> GronsfeldCipher::createFullKey(size_t length, size_t keyPhase, const Alloc& alloc) const {
+    std::vector<int, Alloc> fullKey(length, alloc);
     for (size_t i = 0; i < length; ++i) {
-        fullKey[i] = key[i % key.size()];
+        fullKey[i] = key[(keyPhase + i) % key.size()];
     }
     return fullKey;
 }
 
 /**
- * @brief Выполняет шифрование или дешифрование текста.
- * Символы, не входящие в алфавит, не изменяются.
- * 
+ * @brief Общая реализация шифрования и дешифрования.
+ * Выбирает специализацию алфавита (EN, RU или пользовательский) и вызывает ядро.
+ *
  * @param text Входной текст.
  * @param encrypt true - шифрование, false - дешифрование.
- * @return Результат обработки.
+ * @param[out] out Строка, в которую дописывается результат.
+ * @param keyOffset Позиция ключа для первого символа.
  */
-std::wstring GronsfeldCipher::process(const std::wstring& text, bool encrypt) {
+template <class String>
+void GronsfeldCipher::processInto(std::wstring_view text, bool encrypt, String& out, std::uint64_t keyOffset) const {
     if (text.empty()) {
-        return L"";
+        return;
     }
+    dispatchAlphabet(alphabetKind, alphabetIndex, [&](const auto& alph) {
+        processWith(alph, text, encrypt, out, static_cast<size_t>(keyOffset % key.size()));
+    });
+}
 
-    std::wstring result;
-    std::vector<int> fullKey = createFullKey(text.size());
+/**
+ * @brief Ядро шифрования и дешифрования для конкретного алфавита.
+ * Символы, не входящие в алфавит, не изменяются. Для встроенных алфавитов
+ * работает векторное ядро simd::shiftContiguous; для пользовательских временный
+ * ключ выделяется тем же аллокатором, что и строка результата.
+ *
+ * @param alph Алфавит (EnAlphabet, RuAlphabet или RuntimeAlphabet).
+ * @param text Входной текст.
+ * @param encrypt true - шифрование, false - дешифрование.
+ * @param[out] out Строка, в которую дописывается результат.
+ * @param keyPhase Позиция ключа для первого символа, меньше key.size().
+ */
+template <class Alphabet, class String>
+void GronsfeldCipher::processWith(const Alphabet& alph, std::wstring_view text, bool encrypt, String& out,
+                                  size_t keyPhase) const {
+    const int m = alph.size();
+    metrics::CallScope scope(CipherKind::Gronsfeld, text.size(), out);
+    size_t passthrough = 0;
+
+    if constexpr (!std::is_same_v<Alphabet, RuntimeAlphabet>) {
+        const std::vector<wchar_t>& shifts = encrypt ? encryptShifts : decryptShifts;
+        size_t base = out.size();
+        out.resize(base + text.size());
+        passthrough = simd::shiftContiguous(text.data(), text.size(), &out[base], Alphabet::first,
+                                            Alphabet::size(), shifts.data() + keyPhase, key.size());
+        scope.passthrough(passthrough);
+        return;
+    }
+
+    out.reserve(out.size() + text.size());
+    auto fullKey = createFullKey(text.size(), keyPhase, rebind_alloc_t<String, int>(out.get_allocator()));
 
     for (size_t i = 0; i < text.size(); ++i) {
         wchar_t c = text[i];
-        size_t pos = alphabet.find(c);
-        if (pos != std::wstring::npos) {
+        int pos = alph.indexOf(c);
+        if (pos >= 0) {
             int shift = fullKey[i] * (encrypt ? 1 : -1);
-            pos = (pos + shift + alphabet.size()) % alphabet.size();
-            result += alphabet[pos];
+            out += alph.at((pos + shift + m) % m);
         } else {
-            result += c;
+            out += c;
+            ++passthrough;
         }
     }
+    scope.passthrough(passthrough);
+}
+
+/**
+ * @brief Выполняет шифрование или дешифрование текста.
+ * Символы, не входящие в алфавит, не изменяются.
+ * 
+ * @param text Входной текст.
+ * @param encrypt true - шифрование, false - дешифрование.
+ * @return Результат обработки.
+ */
+std::wstring GronsfeldCipher::process(const std::wstring& text, bool encrypt) {
+    std::wstring result;
+    processInto(text, encrypt, result);
+    return result;
+}
+
+/**
+ * @brief Выполняет шифрование или дешифрование текста в памяти вызывающего кода.
+ *
+ * @param text Входной текст.
+ * @param encrypt true - шифрование, false - дешифрование.
+ * @param mr Ресурс памяти, из которого выделяются результат и временный ключ.
+ * @param keyOffset Позиция ключа для первого символа (продолжение разрезанного текста).
+ * @return Результат обработки.
+ */
+std::pmr::wstring GronsfeldCipher::process(const std::wstring& text, bool encrypt,
+                                          std::pmr::memory_resource* mr, std::uint64_t keyOffset) const {
+    std::pmr::wstring result(mr);
+    processInto(text, encrypt, result, keyOffset);
     return result;
 }
+
+/**
+ * @brief Пакетная обработка: специализация алфавита выбирается один раз на пакет.
+ *
+ * @param texts Входные сообщения.
+ * @param encrypt true - шифрование, false - дешифрование.
+ * @param[out] out Пакет, в который дописываются результаты.
+ */
+void GronsfeldCipher::processBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const {
+    dispatchAlphabet(alphabetKind, alphabetIndex, [&](const auto& alph) {
+        out.appendEach(texts, [&](std::wstring_view text, std::pmr::wstring& data) {
+            if (!text.empty()) {
+                processWith(alph, text, encrypt, data, 0);
+            }
+        });
+    });
+}
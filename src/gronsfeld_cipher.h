@@ -1,8 +1,15 @@
 #ifndef GRONSFELD_CIPHER_H
 #define GRONSFELD_CIPHER_H
 
+#include "alphabet_traits.h"
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <memory_resource>
+
+class TextBatch;
+class CipherBatch;
 
 /**
  * @class GronsfeldCipher
@@ -12,6 +19,10 @@ class GronsfeldCipher {
 private:
     std::vector<int> key;     ///< Числовой ключ шифрования
     std::wstring alphabet;    ///< Используемый алфавит
+    AlphabetIndex alphabetIndex;  ///< Индекс символов алфавита
+    BuiltinAlphabet alphabetKind; ///< Встроенный алфавит (EN/RU) или пользовательский
+    std::vector<wchar_t> encryptShifts; ///< Периодические сдвиги для simd::shiftContiguous (встроенные алфавиты), 2 периода + MAX_LANES
+    std::vector<wchar_t> decryptShifts; ///< То же для дешифрования: (m - k) mod m
 
     /**
      * @brief Нормализует ключ по размеру алфавита.
@@ -23,12 +34,32 @@ private:
      */
     void validateKey();
 
+    /**
+     * @brief Строит таблицы сдвигов для векторного ядра (только для встроенных алфавитов).
+     */
+    void buildShiftTables();
+
     /**
      * @brief Генерирует повторённый ключ по длине текста.
      * @param length Длина текста.
+     * @param keyPhase Позиция ключа для первого символа.
+     * @param alloc Аллокатор для вектора ключа.
      * @return Вектор повторённого ключа.
      */
-    std::vector<int> createFullKey(size_t length) const;
+    template <class Alloc>
+    std::vector<int, Alloc> createFullKey(size_t length, size_t keyPhase, const Alloc& alloc) const;
+
+    /**
+     * @brief Общая реализация шифрования/дешифрования с дописыванием результата в out.
+     */
+    template <class String>
+    void processInto(std::wstring_view text, bool encrypt, String& out, std::uint64_t keyOffset = 0) const;
+
+    /**
+     * @brief Ядро шифрования для конкретной специализации алфавита.
+     */
+    template <class Alphabet, class String>
+    void processWith(const Alphabet& alph, std::wstring_view text, bool encrypt, String& out, size_t keyPhase) const;
 
 public:
     /**
@@ -45,6 +76,26 @@ public:
      * @return Результат.
      */
     std::wstring process(const std::wstring& text, bool encrypt);
+
+    /**
+     * @brief Шифрует или дешифрует текст, беря всю память (результат и ключ) из mr.
+     * @param text Входной текст.
+     * @param encrypt true - шифрование, false - дешифрование.
+     * @param mr Ресурс памяти вызывающего кода.
+     * @param keyOffset Позиция ключа для первого символа: text — продолжение текста,
+     *        первые keyOffset символов которого уже обработаны (см. file_pipeline.h).
+     * @return Результат.
+     */
+    std::pmr::wstring process(const std::wstring& text, bool encrypt, std::pmr::memory_resource* mr,
+                              std::uint64_t keyOffset = 0) const;
+
+    /**
+     * @brief Шифрует или дешифрует пакет сообщений, дописывая результаты в out (см. cipher_batch.h).
+     * @param texts Входные сообщения.
+     * @param encrypt true - шифрование, false - дешифрование.
+     * @param[out] out Пакет результатов; временные ключи берутся из его пула.
+     */
+    void processBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const;
 };
 
 #endif // GRONSFELD_CIPHER_H
@@ -0,0 +1,134 @@
+/**
+ * @file gronsfeld_key_solver.cpp
+ * @brief Реализация подбора ключа Гронсфельда: оценка сдвигов столбцов и перебор лучших ключей.
+ */
+
+#include "gronsfeld_key_solver.h"
+#include "alphabet_traits.h"
+#include "letter_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+
+namespace
+{
+    using KeyStep = LetterHistogram::KeyStep;
+
+    /**
+     * @brief Ключ в очереди перебора: ранги сдвигов по столбцам и потеря относительно лучшего ключа.
+     */
+    struct RankedKey {
+        double loss;
+        size_t last;              ///< Столбцы левее не меняются у потомков
+        std::vector<size_t> ranks;
+
+        bool operator>(const RankedKey& other) const { return loss > other.loss; }
+    };
+
+    /**
+     * @brief Общая часть solve и solveUtf8: гистограммы уже посчитаны.
+     */
+    std::vector<GronsfeldKeyCandidate> solveHistogram(const std::vector<uint64_t>& histogram,
+                                                      const std::wstring& alphabet, size_t period,
+                                                      FrequencyScore method, size_t top, int shifts)
+    {
+        return GronsfeldKeySolver::rankKeys(
+            GronsfeldKeySolver::columnScores(histogram, period, alphabet, method, shifts), period, method, top);
+    }
+}
+
+std::vector<double> GronsfeldKeySolver::columnScores(const std::vector<uint64_t>& histogram, size_t period,
+                                                     const std::wstring& alphabet, FrequencyScore method,
+                                                     int shifts) {
+    FrequencyScorer scorer(LetterFrequency::forAlphabet(alphabet), method);
+    if (shifts <= 0) {
+        throw std::invalid_argument("Shift count must be positive.");
+    }
+    if (period == 0 || histogram.size() != period * LetterHistogram::BIN_COUNT) {
+        throw std::invalid_argument("Histogram size does not match the period.");
+    }
+    const int m = static_cast<int>(scorer.size());
+    const int n = std::min(shifts, m);
+    const int first = LetterHistogram::firstBin(detectBuiltinAlphabet(alphabet));
+
+    // Для сдвига k буква x открытого текста лежит в корзине (x + k) mod m.
+    std::vector<std::vector<int>> maps(n, std::vector<int>(m));
+    for (int k = 0; k < n; ++k) {
+        for (int x = 0; x < m; ++x) maps[k][x] = (x + k) % m;
+    }
+
+    std::vector<double> scores(period * n);
+    for (size_t c = 0; c < period; ++c) {
+        const uint64_t* counts = &histogram[c * LetterHistogram::BIN_COUNT + first];
+        const uint64_t total = std::accumulate(counts, counts + m, uint64_t(0));
+        for (int k = 0; k < n; ++k) scores[c * n + k] = scorer(counts, maps[k].data(), total);
+    }
+    return scores;
+}
+
+std::vector<GronsfeldKeyCandidate> GronsfeldKeySolver::rankKeys(const std::vector<double>& scores, size_t period,
+                                                                FrequencyScore method, size_t top) {
+    if (period == 0 || scores.empty() || scores.size() % period != 0) {
+        throw std::invalid_argument("Score count does not match the period.");
+    }
+    const size_t n = scores.size() / period;
+    const bool lowerIsBetter = method == FrequencyScore::ChiSquared;
+
+    // shiftsByRank[c * n + r] — сдвиг столбца c с рангом r; loss — насколько он хуже лучшего.
+    std::vector<size_t> shiftsByRank(scores.size());
+    std::vector<double> loss(scores.size());
+    for (size_t c = 0; c < period; ++c) {
+        const double* column = &scores[c * n];
+        size_t* order = &shiftsByRank[c * n];
+        std::iota(order, order + n, size_t(0));
+        std::stable_sort(order, order + n, [&](size_t a, size_t b) {
+            return lowerIsBetter ? column[a] < column[b] : column[a] > column[b];
+        });
+        for (size_t r = 0; r < n; ++r) loss[c * n + r] = std::abs(column[order[r]] - column[order[0]]);
+    }
+
+    std::vector<GronsfeldKeyCandidate> candidates;
+    std::priority_queue<RankedKey, std::vector<RankedKey>, std::greater<RankedKey>> queue;
+    queue.push({0.0, 0, std::vector<size_t>(period, 0)});
+    while (!queue.empty() && candidates.size() < top) {
+        RankedKey current = queue.top();
+        queue.pop();
+
+        GronsfeldKeyCandidate candidate{std::vector<int>(period), 0.0};
+        for (size_t c = 0; c < period; ++c) {
+            const size_t shift = shiftsByRank[c * n + current.ranks[c]];
+            candidate.key[c] = static_cast<int>(shift);
+            candidate.score += scores[c * n + shift];
+        }
+        candidates.push_back(std::move(candidate));
+
+        for (size_t c = current.last; c < period; ++c) {
+            const size_t r = current.ranks[c];
+            if (r + 1 == n) continue;
+            RankedKey next{current.loss + loss[c * n + r + 1] - loss[c * n + r], c, current.ranks};
+            ++next.ranks[c];
+            queue.push(std::move(next));
+        }
+    }
+    return candidates;
+}
+
+std::vector<GronsfeldKeyCandidate> GronsfeldKeySolver::solve(std::wstring_view ciphertext,
+                                                             const std::wstring& alphabet, size_t period,
+                                                             FrequencyScore method, size_t top, int shifts) {
+    LetterFrequency::forAlphabet(alphabet); // проверка алфавита до прохода по тексту
+    auto histogram = LetterHistogram::periodic(ciphertext, period, KeyStep::EveryChar,
+                                               LetterHistogram::LetterCase::UpperOnly);
+    return solveHistogram(histogram, alphabet, period, method, top, shifts);
+}
+
+std::vector<GronsfeldKeyCandidate> GronsfeldKeySolver::solveUtf8(std::string_view ciphertext,
+                                                                 const std::wstring& alphabet, size_t period,
+                                                                 FrequencyScore method, size_t top, int shifts) {
+    LetterFrequency::forAlphabet(alphabet);
+    auto histogram = LetterHistogram::periodicUtf8(ciphertext, period, KeyStep::EveryChar,
+                                                   LetterHistogram::LetterCase::UpperOnly);
+    return solveHistogram(histogram, alphabet, period, method, top, shifts);
+}
@@ -0,0 +1,93 @@
+/**
+ * @file gronsfeld_key_solver.h
+ * @brief Заголовочный файл для класса GronsfeldKeySolver — подбор ключа шифра Гронсфельда известного периода.
+ */
+
+#ifndef GRONSFELD_KEY_SOLVER_H
+#define GRONSFELD_KEY_SOLVER_H
+
+#include "letter_frequency.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Кандидат ключа шифра Гронсфельда.
+ */
+struct GronsfeldKeyCandidate {
+    std::vector<int> key; ///< Сдвиг каждой позиции ключа
+    double score;         ///< Сумма оценок столбцов (смысл зависит от FrequencyScore)
+};
+
+/**
+ * @class GronsfeldKeySolver
+ * @brief Восстановление ключа GronsfeldCipher по частотам букв, когда период известен.
+ *
+ * Каждая позиция ключа — сдвиг Цезаря своего столбца. Гистограммы всех столбцов
+ * считаются за один проход LetterHistogram::periodic (по тем же правилам, что и
+ * GronsfeldCipher: позицию ключа занимает каждый символ, сдвигаются только
+ * прописные буквы алфавита). Затем каждый сдвиг каждого столбца оценивается
+ * перестановкой корзин гистограммы, без расшифровки текста.
+ *
+ * Оценки столбцов независимы, поэтому лучший ключ — лучшие сдвиги по столбцам,
+ * а следующие ключи перебираются по возрастанию суммарной потери относительно
+ * лучшего: из очереди берётся ключ с наименьшей потерей и порождает ключи с
+ * заменой сдвига на следующий по рангу в одном из столбцов не левее последнего
+ * изменённого (каждый ключ порождается ровно один раз).
+ */
+class GronsfeldKeySolver {
+public:
+    static constexpr int DIGIT_SHIFTS = 10; ///< Ключ из цифр: сдвиги 0–9
+
+    /**
+     * @brief Оценки всех сдвигов всех столбцов по готовым гистограммам.
+     * @param histogram Результат LetterHistogram::periodic (period * BIN_COUNT счётчиков).
+     * @param period Период ключа.
+     * @param alphabet Алфавит (EN_ALPHABET или RU_ALPHABET).
+     * @param method Способ оценки.
+     * @param shifts Сколько сдвигов проверять (не больше размера алфавита).
+     * @return period * min(shifts, m) оценок; сдвиг k столбца c — элемент c * min(shifts, m) + k.
+     * @throw std::invalid_argument Если для алфавита нет эталонных частот, shifts <= 0
+     *        или размер гистограммы не совпадает с периодом.
+     */
+    static std::vector<double> columnScores(const std::vector<uint64_t>& histogram, size_t period,
+                                            const std::wstring& alphabet, FrequencyScore method, int shifts);
+
+    /**
+     * @brief Лучшие ключи по оценкам столбцов.
+     * @param scores Результат columnScores.
+     * @param period Период ключа.
+     * @param method Способ оценки (какие оценки лучше).
+     * @param top Сколько ключей вернуть.
+     * @return Кандидаты, упорядоченные от лучшего к худшему.
+     */
+    static std::vector<GronsfeldKeyCandidate> rankKeys(const std::vector<double>& scores, size_t period,
+                                                       FrequencyScore method, size_t top);
+
+    /**
+     * @brief Восстанавливает ключ по шифртексту.
+     * @param ciphertext Шифртекст.
+     * @param alphabet Алфавит (EN_ALPHABET или RU_ALPHABET).
+     * @param period Период ключа.
+     * @param method Способ оценки.
+     * @param top Сколько лучших кандидатов вернуть.
+     * @param shifts Сколько сдвигов проверять: 10 для ключа из цифр, размер алфавита — для любого ключа.
+     * @return Кандидаты, упорядоченные от лучшего к худшему.
+     * @throw std::invalid_argument Если для алфавита нет эталонных частот, period == 0 или shifts <= 0.
+     */
+    static std::vector<GronsfeldKeyCandidate> solve(std::wstring_view ciphertext, const std::wstring& alphabet,
+                                                    size_t period,
+                                                    FrequencyScore method = FrequencyScore::ChiSquared,
+                                                    size_t top = 5, int shifts = DIGIT_SHIFTS);
+
+    /**
+     * @brief То же для шифртекста в UTF-8 (файл не декодируется целиком, см. LetterHistogram::periodicUtf8).
+     */
+    static std::vector<GronsfeldKeyCandidate> solveUtf8(std::string_view ciphertext, const std::wstring& alphabet,
+                                                        size_t period,
+                                                        FrequencyScore method = FrequencyScore::ChiSquared,
+                                                        size_t top = 5, int shifts = DIGIT_SHIFTS);
+};
+
+#endif // GRONSFELD_KEY_SOLVER_H
@@ -0,0 +1,82 @@
+/**
+ * @file letter_frequency.cpp
+ * @brief Реализация эталонных частот и функций оценки гистограмм.
+ */
+
+#include "letter_frequency.h"
+#include "alphabet_traits.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace
+{
+    constexpr double MIN_PROBABILITY = 1e-6; ///< Нижняя граница вероятности для логарифма
+
+    /**
+     * @brief Нормирует проценты так, чтобы сумма была равна 1.
+     */
+    std::vector<double> normalize(std::vector<double> percents)
+    {
+        double sum = std::accumulate(percents.begin(), percents.end(), 0.0);
+        for (double& p : percents) {
+            p /= sum;
+        }
+        return percents;
+    }
+}
+
+const std::vector<double>& LetterFrequency::english() {
+    static const std::vector<double> freq = normalize({
+        8.167, 1.492, 2.782, 4.253, 12.702, 2.228, 2.015, 6.094, 6.966, 0.153, 0.772, 4.025, 2.406,
+        6.749, 7.507, 1.929, 0.095, 5.987, 6.327, 9.056, 2.758, 0.978, 2.360, 0.150, 1.974, 0.074});
+    return freq;
+}
+
+const std::vector<double>& LetterFrequency::russian() {
+    static const std::vector<double> freq = normalize({
+        8.01, 1.59, 4.54, 1.70, 2.98, 8.49, 0.94, 1.65, 7.35, 1.21, 3.49, 4.40, 3.21, 6.70, 10.97, 2.81,
+        4.73, 5.47, 6.26, 2.62, 0.26, 0.97, 0.48, 1.44, 0.73, 0.36, 0.04, 1.90, 1.74, 0.32, 0.64, 2.01});
+    return freq;
+}
+
+const std::vector<double>& LetterFrequency::forAlphabet(const std::wstring& alphabet) {
+    switch (detectBuiltinAlphabet(alphabet)) {
+    case BuiltinAlphabet::English:
+        return english();
+    case BuiltinAlphabet::Russian:
+        return russian();
+    default:
+        break;
+    }
+    throw std::invalid_argument("No reference letter frequencies for this alphabet.");
+}
+
+FrequencyScorer::FrequencyScorer(const std::vector<double>& reference, FrequencyScore method)
+    : reference_(reference), method_(method) {
+    if (reference_.empty()) {
+        throw std::invalid_argument("Reference distribution must not be empty.");
+    }
+    logReference_.reserve(reference_.size());
+    for (double p : reference_) {
+        logReference_.push_back(std::log(std::max(p, MIN_PROBABILITY)));
+    }
+}
+
+double FrequencyScorer::operator()(const uint64_t* counts, const int* map, uint64_t total) const {
+    const size_t m = reference_.size();
+    double result = 0.0;
+    if (method_ == FrequencyScore::ChiSquared) {
+        for (size_t x = 0; x < m; ++x) {
+            double expected = std::max(reference_[x] * static_cast<double>(total), MIN_PROBABILITY);
+            double diff = static_cast<double>(counts[map[x]]) - expected;
+            result += diff * diff / expected;
+        }
+    } else {
+        for (size_t x = 0; x < m; ++x) {
+            result += static_cast<double>(counts[map[x]]) * logReference_[x];
+        }
+    }
+    return result;
+}
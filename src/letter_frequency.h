@@ -0,0 +1,91 @@
+/**
+ * @file letter_frequency.h
+ * @brief Эталонные частоты букв английского и русского языков и функции сравнения гистограмм.
+ */
+
+#ifndef LETTER_FREQUENCY_H
+#define LETTER_FREQUENCY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Способ оценки близости гистограммы шифртекста к эталонному распределению.
+ */
+enum class FrequencyScore {
+    ChiSquared,     ///< Критерий хи-квадрат: чем меньше, тем лучше
+    LogLikelihood   ///< Логарифм правдоподобия: чем больше, тем лучше
+};
+
+/**
+ * @class LetterFrequency
+ * @brief Эталонные распределения букв для EN_ALPHABET (A–Z) и RU_ALPHABET (А–Я без Ё).
+ */
+class LetterFrequency {
+public:
+    /**
+     * @brief Частоты букв английского языка в порядке A–Z (сумма равна 1).
+     */
+    static const std::vector<double>& english();
+
+    /**
+     * @brief Частоты букв русского языка в порядке А–Я без Ё (сумма равна 1).
+     *
+     * Частота Ё добавлена к Е.
+     */
+    static const std::vector<double>& russian();
+
+    /**
+     * @brief Эталонное распределение для встроенного алфавита.
+     * @param alphabet Алфавит (EN_ALPHABET или RU_ALPHABET).
+     * @return Частоты в порядке символов алфавита.
+     * @throw std::invalid_argument Если для алфавита нет эталонных частот.
+     */
+    static const std::vector<double>& forAlphabet(const std::wstring& alphabet);
+};
+
+/**
+ * @class FrequencyScorer
+ * @brief Оценка гистограммы шифртекста относительно эталонного распределения.
+ *
+ * Позволяет оценить ключ подстановки, не расшифровывая текст:
+ * достаточно переставить корзины гистограммы шифртекста.
+ */
+class FrequencyScorer {
+public:
+    /**
+     * @brief Конструктор.
+     * @param reference Эталонное распределение букв открытого текста.
+     * @param method Способ оценки.
+     */
+    FrequencyScorer(const std::vector<double>& reference, FrequencyScore method);
+
+    /**
+     * @brief Оценка гистограммы, у которой буква x открытого текста взята из корзины map[x].
+     * @param counts Гистограмма шифртекста.
+     * @param map Отображение индекса буквы открытого текста в индекс корзины (size() элементов).
+     * @param total Общее число букв в гистограмме.
+     * @return Значение оценки (для ChiSquared — меньше лучше, для LogLikelihood — больше лучше).
+     */
+    double operator()(const uint64_t* counts, const int* map, uint64_t total) const;
+
+    /**
+     * @brief true, если оценка a лучше оценки b.
+     */
+    bool better(double a, double b) const {
+        return method_ == FrequencyScore::ChiSquared ? a < b : a > b;
+    }
+
+    /**
+     * @brief Размер алфавита эталонного распределения.
+     */
+    size_t size() const { return reference_.size(); }
+
+private:
+    std::vector<double> reference_;     ///< Эталонные вероятности
+    std::vector<double> logReference_;  ///< Логарифмы эталонных вероятностей
+    FrequencyScore method_;
+};
+
+#endif // LETTER_FREQUENCY_H
@@ -0,0 +1,306 @@
+/**
+ * @file letter_histogram.cpp
+ * @brief Реализация подсчёта букв: векторная классификация, частные таблицы потоков и слияние.
+ */
+
+#include "letter_histogram.h"
+#include "simd_dispatch.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cwchar>
+#include <cwctype>
+#include <stdexcept>
+
+namespace
+{
+    using KeyStep = LetterHistogram::KeyStep;
+    using LetterCase = LetterHistogram::LetterCase;
+
+    constexpr size_t PARALLEL_THRESHOLD = 1 << 20; ///< С какой длины текста подсчёт идёт в несколько потоков
+    constexpr size_t BLOCK = 4096;                 ///< Символов, классифицируемых за раз (буфер на стеке)
+    constexpr size_t STRIDE = 128;                 ///< Счётчиков на столбец частной таблицы (прописные и строчные)
+    constexpr size_t COPIES = 4;                   ///< Сколько соседних позиций ключа считаются в разные таблицы
+    constexpr int BIN_LETTER = 60;                 ///< Буква вне EN/RU (iswalpha): не считается, но занимает позицию
+    constexpr int BIN_NONE = 61;                   ///< Байт UTF-8, не начинающий символа: не занимает позиции
+    constexpr int BIN_DECODE = 63;                 ///< Начало другого символа UTF-8: решает iswalpha после декодирования
+
+    /// Состояние разбора UTF-8: предыдущий байт — не D0/D1, D0 или D1 (начало А–п или р–я).
+    enum Utf8State { PLAIN = 0, AFTER_D0 = 1, AFTER_D1 = 2, UTF8_STATES = 3 };
+
+    /**
+     * @brief Корзина символа, который не взяло векторное ядро (строчные — плюс LETTER_BIN_LOWER).
+     */
+    int classify(wchar_t c)
+    {
+        constexpr int LOWER = simd::LETTER_BIN_LOWER;
+        if (c >= L'A' && c <= L'Z') return c - L'A';
+        if (c >= L'a' && c <= L'z') return LOWER + (c - L'a');
+        if (c >= L'А' && c <= L'Я') return LetterHistogram::LATIN_SIZE + (c - L'А');
+        if (c >= L'а' && c <= L'я') return LOWER + LetterHistogram::LATIN_SIZE + (c - L'а');
+        if (c == L' ') return simd::LETTER_BIN_SPACE;
+        if (c < 0x80 || !iswalpha(c)) return simd::LETTER_BIN_OTHER;
+        return BIN_LETTER;
+    }
+
+    /**
+     * @brief Корзины блока: векторное ядро, а где оно остановилось — скалярно до конца вектора.
+     */
+    void classifyBlock(const wchar_t* in, size_t length, wchar_t* bins)
+    {
+        size_t i = 0;
+        while (i < length) {
+            i += simd::letterBins(in + i, length - i, bins + i);
+            const size_t stop = std::min(length, i + simd::MAX_LANES);
+            for (; i < stop; ++i) bins[i] = static_cast<wchar_t>(classify(in[i]));
+        }
+    }
+
+    /**
+     * @brief Декодирует символ UTF-8, начинающийся в p; некорректная последовательность даёт U+FFFD.
+     */
+    char32_t decodeAt(const unsigned char* p, const unsigned char* end)
+    {
+        const unsigned char lead = *p;
+        const size_t extra = (lead & 0xE0) == 0xC0 ? 1 : (lead & 0xF0) == 0xE0 ? 2 : (lead & 0xF8) == 0xF0 ? 3 : 0;
+        if (extra == 0 || static_cast<size_t>(end - p) <= extra) return 0xFFFD;
+        char32_t cp = lead & (0x3F >> extra);
+        for (size_t k = 1; k <= extra; ++k) {
+            if ((p[k] & 0xC0) != 0x80) return 0xFFFD;
+            cp = (cp << 6) | (p[k] & 0x3F);
+        }
+        return cp;
+    }
+
+    /**
+     * @brief Частные таблицы одного потока.
+     *
+     * UTF-8 не декодируется: корзина байта берётся из таблицы по байту и по тому,
+     * был ли предыдущий байт началом кириллической буквы (D0 или D1). Второй байт
+     * такой буквы даёт её корзину, ASCII — свою, первый байт остальных символов —
+     * LETTER_BIN_OTHER (для LettersAndSpaces символ декодируется ради iswalpha),
+     * все прочие байты — BIN_NONE.
+     *
+     * Строчные буквы считаются в свои корзины (плюс LETTER_BIN_LOWER) и
+     * добавляются к прописным только при слиянии, если регистр не учитывается.
+     *
+     * Позиция ключа t считается в столбец t mod virtualPeriod, где virtualPeriod —
+     * кратное периода не меньше COPIES: при малом периоде одна и та же корзина
+     * соседних символов лежит в разных таблицах. При слиянии столбцы сворачиваются
+     * по модулю периода и сдвигаются на позицию ключа начала части текста.
+     */
+    class ColumnCounter {
+    public:
+        ColumnCounter(size_t period, KeyStep step)
+            : period_(period),
+              virtualPeriod_(period * ((COPIES + period - 1) / period)),
+              counts_(virtualPeriod_ * STRIDE, 0)
+        {
+            const bool cyrillicLetters = step == KeyStep::EveryChar || iswalpha(L'Я');
+            for (size_t b = 0; b < STRIDE; ++b) {
+                bool advances = step == KeyStep::EveryChar;
+                if (b < static_cast<size_t>(LetterHistogram::LATIN_SIZE)) advances = true;
+                else if (b < static_cast<size_t>(LetterHistogram::BIN_COUNT)) advances = cyrillicLetters;
+                else if (b == simd::LETTER_BIN_SPACE || b == BIN_LETTER) advances = true;
+                else if (b == BIN_NONE) advances = false;
+                else if (b >= static_cast<size_t>(simd::LETTER_BIN_LOWER)) advances = advance_[b - simd::LETTER_BIN_LOWER] != 0;
+                advance_[b] = advances ? STRIDE : 0;
+            }
+            buildUtf8Tables(step);
+        }
+
+        void add(const wchar_t* text, size_t length)
+        {
+            wchar_t bins[BLOCK];
+            for (size_t pos = 0; pos < length; pos += BLOCK) {
+                const size_t n = std::min(BLOCK, length - pos);
+                classifyBlock(text + pos, n, bins);
+                countBins(bins, n);
+            }
+        }
+
+        void addUtf8(const char* text, size_t length)
+        {
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(text);
+            const unsigned char* end = p + length;
+            uint64_t* counts = counts_.data();
+            const size_t last = virtualPeriod_ * STRIDE;
+            size_t offset = offset_;
+            unsigned state = PLAIN;
+            for (; p != end; ++p) {
+                size_t bin = utf8Bins_[state][*p];
+                state = utf8Next_[*p];
+                if (bin == BIN_DECODE) {
+                    const char32_t cp = decodeAt(p, end);
+                    bin = static_cast<size_t>(classify(cp <= WCHAR_MAX ? static_cast<wchar_t>(cp) : L'\uFFFD'));
+                }
+                ++counts[offset + bin];
+                offset += advance_[bin];
+                if (offset == last) offset = 0;
+            }
+            offset_ = offset;
+        }
+
+        /**
+         * @brief Сколько позиций ключа заняла часть текста (сумма продвигающих корзин).
+         */
+        uint64_t steps() const
+        {
+            uint64_t total = 0;
+            for (size_t vc = 0; vc < virtualPeriod_; ++vc) {
+                for (size_t b = 0; b < STRIDE; ++b) {
+                    if (advance_[b]) total += counts_[vc * STRIDE + b];
+                }
+            }
+            return total;
+        }
+
+        /**
+         * @brief Прибавляет буквы к result; первый символ части занимает позицию ключа firstPosition.
+         */
+        void mergeInto(std::vector<uint64_t>& result, uint64_t firstPosition, LetterCase letterCase) const
+        {
+            const size_t shift = static_cast<size_t>(firstPosition % period_);
+            for (size_t vc = 0; vc < virtualPeriod_; ++vc) {
+                uint64_t* column = &result[(vc % period_ + shift) % period_ * LetterHistogram::BIN_COUNT];
+                const uint64_t* local = &counts_[vc * STRIDE];
+                for (int b = 0; b < LetterHistogram::BIN_COUNT; ++b) column[b] += local[b];
+                if (letterCase == LetterCase::Fold) {
+                    const uint64_t* lower = local + simd::LETTER_BIN_LOWER;
+                    for (int b = 0; b < LetterHistogram::BIN_COUNT; ++b) column[b] += lower[b];
+                }
+            }
+        }
+
+    private:
+        void buildUtf8Tables(KeyStep step)
+        {
+            for (int b = 0; b < 256; ++b) {
+                unsigned char bin;
+                if (b < 0x80) bin = static_cast<unsigned char>(classify(static_cast<wchar_t>(b)));
+                else if ((b & 0xC0) == 0x80 || b == 0xD0 || b == 0xD1) bin = BIN_NONE;
+                else bin = step == KeyStep::EveryChar ? simd::LETTER_BIN_OTHER : BIN_DECODE;
+                for (int s = 0; s < UTF8_STATES; ++s) utf8Bins_[s][b] = bin;
+                utf8Next_[b] = b == 0xD0 ? AFTER_D0 : b == 0xD1 ? AFTER_D1 : PLAIN;
+            }
+            // Вторые байты: D0 80–BF — U+0400–U+043F, D1 80–BF — U+0440–U+047F.
+            for (int b = 0x80; b < 0xC0; ++b) {
+                utf8Bins_[AFTER_D0][b] = static_cast<unsigned char>(classify(static_cast<wchar_t>(0x400 + (b & 0x3F))));
+                utf8Bins_[AFTER_D1][b] = static_cast<unsigned char>(classify(static_cast<wchar_t>(0x440 + (b & 0x3F))));
+            }
+        }
+
+        void countBins(const wchar_t* bins, size_t length)
+        {
+            uint64_t* counts = counts_.data();
+            const size_t end = virtualPeriod_ * STRIDE;
+            size_t offset = offset_;
+            for (size_t i = 0; i < length; ++i) {
+                const size_t bin = static_cast<size_t>(bins[i]);
+                ++counts[offset + bin];
+                offset += advance_[bin];
+                if (offset == end) offset = 0;
+            }
+            offset_ = offset;
+        }
+
+        size_t period_;
+        size_t virtualPeriod_;
+        std::vector<uint64_t> counts_; ///< virtualPeriod_ столбцов по STRIDE счётчиков
+        size_t advance_[STRIDE];       ///< STRIDE, если корзина занимает позицию ключа, иначе 0
+        size_t offset_ = 0;            ///< Начало текущего столбца в counts_
+        unsigned char utf8Bins_[UTF8_STATES][256]; ///< Корзина байта UTF-8 по состоянию разбора
+        unsigned char utf8Next_[256];              ///< Состояние после байта
+    };
+
+    /// Граница части текста: wchar_t режется где угодно.
+    size_t boundary(std::wstring_view, size_t pos)
+    {
+        return pos;
+    }
+
+    /// Граница части текста в UTF-8: не внутри последовательности.
+    size_t boundary(std::string_view text, size_t pos)
+    {
+        for (int k = 0; k < 3 && pos < text.size() && (static_cast<unsigned char>(text[pos]) & 0xC0) == 0x80; ++k) {
+            ++pos;
+        }
+        return pos;
+    }
+
+    void addPart(ColumnCounter& counter, std::wstring_view text)
+    {
+        counter.add(text.data(), text.size());
+    }
+
+    void addPart(ColumnCounter& counter, std::string_view text)
+    {
+        counter.addUtf8(text.data(), text.size());
+    }
+
+    /**
+     * @brief Общая часть для wchar_t и UTF-8: части текста по потокам пула, затем слияние по порядку.
+     */
+    template <class View>
+    std::vector<uint64_t> countColumns(View text, size_t period, KeyStep step, LetterCase letterCase)
+    {
+        if (period == 0) {
+            throw std::invalid_argument("Period must be positive.");
+        }
+        std::vector<uint64_t> result(period * LetterHistogram::BIN_COUNT, 0);
+
+        ThreadPool& pool = ThreadPool::shared();
+        const size_t parts = text.size() < PARALLEL_THRESHOLD ? 1 : pool.concurrency();
+        if (parts == 1) {
+            ColumnCounter counter(period, step);
+            addPart(counter, text);
+            counter.mergeInto(result, 0, letterCase);
+            return result;
+        }
+
+        std::vector<View> views;
+        size_t chunk = (text.size() + parts - 1) / parts;
+        size_t begin = 0;
+        for (size_t t = 0; t < parts; ++t) {
+            size_t end = t + 1 == parts ? text.size() : boundary(text, std::min(text.size(), begin + chunk));
+            views.push_back(text.substr(begin, end - begin));
+            begin = end;
+        }
+        std::vector<ColumnCounter> counters(parts, ColumnCounter(period, step));
+        pool.parallelFor(0, parts, 1, [&](size_t first, size_t last) {
+            for (size_t t = first; t < last; ++t) addPart(counters[t], views[t]);
+        });
+
+        uint64_t position = 0;
+        for (const ColumnCounter& counter : counters) {
+            counter.mergeInto(result, position, letterCase);
+            position += counter.steps();
+        }
+        return result;
+    }
+}
+
+int LetterHistogram::firstBin(BuiltinAlphabet alphabet) {
+    switch (alphabet) {
+    case BuiltinAlphabet::English: return 0;
+    case BuiltinAlphabet::Russian: return LATIN_SIZE;
+    default: throw std::invalid_argument("Alphabet has no letter histogram bins.");
+    }
+}
+
+std::vector<uint64_t> LetterHistogram::count(std::wstring_view text) {
+    return countColumns(text, 1, KeyStep::EveryChar, LetterCase::Fold);
+}
+
+std::vector<uint64_t> LetterHistogram::countUtf8(std::string_view text) {
+    return countColumns(text, 1, KeyStep::EveryChar, LetterCase::Fold);
+}
+
+std::vector<uint64_t> LetterHistogram::periodic(std::wstring_view text, size_t period, KeyStep step,
+                                                LetterCase letterCase) {
+    return countColumns(text, period, step, letterCase);
+}
+
+std::vector<uint64_t> LetterHistogram::periodicUtf8(std::string_view text, size_t period, KeyStep step,
+                                                    LetterCase letterCase) {
+    return countColumns(text, period, step, letterCase);
+}
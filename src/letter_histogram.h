@@ -0,0 +1,94 @@
+/**
+ * @file letter_histogram.h
+ * @brief Заголовочный файл для класса LetterHistogram — гистограммы букв EN и RU для больших текстов.
+ */
+
+#ifndef LETTER_HISTOGRAM_H
+#define LETTER_HISTOGRAM_H
+
+#include "alphabet_traits.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class LetterHistogram
+ * @brief Подсчёт букв EN_ALPHABET и RU_ALPHABET, в том числе по столбцам периодического ключа.
+ *
+ * Корзины совпадают с VigenereAnalysis::letterBin: 0–25 — буквы EN_ALPHABET,
+ * 26–57 — буквы RU_ALPHABET, регистр не учитывается (или строчные не считаются, см.
+ * LetterCase); остальные символы не считаются.
+ *
+ * Символы классифицируются векторным ядром simd::letterBins (ASCII и А–я) и
+ * скалярно для остальных. Каждая часть текста считается в свои таблицы; соседние позиции
+ * ключа попадают в разные копии таблицы (не меньше четырёх), чтобы подряд идущие
+ * одинаковые буквы не ждали записи одного счётчика. Копии и части складываются в конце.
+ * Длинные тексты считаются параллельно по частям в общем пуле (ThreadPool::shared());
+ * столбец, с которого начинается часть, учитывается при слиянии, поэтому второго
+ * прохода не нужно.
+ */
+class LetterHistogram {
+public:
+    static constexpr int LATIN_SIZE = 26;                         ///< Корзины EN_ALPHABET
+    static constexpr int CYRILLIC_SIZE = 32;                      ///< Корзины RU_ALPHABET
+    static constexpr int BIN_COUNT = LATIN_SIZE + CYRILLIC_SIZE;  ///< Всего корзин
+
+    /**
+     * @brief Какие символы занимают позицию ключа (переводят подсчёт в следующий столбец).
+     */
+    enum class KeyStep {
+        EveryChar,       ///< Каждый символ (GronsfeldCipher)
+        LettersAndSpaces ///< Буквы (iswalpha) и пробелы (VigenereCipher)
+    };
+
+    /**
+     * @brief Какие буквы считаются.
+     */
+    enum class LetterCase {
+        Fold,     ///< Строчные и прописные в одной корзине (VigenereCipher, AffineCipher)
+        UpperOnly ///< Только прописные: GronsfeldCipher не сдвигает строчные, они лишь занимают позицию ключа
+    };
+
+    /**
+     * @brief Первая корзина встроенного алфавита: 0 для English, LATIN_SIZE для Russian.
+     * @throw std::invalid_argument Для BuiltinAlphabet::None.
+     */
+    static int firstBin(BuiltinAlphabet alphabet);
+
+    /**
+     * @brief Гистограмма букв текста.
+     * @return BIN_COUNT счётчиков.
+     */
+    static std::vector<uint64_t> count(std::wstring_view text);
+
+    /**
+     * @brief Гистограмма букв текста в UTF-8.
+     *
+     * Текст не декодируется: байты классифицируются по таблице с учётом предыдущего
+     * байта (начало кириллической буквы или нет). В некорректном UTF-8 буквы считаются
+     * так же, но позиции ключа после ошибочных байтов не определены.
+     *
+     * @return BIN_COUNT счётчиков.
+     */
+    static std::vector<uint64_t> countUtf8(std::string_view text);
+
+    /**
+     * @brief Гистограммы столбцов: буквы, зашифрованные t-й позицией ключа, попадают в столбец t mod period.
+     * @param text Текст.
+     * @param period Период ключа.
+     * @param step Какие символы занимают позицию ключа.
+     * @param letterCase Какие буквы считаются.
+     * @return period * BIN_COUNT счётчиков; столбец c начинается с элемента c * BIN_COUNT.
+     * @throw std::invalid_argument Если period равен нулю.
+     */
+    static std::vector<uint64_t> periodic(std::wstring_view text, size_t period, KeyStep step,
+                                          LetterCase letterCase = LetterCase::Fold);
+
+    /**
+     * @brief То же для текста в UTF-8 (позицию ключа занимают символы, а не байты).
+     */
+    static std::vector<uint64_t> periodicUtf8(std::string_view text, size_t period, KeyStep step,
+                                              LetterCase letterCase = LetterCase::Fold);
+};
+
+#endif // LETTER_HISTOGRAM_H
@@ -17,9 +17,7 @@
 #include "polybius_cipher.h"
 #include "affine_cipher.h"
 #include "pi_cipher.h"
-
-const std::wstring RU_ALPHABET = L"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
-const std::wstring EN_ALPHABET = L"ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+#include "alphabet_traits.h"
 
 enum Alphabet
 {
@@ -117,8 +115,8 @@ void processGronsfeld(bool encryptMode)
     std::wcin.ignore();
 
     std::wstring alphabet = (currentAlphabet == RUSSIAN)
-                                ? L"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ"
-                                : L"ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+                                ? RU_ALPHABET
+                                : EN_ALPHABET;
 
     GronsfeldCipher cipher(key, alphabet);
 
@@ -0,0 +1,138 @@
+/**
+ * @file metrics.cpp
+ * @brief Регистрация потоковых счётчиков, агрегация и выгрузка в формате Prometheus.
+ */
+
+#include "metrics.h"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+namespace metrics
+{
+    namespace
+    {
+        struct CounterInfo {
+            const char* name;
+            const char* help;
+        };
+
+        const CounterInfo COUNTER_INFO[COUNTER_COUNT] = {
+            {"cipher_calls_total", "Number of encrypt/decrypt calls."},
+            {"cipher_chars_in_total", "Characters passed to the cipher."},
+            {"cipher_chars_out_total", "Characters produced by the cipher."},
+            {"cipher_chars_passthrough_total", "Non-alphabet characters copied unchanged."},
+            {"cipher_chars_dropped_total", "Characters dropped by the cipher."},
+            {"cipher_substitutions_total", "Unknown codes replaced with '?' on decryption."},
+            {"cipher_time_nanoseconds_total", "Time spent inside the cipher, nanoseconds."},
+            {"cipher_cache_hits_total", "Prepared cipher found in the cache."},
+            {"cipher_cache_misses_total", "Prepared cipher built on a cache miss."},
+            {"cipher_cache_evictions_total", "Prepared cipher evicted by the cache memory cap."},
+        };
+
+#ifdef CIPHER_METRICS
+        /**
+         * @brief Все блоки счётчиков. Блоки не освобождаются после завершения
+         * потока, чтобы его вклад не пропадал из сумм.
+         */
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadCounters>> blocks;
+        };
+
+        Registry& registry()
+        {
+            static Registry* instance = new Registry(); // живёт до конца процесса
+            return *instance;
+        }
+#endif
+    }
+
+#ifdef CIPHER_METRICS
+    ThreadCounters* registerThread()
+    {
+        auto block = std::make_unique<ThreadCounters>();
+        for (auto& row : block->rows) {
+            for (auto& value : row.values) {
+                value.store(0, std::memory_order_relaxed);
+            }
+        }
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.blocks.push_back(std::move(block));
+        return reg.blocks.back().get();
+    }
+#endif
+
+    Snapshot snapshot()
+    {
+        Snapshot total{};
+#ifdef CIPHER_METRICS
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const auto& block : reg.blocks) {
+            for (std::size_t c = 0; c < CIPHER_KIND_COUNT; ++c) {
+                for (std::size_t k = 0; k < COUNTER_COUNT; ++k) {
+                    total[c][k] += block->rows[c].values[k].load(std::memory_order_relaxed);
+                }
+            }
+        }
+#endif
+        return total;
+    }
+
+    void reset()
+    {
+#ifdef CIPHER_METRICS
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const auto& block : reg.blocks) {
+            for (auto& row : block->rows) {
+                for (auto& value : row.values) {
+                    value.store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+#endif
+    }
+
+    void writePrometheus(std::ostream& out)
+    {
+        if (!enabled()) {
+            out << "# cipher metrics are disabled at compile time (CIPHER_METRICS)\n";
+            return;
+        }
+
+        Snapshot total = snapshot();
+        for (std::size_t k = 0; k < COUNTER_COUNT; ++k) {
+            out << "# HELP " << COUNTER_INFO[k].name << ' ' << COUNTER_INFO[k].help << '\n';
+            out << "# TYPE " << COUNTER_INFO[k].name << " counter\n";
+            for (std::size_t c = 0; c < CIPHER_KIND_COUNT; ++c) {
+                out << COUNTER_INFO[k].name << "{cipher=\"" << cipherKindName(static_cast<CipherKind>(c + 1))
+                    << "\"} " << total[c][k] << '\n';
+            }
+        }
+    }
+
+    void writePrometheusFile(const std::string& path)
+    {
+        std::string temp = path + ".tmp";
+        {
+            std::ofstream file(temp, std::ios::trunc);
+            if (!file) {
+                throw std::runtime_error("Cannot open metrics file: " + temp);
+            }
+            writePrometheus(file);
+            if (!file.flush()) {
+                throw std::runtime_error("Cannot write metrics file: " + temp);
+            }
+        }
+        if (std::rename(temp.c_str(), path.c_str()) != 0) {
+            throw std::runtime_error("Cannot replace metrics file: " + path);
+        }
+    }
+}
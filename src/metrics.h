@@ -0,0 +1,175 @@
+/**
+ * @file metrics.h
+ * @brief Счётчики работы шифров: вызовы, символы, время.
+ *
+ * Каждый поток пишет в собственный блок счётчиков, выровненный по строке кэша,
+ * поэтому потоки не делят строки кэша и не используют атомарные RMW-операции.
+ * Значения суммируются только при чтении (snapshot, writePrometheus).
+ *
+ * Слой включается макросом CIPHER_METRICS (опция CMake CIPHER_METRICS).
+ * Без него CallScope — пустой класс с пустыми встроенными методами, и
+ * инструментирование шифров не порождает никакого кода.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "cipher_kind.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+#ifdef CIPHER_METRICS
+#include <chrono>
+#endif
+
+namespace metrics
+{
+    /**
+     * @brief Вид счётчика.
+     */
+    enum class Counter : std::size_t {
+        Calls,          ///< Число вызовов шифрования/дешифрования
+        CharsIn,        ///< Символов на входе
+        CharsOut,       ///< Символов на выходе
+        Passthrough,    ///< Символов вне алфавита, скопированных без изменений (Gronsfeld, Affine)
+        Dropped,        ///< Символов, отброшенных шифром (Polybius, Pi)
+        Substituted,    ///< Нераспознанных кодов, заменённых на '?' (PiCipher::decrypt)
+        Nanoseconds,    ///< Время в шифре, нс
+        CacheHits,      ///< Подготовленный шифр найден в кэше
+        CacheMisses,    ///< Подготовленный шифр построен заново
+        CacheEvictions, ///< Подготовленный шифр вытеснен из кэша
+        Count
+    };
+
+    constexpr std::size_t COUNTER_COUNT = static_cast<std::size_t>(Counter::Count);
+
+    /**
+     * @brief Сумма счётчиков по всем потокам: [шифр][счётчик].
+     */
+    using Snapshot = std::array<std::array<std::uint64_t, COUNTER_COUNT>, CIPHER_KIND_COUNT>;
+
+    /**
+     * @brief true, если слой метрик включён при компиляции.
+     */
+    constexpr bool enabled()
+    {
+#ifdef CIPHER_METRICS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Суммирует счётчики всех потоков (нули, если метрики выключены).
+     */
+    Snapshot snapshot();
+
+    /**
+     * @brief Обнуляет счётчики всех потоков (для тестов и периодической выгрузки).
+     */
+    void reset();
+
+    /**
+     * @brief Пишет счётчики в текстовом формате Prometheus.
+     */
+    void writePrometheus(std::ostream& out);
+
+    /**
+     * @brief Пишет счётчики в файл: сначала во временный, затем переименовывает,
+     * чтобы сборщик не прочитал файл наполовину.
+     * @throw std::runtime_error Если файл не удалось записать.
+     */
+    void writePrometheusFile(const std::string& path);
+
+#ifdef CIPHER_METRICS
+    /**
+     * @brief Блок счётчиков одного шифра; занимает ровно одну строку кэша.
+     */
+    struct alignas(64) CounterRow {
+        std::atomic<std::uint64_t> values[COUNTER_COUNT];
+    };
+
+    /**
+     * @brief Счётчики одного потока.
+     */
+    struct ThreadCounters {
+        CounterRow rows[CIPHER_KIND_COUNT];
+    };
+
+    /**
+     * @brief Регистрирует блок счётчиков текущего потока.
+     */
+    ThreadCounters* registerThread();
+
+    inline thread_local ThreadCounters* threadCounters = nullptr;
+
+    /**
+     * @brief Прибавляет n к счётчику текущего потока.
+     *
+     * Писатель у блока один, поэтому достаточно загрузки и записи без lock-префикса.
+     */
+    inline void add(CipherKind cipher, Counter counter, std::uint64_t n)
+    {
+        ThreadCounters* local = threadCounters;
+        if (!local) {
+            local = threadCounters = registerThread();
+        }
+        auto& value = local->rows[cipherKindIndex(cipher)].values[static_cast<std::size_t>(counter)];
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Учёт одного вызова шифра: вызов, символы на входе и выходе, время.
+     *
+     * Размер выхода берётся как прирост строки out за время жизни объекта.
+     */
+    template <class String>
+    class CallScope {
+    public:
+        CallScope(CipherKind cipher, std::size_t inputSize, const String& out)
+            : cipher(cipher), inputSize(inputSize), out(out), base(out.size()),
+              start(std::chrono::steady_clock::now()) {}
+
+        ~CallScope()
+        {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            add(cipher, Counter::Calls, 1);
+            add(cipher, Counter::CharsIn, inputSize);
+            add(cipher, Counter::CharsOut, out.size() - base);
+            add(cipher, Counter::Nanoseconds,
+                static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+
+        CallScope(const CallScope&) = delete;
+        CallScope& operator=(const CallScope&) = delete;
+
+        void passthrough(std::size_t n) const { add(cipher, Counter::Passthrough, n); }
+        void dropped(std::size_t n) const { add(cipher, Counter::Dropped, n); }
+        void substituted(std::size_t n) const { add(cipher, Counter::Substituted, n); }
+
+    private:
+        CipherKind cipher;
+        std::size_t inputSize;
+        const String& out;
+        std::size_t base;
+        std::chrono::steady_clock::time_point start;
+    };
+#else
+    inline void add(CipherKind, Counter, std::uint64_t) {}
+
+    template <class String>
+    class CallScope {
+    public:
+        CallScope(CipherKind, std::size_t, const String&) {}
+        void passthrough(std::size_t) const {}
+        void dropped(std::size_t) const {}
+        void substituted(std::size_t) const {}
+    };
+#endif
+}
+
+#endif // METRICS_H
@@ -0,0 +1,278 @@
+/**
+ * @file ngram_model.cpp
+ * @brief Реализация модели n-грамм: обучение, файл, отображение в память и оценка.
+ */
+
+#include "ngram_model.h"
+#include "letter_frequency.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr char MAGIC[4] = {'N', 'G', 'R', 'M'};
+    constexpr std::uint32_t VERSION = 1;
+    constexpr double UNSEEN_COUNT = 0.01; ///< «Число вхождений» невстреченной n-граммы при обучении
+
+    /**
+     * @brief Заголовок файла модели (32 байта, таблица за ним выровнена).
+     */
+    struct FileHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t alphabet;  ///< 0 — EN_ALPHABET, 1 — RU_ALPHABET
+        std::uint32_t order;
+        float floor;
+        std::uint32_t reserved[3];
+    };
+    static_assert(sizeof(FileHeader) == 32, "n-gram file header must stay 32 bytes");
+
+    size_t tableSize(int order)
+    {
+        return size_t(1) << (NgramModel::BITS * order);
+    }
+
+    void checkArguments(BuiltinAlphabet alphabet, int order)
+    {
+        if (alphabet == BuiltinAlphabet::None) {
+            throw std::invalid_argument("N-gram model needs EN_ALPHABET or RU_ALPHABET.");
+        }
+        if (order < NgramModel::MIN_ORDER || order > NgramModel::MAX_ORDER) {
+            throw std::invalid_argument("N-gram order must be from 2 to 4.");
+        }
+    }
+
+    int alphabetSize(BuiltinAlphabet alphabet)
+    {
+        return static_cast<int>(alphabet == BuiltinAlphabet::English ? EN_ALPHABET.size() : RU_ALPHABET.size());
+    }
+
+    /// Собственная таблица модели (обучение, частоты букв, чтение файла без отображения).
+    std::shared_ptr<float> allocateTable(size_t size, float value)
+    {
+        std::shared_ptr<float> table(new float[size], std::default_delete<float[]>());
+        std::fill(table.get(), table.get() + size, value);
+        return table;
+    }
+
+    /**
+     * @brief Проверяет заголовок и размер файла.
+     */
+    void checkHeader(const FileHeader& header, std::uint64_t fileSize)
+    {
+        const bool valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION
+                           && header.alphabet <= 1 && header.order >= NgramModel::MIN_ORDER
+                           && header.order <= NgramModel::MAX_ORDER
+                           && fileSize == sizeof(FileHeader) + tableSize(header.order) * sizeof(float);
+        if (!valid) {
+            throw std::runtime_error("Invalid n-gram model file.");
+        }
+    }
+}
+
+NgramModel NgramModel::load(const std::string& path) {
+    FileHeader header;
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        throw std::runtime_error("Cannot open n-gram model: " + path);
+    }
+    const std::uint64_t fileSize = static_cast<std::uint64_t>(in.tellg());
+    in.seekg(0);
+    if (fileSize < sizeof(header) || !in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error("Invalid n-gram model file.");
+    }
+    checkHeader(header, fileSize);
+    const size_t size = tableSize(header.order);
+    std::shared_ptr<float> table = allocateTable(size, 0.0f);
+    if (!in.read(reinterpret_cast<char*>(table.get()), static_cast<std::streamsize>(size * sizeof(float)))) {
+        throw std::runtime_error("Cannot read n-gram model: " + path);
+    }
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open n-gram model: " + path);
+    }
+    struct stat info;
+    void* base = MAP_FAILED;
+    size_t fileSize = 0;
+    if (::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(header)) {
+        fileSize = static_cast<size_t>(info.st_size);
+        base = ::mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd); // отображение остаётся действительным
+    if (base == MAP_FAILED) {
+        throw std::runtime_error("Cannot map n-gram model: " + path);
+    }
+    std::memcpy(&header, base, sizeof(header));
+    try {
+        checkHeader(header, fileSize);
+    } catch (...) {
+        ::munmap(base, fileSize);
+        throw;
+    }
+    // Оценка обращается к таблице вразброс: страницы лучше подгрузить сразу, а не по одной при промахах.
+    ::madvise(base, fileSize, MADV_WILLNEED);
+    std::shared_ptr<const float> table(reinterpret_cast<const float*>(static_cast<const char*>(base) + sizeof(header)),
+                                       [base, fileSize](const float*) { ::munmap(base, fileSize); });
+#endif
+    const BuiltinAlphabet alphabet = header.alphabet == 0 ? BuiltinAlphabet::English : BuiltinAlphabet::Russian;
+    return NgramModel(alphabet, static_cast<int>(header.order), header.floor, std::move(table));
+}
+
+NgramModel NgramModel::train(std::wstring_view corpus, BuiltinAlphabet alphabet, int order) {
+    checkArguments(alphabet, order);
+    NgramModel counter(alphabet, order, 0.0f, nullptr);
+    const std::vector<std::uint8_t> text = counter.letters(corpus);
+    if (text.size() < static_cast<size_t>(order)) {
+        throw std::invalid_argument("Corpus has no n-grams.");
+    }
+
+    const size_t size = tableSize(order);
+    const size_t mask = size - 1;
+    std::vector<std::uint64_t> counts(size, 0);
+    size_t index = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        index = ((index << BITS) | text[i]) & mask;
+        if (i + 1 >= static_cast<size_t>(order)) ++counts[index];
+    }
+
+    const double total = static_cast<double>(text.size() - order + 1);
+    const float floor = static_cast<float>(std::log(UNSEEN_COUNT / total));
+    std::shared_ptr<float> table = allocateTable(size, floor);
+    for (size_t i = 0; i < size; ++i) {
+        if (counts[i] != 0) table.get()[i] = static_cast<float>(std::log(static_cast<double>(counts[i]) / total));
+    }
+    return NgramModel(alphabet, order, floor, std::move(table));
+}
+
+NgramModel NgramModel::fromLetterFrequency(BuiltinAlphabet alphabet, int order) {
+    checkArguments(alphabet, order);
+    const std::vector<double>& freq =
+        alphabet == BuiltinAlphabet::English ? LetterFrequency::english() : LetterFrequency::russian();
+    const int m = alphabetSize(alphabet);
+    const float floor = static_cast<float>(order * std::log(*std::min_element(freq.begin(), freq.end())));
+
+    const size_t size = tableSize(order);
+    std::shared_ptr<float> table = allocateTable(size, floor);
+    for (size_t i = 0; i < size; ++i) {
+        double sum = 0.0;
+        bool inAlphabet = true;
+        for (int k = 0; k < order && inAlphabet; ++k) {
+            const int letter = static_cast<int>((i >> (BITS * k)) & ((1u << BITS) - 1));
+            inAlphabet = letter < m;
+            if (inAlphabet) sum += std::log(freq[letter]);
+        }
+        if (inAlphabet) table.get()[i] = static_cast<float>(sum);
+    }
+    return NgramModel(alphabet, order, floor, std::move(table));
+}
+
+void NgramModel::save(const std::string& path) const {
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.alphabet = alphabet_ == BuiltinAlphabet::English ? 0 : 1;
+    header.order = static_cast<std::uint32_t>(order_);
+    header.floor = floor_;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(table()), static_cast<std::streamsize>(tableSize(order_) * sizeof(float)));
+    if (!out) {
+        throw std::runtime_error("Cannot write n-gram model: " + path);
+    }
+}
+
+int NgramModel::letterIndex(wchar_t c) const {
+    if (alphabet_ == BuiltinAlphabet::English) {
+        if (c >= L'A' && c <= L'Z') return c - L'A';
+        if (c >= L'a' && c <= L'z') return c - L'a';
+    } else {
+        if (c >= L'А' && c <= L'Я') return c - L'А';
+        if (c >= L'а' && c <= L'я') return c - L'а';
+    }
+    return -1;
+}
+
+std::vector<std::uint8_t> NgramModel::letters(std::wstring_view text) const {
+    std::vector<std::uint8_t> out;
+    out.reserve(text.size());
+    for (wchar_t c : text) {
+        const int i = letterIndex(c);
+        if (i >= 0) out.push_back(static_cast<std::uint8_t>(i));
+    }
+    return out;
+}
+
+float NgramModel::gram(const std::uint8_t* letters) const {
+    size_t index = 0;
+    for (int k = 0; k < order_; ++k) index = (index << BITS) | letters[k];
+    return table_.get()[index];
+}
+
+double NgramModel::score(const std::uint8_t* letters, size_t length) const {
+    if (length < static_cast<size_t>(order_)) return 0.0;
+    const float* table = table_.get();
+    const size_t mask = tableSize(order_) - 1;
+    size_t index = 0;
+    for (int k = 0; k < order_ - 1; ++k) index = (index << BITS) | letters[k];
+
+    // Две суммы попеременно: сложения не ждут друг друга, пока идут обращения к таблице.
+    double even = 0.0;
+    double odd = 0.0;
+    size_t i = static_cast<size_t>(order_ - 1);
+    for (; i + 1 < length; i += 2) {
+        index = ((index << BITS) | letters[i]) & mask;
+        even += table[index];
+        index = ((index << BITS) | letters[i + 1]) & mask;
+        odd += table[index];
+    }
+    if (i < length) {
+        index = ((index << BITS) | letters[i]) & mask;
+        even += table[index];
+    }
+    return even + odd;
+}
+
+double NgramModel::score(std::wstring_view text) const {
+    const std::vector<std::uint8_t> indices = letters(text);
+    return score(indices.data(), indices.size());
+}
+
+NgramScore::NgramScore(const NgramModel& model, std::vector<std::uint8_t> letters)
+    : model_(&model), letters_(std::move(letters)), total_(model.score(letters_.data(), letters_.size())) {}
+
+double NgramScore::around(size_t pos, std::uint8_t letter) const {
+    const size_t n = static_cast<size_t>(model_->order());
+    if (letters_.size() < n) return 0.0;
+    const size_t first = pos + 1 >= n ? pos + 1 - n : 0;
+    const size_t last = std::min(pos, letters_.size() - n);
+    double sum = 0.0;
+    for (size_t start = first; start <= last; ++start) {
+        std::uint8_t window[NgramModel::MAX_ORDER];
+        std::copy(letters_.begin() + start, letters_.begin() + start + n, window);
+        window[pos - start] = letter;
+        sum += model_->gram(window);
+    }
+    return sum;
+}
+
+double NgramScore::delta(size_t pos, std::uint8_t letter) const {
+    return around(pos, letter) - around(pos, letters_[pos]);
+}
+
+void NgramScore::set(size_t pos, std::uint8_t letter) {
+    total_ += delta(pos, letter);
+    letters_[pos] = letter;
+}
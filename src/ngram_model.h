@@ -0,0 +1,161 @@
+/**
+ * @file ngram_model.h
+ * @brief Заголовочный файл для классов NgramModel и NgramScore — оценка открытого текста по n-граммам.
+ */
+
+#ifndef NGRAM_MODEL_H
+#define NGRAM_MODEL_H
+
+#include "alphabet_traits.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class NgramModel
+ * @brief Логарифмы вероятностей n-грамм (n от 2 до 4) букв EN_ALPHABET или RU_ALPHABET.
+ *
+ * Таблица плотная: индекс n-граммы — индексы букв в алфавите по 5 бит подряд, первая
+ * буква в старших битах. Для n = 4 это 32^4 чисел float (4 МБ), для английского
+ * индексы 26–31 не используются и содержат нижнюю границу. Соседние окна текста
+ * отличаются сдвигом индекса на 5 бит, поэтому оценка — одно обращение к таблице на букву.
+ *
+ * Оцениваются только буквы алфавита без учёта регистра; остальные символы
+ * пропускаются, n-граммы идут через них. Модель копируется дёшево (таблица общая).
+ *
+ * Формат файла: заголовок (магическое "NGRM", версия, алфавит, n, нижняя граница)
+ * и таблица float в порядке байтов машины. load() отображает файл в память: таблица
+ * не копируется и делится между процессами через страничный кэш.
+ */
+class NgramModel {
+public:
+    static constexpr int BITS = 5;          ///< Бит на букву в индексе n-граммы
+    static constexpr int MIN_ORDER = 2;     ///< Биграммы
+    static constexpr int MAX_ORDER = 4;     ///< Квадграммы
+
+    /**
+     * @brief Загружает модель из файла, отображая его в память.
+     * @throw std::runtime_error Если файл не открывается или не является моделью n-грамм.
+     */
+    static NgramModel load(const std::string& path);
+
+    /**
+     * @brief Считает модель по корпусу открытых текстов.
+     *
+     * Вероятность — доля n-граммы среди всех n-грамм корпуса; невстреченные
+     * n-граммы получают нижнюю границу log(0.01 / total).
+     *
+     * @throw std::invalid_argument Если алфавит не встроенный, n вне [2, 4] или в корпусе нет ни одной n-граммы.
+     */
+    static NgramModel train(std::wstring_view corpus, BuiltinAlphabet alphabet, int order);
+
+    /**
+     * @brief Модель из эталонных частот букв (LetterFrequency): сумма логарифмов частот букв n-граммы.
+     *
+     * Запасной вариант без корпуса: оценка совпадает с правдоподобием частот букв.
+     *
+     * @throw std::invalid_argument Если алфавит не встроенный или n вне [2, 4].
+     */
+    static NgramModel fromLetterFrequency(BuiltinAlphabet alphabet, int order);
+
+    /**
+     * @brief Сохраняет модель в файл формата load().
+     * @throw std::runtime_error При ошибке записи.
+     */
+    void save(const std::string& path) const;
+
+    /** @brief Встроенный алфавит модели. */
+    BuiltinAlphabet alphabet() const { return alphabet_; }
+
+    /** @brief Длина n-граммы. */
+    int order() const { return order_; }
+
+    /** @brief Нижняя граница логарифма вероятности (невстреченные n-граммы). */
+    float floor() const { return floor_; }
+
+    /**
+     * @brief Индекс буквы в алфавите модели без учёта регистра или -1.
+     */
+    int letterIndex(wchar_t c) const;
+
+    /**
+     * @brief Индексы букв текста (остальные символы пропускаются).
+     */
+    std::vector<std::uint8_t> letters(std::wstring_view text) const;
+
+    /**
+     * @brief Логарифм вероятности n-граммы, начинающейся в letters (order() индексов).
+     */
+    float gram(const std::uint8_t* letters) const;
+
+    /**
+     * @brief Сумма оценок всех n-грамм последовательности индексов букв.
+     * @return 0, если букв меньше order().
+     */
+    double score(const std::uint8_t* letters, size_t length) const;
+
+    /**
+     * @brief Сумма оценок всех n-грамм букв текста (подходит как TextScorer для RailFenceSolver).
+     */
+    double score(std::wstring_view text) const;
+
+    /**
+     * @brief Таблица: 2^(BITS * order()) чисел.
+     */
+    const float* table() const { return table_.get(); }
+
+private:
+    NgramModel(BuiltinAlphabet alphabet, int order, float floor, std::shared_ptr<const float> table)
+        : alphabet_(alphabet), order_(order), floor_(floor), table_(std::move(table)) {}
+
+    BuiltinAlphabet alphabet_;
+    int order_;
+    float floor_;
+    std::shared_ptr<const float> table_; ///< Отображение файла или собственный массив
+};
+
+/**
+ * @class NgramScore
+ * @brief Оценка текста, пересчитываемая при замене одной буквы.
+ *
+ * Замена буквы затрагивает не больше order() n-грамм, поэтому delta() и set()
+ * стоят O(order()) независимо от длины текста — для решателей, которые пробуют
+ * изменения ключа по одной букве и принимают только улучшающие.
+ */
+class NgramScore {
+public:
+    /**
+     * @brief Конструктор: считает полную оценку один раз.
+     * @param model Модель (должна жить дольше оценки).
+     * @param letters Индексы букв текста (NgramModel::letters).
+     */
+    NgramScore(const NgramModel& model, std::vector<std::uint8_t> letters);
+
+    /** @brief Текущая оценка. */
+    double total() const { return total_; }
+
+    /** @brief Текущие индексы букв. */
+    const std::vector<std::uint8_t>& letters() const { return letters_; }
+
+    /**
+     * @brief Изменение оценки, если букву pos заменить на letter (текст не меняется).
+     */
+    double delta(size_t pos, std::uint8_t letter) const;
+
+    /**
+     * @brief Заменяет букву pos на letter и обновляет оценку.
+     */
+    void set(size_t pos, std::uint8_t letter);
+
+private:
+    /// Сумма n-грамм, накрывающих pos, если бы в pos стояла letter.
+    double around(size_t pos, std::uint8_t letter) const;
+
+    const NgramModel* model_;
+    std::vector<std::uint8_t> letters_;
+    double total_;
+};
+
+#endif // NGRAM_MODEL_H
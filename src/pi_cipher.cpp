@@ -6,6 +6,10 @@
  */
 
 #include "pi_cipher.h"
+#include "cipher_batch.h"
+#include "metrics.h"
+#include "alphabet_traits.h"
+#include <array>
 #include <unordered_map>
 #include <cwctype> ///< Для towupper
 
@@ -70,6 +74,134 @@ void PiCipher::build_codebooks(
     }
 }
 
+namespace
+{
+    /**
+     * @brief Плотная таблица кодов для встроенного алфавита.
+     *
+     * Заполняется, только если ключи enc_map в точности совпадают с буквами Alphabet.
+     *
+     * @return true, если таблица построена.
+     */
+    template <class Alphabet>
+    bool buildDenseCodes(
+        const std::unordered_map<wchar_t, std::wstring>& enc_map,
+        std::array<const std::wstring*, 32>& codes)
+    {
+        static_assert(Alphabet::size() <= 32, "таблица рассчитана на алфавит до 32 букв");
+        if (enc_map.size() != static_cast<size_t>(Alphabet::size())) return false;
+        for (int i = 0; i < Alphabet::size(); ++i) {
+            auto it = enc_map.find(Alphabet::at(i));
+            if (it == enc_map.end()) return false;
+            codes[i] = &it->second;
+        }
+        return true;
+    }
+
+    /// Шифрование по плотной таблице; возвращает число отброшенных символов.
+    template <class Alphabet, class String>
+    size_t encryptDense(std::wstring_view text, const std::array<const std::wstring*, 32>& codes, String& res)
+    {
+        size_t dropped = 0;
+        for (wchar_t c : text) {
+            int idx = upperIndexOf(Alphabet{}, c);
+            if (idx >= 0)
+                res += *codes[idx];
+            else
+                ++dropped;
+        }
+        return dropped;
+    }
+
+    /// Индекс двузначного кода "00".."99" или -1 для прочих пар.
+    inline int digitPairIndex(wchar_t hi, wchar_t lo)
+    {
+        unsigned h = static_cast<unsigned>(hi - L'0');
+        unsigned l = static_cast<unsigned>(lo - L'0');
+        return (h < 10 && l < 10) ? static_cast<int>(h * 10 + l) : -1;
+    }
+}
+
+/**
+ * @brief Общая реализация шифрования: коды символов дописываются в res.
+ *
+ * Если таблица построена для EN_ALPHABET или RU_ALPHABET, код буквы берётся
+ * из плотного массива по её индексу вместо поиска в хеш-таблице.
+ */
+template <class String>
+void PiCipher::encryptInto(
+    std::wstring_view text,
+    const std::unordered_map<wchar_t, std::wstring>& enc_map,
+    String& res)
+{
+    metrics::CallScope scope(CipherKind::Pi, text.size(), res);
+    res.reserve(res.size() + 2 * text.size());
+
+    std::array<const std::wstring*, 32> codes{};
+    if (buildDenseCodes<EnAlphabet>(enc_map, codes)) {
+        scope.dropped(encryptDense<EnAlphabet>(text, codes, res));
+        return;
+    }
+    if (buildDenseCodes<RuAlphabet>(enc_map, codes)) {
+        scope.dropped(encryptDense<RuAlphabet>(text, codes, res));
+        return;
+    }
+
+    size_t dropped = 0;
+    for (wchar_t c : text) {
+        auto it = enc_map.find(std::towupper(c));
+        if (it != enc_map.end())
+            res += it->second;
+        else
+            ++dropped;
+    }
+    scope.dropped(dropped);
+}
+
+/**
+ * @brief Общая реализация дешифрования: символы дописываются в res.
+ *
+ * Пары из двух цифр декодируются по плотной таблице на 100 кодов,
+ * построенной один раз из dec_map. Прочие пары ищутся в dec_map через
+ * один и тот же двухсимвольный буфер.
+ */
+template <class String>
+void PiCipher::decryptInto(
+    std::wstring_view cipher,
+    const std::unordered_map<std::wstring, wchar_t>& dec_map,
+    String& res)
+{
+    metrics::CallScope scope(CipherKind::Pi, cipher.size(), res);
+    res.reserve(res.size() + cipher.size() / 2);
+    std::wstring num(2, L'0');
+
+    std::array<wchar_t, 100> digits;
+    for (int code = 0; code < 100; ++code) {
+        num[0] = static_cast<wchar_t>(L'0' + code / 10);
+        num[1] = static_cast<wchar_t>(L'0' + code % 10);
+        auto it = dec_map.find(num);
+        digits[code] = it != dec_map.end() ? it->second : L'?';
+    }
+
+    size_t substituted = 0;
+    for (size_t i = 0; i + 1 < cipher.size(); i += 2) {
+        int code = digitPairIndex(cipher[i], cipher[i + 1]);
+        wchar_t c;
+        if (code >= 0) {
+            c = digits[code];
+        } else {
+            num[0] = cipher[i];
+            num[1] = cipher[i + 1];
+            auto it = dec_map.find(num);
+            c = it != dec_map.end() ? it->second : L'?';
+        }
+        res += c;
+        substituted += c == L'?';
+    }
+    scope.substituted(substituted);
+    scope.dropped(cipher.size() % 2);
+}
+
 /**
  * @brief Шифрует текст с использованием Pi Cipher.
  *
@@ -84,11 +216,7 @@ std::wstring PiCipher::encrypt(
     const std::unordered_map<wchar_t, std::wstring>& enc_map)
 {
     std::wstring res;
-    for (wchar_t c : text) {
-        wchar_t up = std::towupper(c);
-        if (enc_map.count(up))
-            res += enc_map.at(up);
-    }
+    encryptInto(text, enc_map, res);
     return res;
 }
 
@@ -106,9 +234,68 @@ std::wstring PiCipher::decrypt(
     const std::unordered_map<std::wstring, wchar_t>& dec_map)
 {
     std::wstring res;
-    for (size_t i = 0; i + 1 < cipher.size(); i += 2) {
-        std::wstring num = cipher.substr(i, 2);
-        res += dec_map.count(num) ? dec_map.at(num) : L'?';
-    }
+    decryptInto(cipher, dec_map, res);
+    return res;
+}
+
+/**
+ * @brief Шифрует текст, размещая результат в ресурсе памяти mr.
+ *
+ * @param text Исходный текст.
+ * @param enc_map Таблица кодирования: символ → код.
+ * @param mr Ресурс памяти вызывающего кода.
+ * @return Зашифрованная строка (только цифры).
+ */
+std::pmr::wstring PiCipher::encrypt(
+    const std::wstring& text,
+    const std::unordered_map<wchar_t, std::wstring>& enc_map,
+    std::pmr::memory_resource* mr)
+{
+    std::pmr::wstring res(mr);
+    encryptInto(text, enc_map, res);
     return res;
 }
+
+/**
+ * @brief Дешифрует строку, размещая результат в ресурсе памяти mr.
+ *
+ * @param cipher Зашифрованная строка.
+ * @param dec_map Таблица декодирования: код → символ.
+ * @param mr Ресурс памяти вызывающего кода.
+ * @return Расшифрованный текст.
+ */
+std::pmr::wstring PiCipher::decrypt(
+    const std::wstring& cipher,
+    const std::unordered_map<std::wstring, wchar_t>& dec_map,
+    std::pmr::memory_resource* mr)
+{
+    std::pmr::wstring res(mr);
+    decryptInto(cipher, dec_map, res);
+    return res;
+}
+
+/**
+ * @brief Шифрует пакет сообщений, дописывая результаты в out.
+ */
+void PiCipher::encryptBatch(
+    const TextBatch& texts,
+    const std::unordered_map<wchar_t, std::wstring>& enc_map,
+    CipherBatch& out)
+{
+    out.appendEach(texts, [&enc_map](std::wstring_view text, std::pmr::wstring& data) {
+        encryptInto(text, enc_map, data);
+    });
+}
+
+/**
+ * @brief Дешифрует пакет сообщений, дописывая результаты в out.
+ */
+void PiCipher::decryptBatch(
+    const TextBatch& ciphers,
+    const std::unordered_map<std::wstring, wchar_t>& dec_map,
+    CipherBatch& out)
+{
+    out.appendEach(ciphers, [&dec_map](std::wstring_view cipher, std::pmr::wstring& data) {
+        decryptInto(cipher, dec_map, data);
+    });
+}
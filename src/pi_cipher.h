@@ -2,7 +2,19 @@
 #define PI_CIPHER_H
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <memory_resource>
+
+class TextBatch;
+class CipherBatch;
+
+/**
+ * @brief Цифры числа Пи после запятой, из которых PiCipher берёт коды.
+ *
+ * Ключ PiCipher — позиция начала в этой строке (1 = первая цифра).
+ */
+extern const std::wstring pi_digits;
 
 /**
  * @class PiCipher
@@ -23,6 +35,42 @@ public:
     static std::wstring decrypt(
         const std::wstring& cipher,
         const std::unordered_map<std::wstring, wchar_t>& dec_map);
+
+    static std::pmr::wstring encrypt(
+        const std::wstring& text,
+        const std::unordered_map<wchar_t, std::wstring>& enc_map,
+        std::pmr::memory_resource* mr);
+
+    static std::pmr::wstring decrypt(
+        const std::wstring& cipher,
+        const std::unordered_map<std::wstring, wchar_t>& dec_map,
+        std::pmr::memory_resource* mr);
+
+    /**
+     * @brief Пакеты сообщений: результаты дописываются в out (см. cipher_batch.h).
+     */
+    static void encryptBatch(
+        const TextBatch& texts,
+        const std::unordered_map<wchar_t, std::wstring>& enc_map,
+        CipherBatch& out);
+
+    static void decryptBatch(
+        const TextBatch& ciphers,
+        const std::unordered_map<std::wstring, wchar_t>& dec_map,
+        CipherBatch& out);
+
+private:
+    template <class String>
+    static void encryptInto(
+        std::wstring_view text,
+        const std::unordered_map<wchar_t, std::wstring>& enc_map,
+        String& res);
+
+    template <class String>
+    static void decryptInto(
+        std::wstring_view cipher,
+        const std::unordered_map<std::wstring, wchar_t>& dec_map,
+        String& res);
 };
 
 #endif // PI_CIPHER_H
@@ -0,0 +1,140 @@
+/**
+ * @file pi_key_solver.cpp
+ * @brief Реализация перебора ключей PiCipher: таблицы кодов всех ключей и оценка выборки.
+ */
+
+#include "pi_key_solver.h"
+#include "pi_cipher.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace
+{
+    constexpr size_t KEY_GRAIN = 32; ///< Ключей в одной задаче пула (оценка одного ключа — доли микросекунды)
+
+    /// Код пары цифр в позиции pos строки pi_digits.
+    int pairAt(size_t pos)
+    {
+        return (pi_digits[pos] - L'0') * 10 + (pi_digits[pos + 1] - L'0');
+    }
+
+    /**
+     * @brief Коды первых limit пар шифртекста ("00".."99" → 0..99, прочие пары → -1).
+     */
+    std::vector<int> digitCodes(const std::wstring& ciphertext, size_t limit)
+    {
+        std::vector<int> codes;
+        codes.reserve(std::min(limit, ciphertext.size() / 2));
+        for (size_t i = 0; i + 1 < ciphertext.size() && codes.size() < limit; i += 2) {
+            unsigned hi = static_cast<unsigned>(ciphertext[i] - L'0');
+            unsigned lo = static_cast<unsigned>(ciphertext[i + 1] - L'0');
+            codes.push_back(hi < 10 && lo < 10 ? static_cast<int>(hi * 10 + lo) : -1);
+        }
+        return codes;
+    }
+
+    /**
+     * @brief Оценка расшифровки выборки одним ключом.
+     * @param codes Коды выборки шифртекста (-1 — пара не из цифр).
+     * @param table Таблица ключа.
+     * @param modelLetter Индекс буквы алфавита в модели или -1.
+     * @param[out] letters Буфер индексов букв (переиспользуется между ключами).
+     */
+    double sampleScore(const std::vector<int>& codes, const PiKeySolver::DecodeTable& table,
+                       const std::vector<int>& modelLetter, const NgramModel& model,
+                       std::vector<std::uint8_t>& letters)
+    {
+        letters.clear();
+        size_t invalid = 0;
+        for (int code : codes) {
+            const int letter = code >= 0 ? table[code] : -1;
+            if (letter < 0) {
+                ++invalid;
+            } else if (modelLetter[letter] >= 0) {
+                letters.push_back(static_cast<std::uint8_t>(modelLetter[letter]));
+            }
+        }
+        const size_t grams = letters.size() >= static_cast<size_t>(model.order())
+                                 ? letters.size() - model.order() + 1 : 0;
+        const double total = model.score(letters.data(), letters.size()) + static_cast<double>(invalid) * model.floor();
+        return total / static_cast<double>(std::max<size_t>(1, grams + invalid));
+    }
+}
+
+int PiKeySolver::maxKey() {
+    return static_cast<int>(pi_digits.size()) - 1;
+}
+
+std::vector<PiKeySolver::DecodeTable> PiKeySolver::decodeTables(size_t alphabetSize) {
+    const size_t keys = static_cast<size_t>(maxKey());
+    const size_t letters = std::min(alphabetSize, CODES);
+    std::vector<DecodeTable> tables(keys);
+
+    for (size_t parity = 0; parity < 2; ++parity) {
+        // order — различные коды в порядке первого вхождения, начиная с текущей позиции.
+        std::vector<int> order;
+        order.reserve(CODES);
+        size_t pos = keys - 1;
+        if (pos % 2 != parity) --pos;
+        for (;; pos -= 2) {
+            const int code = pairAt(pos);
+            auto it = std::find(order.begin(), order.end(), code);
+            if (it != order.end()) order.erase(it);
+            order.insert(order.begin(), code);
+
+            DecodeTable& table = tables[pos];
+            table.fill(-1);
+            for (size_t r = 0; r < letters && r < order.size(); ++r) {
+                table[order[r]] = static_cast<std::int8_t>(r);
+            }
+            if (pos < 2) break;
+        }
+    }
+    return tables;
+}
+
+std::vector<PiKeyCandidate> PiKeySolver::solve(const std::wstring& ciphertext, const std::wstring& alphabet,
+                                               const NgramModel& model, size_t top, size_t sample) {
+    if (alphabet.empty()) {
+        throw std::invalid_argument("Alphabet must not be empty.");
+    }
+    const std::vector<DecodeTable> tables = decodeTables(alphabet.size());
+
+    std::vector<int> modelLetter(alphabet.size());
+    for (size_t i = 0; i < alphabet.size(); ++i) modelLetter[i] = model.letterIndex(alphabet[i]);
+
+    const std::vector<int> codes = digitCodes(ciphertext, sample);
+
+    std::vector<PiKeyCandidate> candidates;
+    for (int key = 1; key <= maxKey(); ++key) {
+        candidates.push_back({key, 0.0, {}});
+    }
+
+    ThreadPool::shared().parallelFor(0, candidates.size(), KEY_GRAIN, [&](size_t first, size_t last) {
+        std::vector<std::uint8_t> letters;
+        letters.reserve(codes.size());
+        for (size_t i = first; i < last; ++i) {
+            candidates[i].score = sampleScore(codes, tables[i], modelLetter, model, letters);
+        }
+    });
+
+    auto byScore = [](const PiKeyCandidate& a, const PiKeyCandidate& b) { return a.score > b.score; };
+    top = std::min(top, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + top, candidates.end(), byScore);
+    candidates.resize(top);
+
+    // Полная расшифровка рабочей реализацией и окончательная оценка по всему тексту.
+    const std::vector<int> allCodes = digitCodes(ciphertext, ciphertext.size());
+    std::vector<std::uint8_t> letters;
+    for (auto& c : candidates) {
+        std::unordered_map<wchar_t, std::wstring> encMap;
+        std::unordered_map<std::wstring, wchar_t> decMap;
+        PiCipher::build_codebooks(c.key, alphabet, encMap, decMap);
+        c.plaintext = PiCipher::decrypt(ciphertext, decMap);
+        c.score = sampleScore(allCodes, tables[c.key - 1], modelLetter, model, letters);
+    }
+    std::sort(candidates.begin(), candidates.end(), byScore);
+    return candidates;
+}
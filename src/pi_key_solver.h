@@ -0,0 +1,76 @@
+/**
+ * @file pi_key_solver.h
+ * @brief Заголовочный файл для класса PiKeySolver — перебор ключей PiCipher.
+ */
+
+#ifndef PI_KEY_SOLVER_H
+#define PI_KEY_SOLVER_H
+
+#include "ngram_model.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Кандидат ключа PiCipher.
+ */
+struct PiKeyCandidate {
+    int key;                ///< Позиция начала в pi_digits
+    double score;           ///< Средняя оценка n-граммы открытого текста (больше — лучше)
+    std::wstring plaintext; ///< Полностью расшифрованный текст
+};
+
+/**
+ * @class PiKeySolver
+ * @brief Полный перебор ключей PiCipher: ключей столько, сколько позиций в pi_digits.
+ *
+ * Таблица кодов ключа k — первые различные пары цифр, начиная с позиции k, через
+ * две цифры. Последовательность пар ключа k — последовательность ключа k + 2 с одной
+ * парой впереди, поэтому таблицы всех ключей строятся за один проход с конца
+ * строки на каждую чётность: новая пара переносится в начало списка первых вхождений.
+ *
+ * Каждый ключ расшифровывает только начало шифртекста (по плотной таблице на 100
+ * кодов) и оценивается моделью n-грамм; ключи оцениваются параллельно. Полностью
+ * расшифровываются лишь лучшие кандидаты — через PiCipher::build_codebooks и decrypt.
+ */
+class PiKeySolver {
+public:
+    static constexpr size_t CODES = 100;          ///< Двузначных кодов "00".."99"
+    static constexpr size_t DEFAULT_SAMPLE = 256; ///< Сколько кодов шифртекста расшифровывает каждый ключ
+
+    /// Таблица ключа: код → индекс буквы в алфавите или -1, если код не назначен.
+    using DecodeTable = std::array<std::int8_t, CODES>;
+
+    /**
+     * @brief Наибольший ключ, для которого build_codebooks берёт хотя бы одну пару.
+     */
+    static int maxKey();
+
+    /**
+     * @brief Таблицы декодирования всех ключей 1..maxKey() (элемент [key - 1]).
+     * @param alphabetSize Число букв алфавита (коды получают первые min(alphabetSize, 100) букв).
+     * @return Таблицы, совпадающие с dec_map из PiCipher::build_codebooks.
+     */
+    static std::vector<DecodeTable> decodeTables(size_t alphabetSize);
+
+    /**
+     * @brief Перебирает все ключи и возвращает лучшие решения.
+     *
+     * Коды, не назначенные ключом, и пары не из цифр штрафуются нижней границей
+     * модели; буквы алфавита, которых нет в модели, в оценке пропускаются.
+     *
+     * @param ciphertext Шифртекст (пары цифр).
+     * @param alphabet Алфавит, которым строились коды.
+     * @param model Модель n-грамм языка открытого текста.
+     * @param top Сколько лучших ключей расшифровать полностью и вернуть.
+     * @param sample Сколько кодов шифртекста расшифровывать для оценки каждого ключа.
+     * @return Кандидаты, упорядоченные от лучшего к худшему.
+     * @throw std::invalid_argument Если алфавит пуст.
+     */
+    static std::vector<PiKeyCandidate> solve(const std::wstring& ciphertext, const std::wstring& alphabet,
+                                             const NgramModel& model, size_t top = 3,
+                                             size_t sample = DEFAULT_SAMPLE);
+};
+
+#endif // PI_KEY_SOLVER_H
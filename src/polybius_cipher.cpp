@@ -4,8 +4,94 @@
  */
 
 #include "polybius_cipher.h"
+#include "cipher_batch.h"
+#include "metrics.h"
+#include "alphabet_traits.h"
+#include <algorithm>
 #include <cwctype>
 
+namespace
+{
+    constexpr int BOARD_CELLS = 64; ///< Число клеток доски 8x8
+
+    /**
+     * @brief Позиция первой буквы встроенного алфавита на доске.
+     *
+     * Проверяет, что доска построена build_board из алфавита Alphabet: буквы стоят
+     * подряд (по модулю 64) и больше нигде не встречаются.
+     *
+     * @return Линейная позиция первой буквы или -1, если доска устроена иначе.
+     */
+    template <class Alphabet>
+    int builtinBoardStart(const std::vector<std::vector<wchar_t>>& board)
+    {
+        if (board.size() != 8) return -1;
+        for (const auto& row : board) {
+            if (row.size() != 8) return -1;
+        }
+
+        int start = -1;
+        for (int i = 0; i < BOARD_CELLS && start < 0; ++i) {
+            if (board[i / 8][i % 8] == Alphabet::at(0)) start = i;
+        }
+        if (start < 0) return -1;
+
+        for (int i = 0; i < BOARD_CELLS; ++i) {
+            wchar_t cell = board[i / 8][i % 8];
+            int rel = (i - start + BOARD_CELLS) % BOARD_CELLS;
+            bool expectLetter = rel < Alphabet::size();
+            if (expectLetter ? cell != Alphabet::at(rel) : Alphabet::indexOf(cell) >= 0) {
+                return -1;
+            }
+        }
+        return start;
+    }
+
+    /**
+     * @brief Цикл шифрования; coordsOf возвращает (строка, столбец) символа или (-1, -1).
+     * @return Число отброшенных символов, которых нет на доске.
+     */
+    template <class CoordsOf, class String>
+    size_t encryptWith(std::wstring_view text, CoordsOf&& coordsOf, String& res)
+    {
+        size_t dropped = 0;
+        res.reserve(res.size() + 2 * text.size());
+        for (wchar_t c : text) {
+            if (c == L' ' || c == L'\t' || c == L'\n') {
+                res += L' ';
+                continue;
+            }
+
+            auto coords = coordsOf(c);
+            if (coords.first == -1) {
+                ++dropped;
+                continue;
+            }
+
+            wchar_t col_letter = L'a' + coords.second;
+            wchar_t row_digit = L'1' + coords.first;
+
+            res += col_letter;
+            res += row_digit;
+        }
+        return dropped;
+    }
+
+    /**
+     * @brief Шифрование для доски из встроенного алфавита: координаты вычисляются по индексу буквы.
+     */
+    template <class Alphabet, class String>
+    size_t encryptContiguous(std::wstring_view text, int start, String& res)
+    {
+        return encryptWith(text, [start](wchar_t c) -> std::pair<int, int> {
+            int idx = upperIndexOf(Alphabet{}, c);
+            if (idx < 0) return { -1, -1 };
+            int pos = (start + idx) % BOARD_CELLS;
+            return { pos / 8, pos % 8 };
+        }, res);
+    }
+}
+
 /**
  * @brief Построение матрицы Polybius размером 8x8 на основе алфавита и ключа.
  */
@@ -13,7 +99,7 @@ std::vector<std::vector<wchar_t>> PolybiusCipher::build_board(const std::wstring
     std::vector<std::vector<wchar_t>> board(8, std::vector<wchar_t>(8, L' '));
     std::vector<wchar_t> full_alpha(64, L' ');
 
-    key %= 64;
+    key = ((key % 64) + 64) % 64; // отрицательный ключ — сдвиг в другую сторону
     int n = alphabet.size();
 
     for (int i = 0; i < n; ++i)
@@ -40,34 +126,39 @@ std::pair<int, int> PolybiusCipher::find_coords(const std::vector<std::vector<wc
 }
 
 /**
- * @brief Шифрует текст.
+ * @brief Шифрует текст, дописывая координаты в res.
+ *
+ * Для досок из EN_ALPHABET/RU_ALPHABET координаты вычисляются арифметически,
+ * для остальных — поиском по доске.
  */
-std::wstring PolybiusCipher::encrypt(const std::wstring& text, const std::vector<std::vector<wchar_t>>& board) {
-    std::wstring res;
-    for (wchar_t c : text) {
-        if (c == L' ' || c == L'\t' || c == L'\n') {
-            res += L' ';
-            continue;
-        }
-
-        c = std::towupper(c);
-        auto coords = find_coords(board, c);
-        if (coords.first == -1) continue;
-
-        wchar_t col_letter = L'a' + coords.second;
-        wchar_t row_digit = L'1' + coords.first;
-
-        res += col_letter;
-        res += row_digit;
+template <class String>
+void PolybiusCipher::encryptInto(std::wstring_view text, const std::vector<std::vector<wchar_t>>& board, String& res) {
+    metrics::CallScope scope(CipherKind::Polybius, text.size(), res);
+    size_t dropped;
+    if (int start = builtinBoardStart<EnAlphabet>(board); start >= 0) {
+        dropped = encryptContiguous<EnAlphabet>(text, start, res);
+    } else if (int start = builtinBoardStart<RuAlphabet>(board); start >= 0) {
+        dropped = encryptContiguous<RuAlphabet>(text, start, res);
+    } else {
+        dropped = encryptWith(text, [&board](wchar_t c) {
+            return find_coords(board, std::towupper(c));
+        }, res);
     }
-    return res;
+    scope.dropped(dropped);
 }
 
 /**
- * @brief Дешифрует текст.
+ * @brief Дешифрует текст, дописывая символы в res.
  */
-std::wstring PolybiusCipher::decrypt(const std::wstring& code, const std::vector<std::vector<wchar_t>>& board) {
-    std::wstring res;
+template <class String>
+void PolybiusCipher::decryptInto(std::wstring_view code, const std::vector<std::vector<wchar_t>>& board, String& res) {
+    metrics::CallScope scope(CipherKind::Polybius, code.size(), res);
+    size_t dropped = 0;
+    // Пробел даёт один символ, пара координат — один: резерв без перевыделений.
+    size_t spaces = std::count_if(code.begin(), code.end(), [](wchar_t c) {
+        return c == L' ' || c == L'\t' || c == L'\n';
+    });
+    res.reserve(res.size() + spaces + (code.size() - spaces + 1) / 2);
     size_t i = 0;
     while (i < code.size()) {
         if (code[i] == L' ' || code[i] == L'\t' || code[i] == L'\n') {
@@ -76,7 +167,10 @@ std::wstring PolybiusCipher::decrypt(const std::wstring& code, const std::vector
             continue;
         }
 
-        if (i + 1 >= code.size()) break;
+        if (i + 1 >= code.size()) {
+            ++dropped;
+            break;
+        }
 
         int col = code[i] - L'a';
         int row = code[i + 1] - L'1';
@@ -84,7 +178,80 @@ std::wstring PolybiusCipher::decrypt(const std::wstring& code, const std::vector
 
         if (row >= 0 && row < 8 && col >= 0 && col < 8) {
             res += board[row][col];
+        } else {
+            dropped += 2;
         }
     }
+    scope.dropped(dropped);
+}
+
+/**
+ * @brief Шифрует текст.
+ */
+std::wstring PolybiusCipher::encrypt(const std::wstring& text, const std::vector<std::vector<wchar_t>>& board) {
+    std::wstring res;
+    encryptInto(text, board, res);
     return res;
 }
+
+/**
+ * @brief Дешифрует текст.
+ */
+std::wstring PolybiusCipher::decrypt(const std::wstring& code, const std::vector<std::vector<wchar_t>>& board) {
+    std::wstring res;
+    decryptInto(code, board, res);
+    return res;
+}
+
+/**
+ * @brief Шифрует текст в памяти вызывающего кода.
+ */
+std::pmr::wstring PolybiusCipher::encrypt(const std::wstring& text, const std::vector<std::vector<wchar_t>>& board,
+                                          std::pmr::memory_resource* mr) {
+    std::pmr::wstring res(mr);
+    encryptInto(text, board, res);
+    return res;
+}
+
+/**
+ * @brief Дешифрует текст в памяти вызывающего кода.
+ */
+std::pmr::wstring PolybiusCipher::decrypt(const std::wstring& code, const std::vector<std::vector<wchar_t>>& board,
+                                          std::pmr::memory_resource* mr) {
+    std::pmr::wstring res(mr);
+    decryptInto(code, board, res);
+    return res;
+}
+
+/**
+ * @brief Пакетная обработка: проверка доски на встроенный алфавит выполняется один раз.
+ */
+void PolybiusCipher::processBatch(const TextBatch& texts, const std::vector<std::vector<wchar_t>>& board,
+                                  bool encrypt, CipherBatch& out) {
+    if (!encrypt) {
+        out.appendEach(texts, [&board](std::wstring_view code, std::pmr::wstring& data) {
+            decryptInto(code, board, data);
+        });
+        return;
+    }
+
+    auto encryptEach = [&](auto&& encryptOne) {
+        out.appendEach(texts, [&](std::wstring_view text, std::pmr::wstring& data) {
+            metrics::CallScope scope(CipherKind::Polybius, text.size(), data);
+            scope.dropped(encryptOne(text, data));
+        });
+    };
+    if (int start = builtinBoardStart<EnAlphabet>(board); start >= 0) {
+        encryptEach([start](std::wstring_view text, std::pmr::wstring& data) {
+            return encryptContiguous<EnAlphabet>(text, start, data);
+        });
+    } else if (int start = builtinBoardStart<RuAlphabet>(board); start >= 0) {
+        encryptEach([start](std::wstring_view text, std::pmr::wstring& data) {
+            return encryptContiguous<RuAlphabet>(text, start, data);
+        });
+    } else {
+        encryptEach([&board](std::wstring_view text, std::pmr::wstring& data) {
+            return encryptWith(text, [&board](wchar_t c) { return find_coords(board, std::towupper(c)); }, data);
+        });
+    }
+}
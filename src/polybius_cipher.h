@@ -7,6 +7,11 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
+#include <memory_resource>
+
+class TextBatch;
+class CipherBatch;
 
 /**
  * @class PolybiusCipher
@@ -17,7 +22,7 @@ public:
     /**
      * @brief Построение матрицы Polybius 8x8 с циклическим сдвигом алфавита.
      * @param alphabet Алфавит.
-     * @param key Ключ-сдвиг (по модулю 64).
+     * @param key Ключ-сдвиг (по модулю 64, может быть отрицательным).
      * @return Матрица 8x8.
      */
     static std::vector<std::vector<wchar_t>> build_board(const std::wstring& alphabet, int key);
@@ -38,7 +43,46 @@ public:
      */
     static std::wstring decrypt(const std::wstring& code, const std::vector<std::vector<wchar_t>>& board);
 
+    /**
+     * @brief Шифрование текста с размещением результата в ресурсе памяти mr.
+     * @param text Открытый текст.
+     * @param board Матрица 8x8.
+     * @param mr Ресурс памяти вызывающего кода.
+     * @return Зашифрованный текст.
+     */
+    static std::pmr::wstring encrypt(const std::wstring& text, const std::vector<std::vector<wchar_t>>& board,
+                                     std::pmr::memory_resource* mr);
+
+    /**
+     * @brief Дешифрование текста с размещением результата в ресурсе памяти mr.
+     * @param code Зашифрованный текст.
+     * @param board Матрица 8x8.
+     * @param mr Ресурс памяти вызывающего кода.
+     * @return Расшифрованный текст.
+     */
+    static std::pmr::wstring decrypt(const std::wstring& code, const std::vector<std::vector<wchar_t>>& board,
+                                     std::pmr::memory_resource* mr);
+
+    /**
+     * @brief Шифрование или дешифрование пакета сообщений с дописыванием результатов в out.
+     *
+     * Устройство доски (встроенный алфавит или произвольная) определяется один раз на пакет.
+     *
+     * @param texts Входные сообщения.
+     * @param board Матрица 8x8.
+     * @param encrypt true — шифровать, false — дешифровать.
+     * @param[out] out Пакет результатов (см. cipher_batch.h).
+     */
+    static void processBatch(const TextBatch& texts, const std::vector<std::vector<wchar_t>>& board, bool encrypt,
+                             CipherBatch& out);
+
 private:
+    template <class String>
+    static void encryptInto(std::wstring_view text, const std::vector<std::vector<wchar_t>>& board, String& res);
+
+    template <class String>
+    static void decryptInto(std::wstring_view code, const std::vector<std::vector<wchar_t>>& board, String& res);
+
     /**
      * @brief Поиск координат символа на доске.
      * @param board Матрица 8x8.
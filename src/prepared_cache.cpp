@@ -0,0 +1,155 @@
+/**
+ * @file prepared_cache.cpp
+ * @brief Реализация сегментированного LRU-кэша подготовленных шифров.
+ */
+
+#include "prepared_cache.h"
+#include "alphabet_traits.h"
+#include "metrics.h"
+#include "simd_dispatch.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+    constexpr size_t NODE_OVERHEAD = 128; ///< Узлы списка и хеш-таблицы, блок управления shared_ptr
+    constexpr size_t MAP_NODE_BYTES = 96; ///< Узел unordered_map со строкой-кодом (PiCipher)
+    constexpr size_t XOR_KEY_BLOCK_MIN = 256;       ///< Длина повторённого ключа XORCipher (keyBlock)
+    constexpr size_t XOR_BITMAP_MAX_CODE = 0xFFFF;  ///< Больший код в алфавите — XORCipher без битовой карты
+    constexpr size_t UTF8_MAX_BYTES = 4;            ///< Байт UTF-8 на символ ключа, не больше
+}
+
+PreparedCipherCache::PreparedCipherCache(PreparedCacheOptions options)
+    : shardCount_(std::max<size_t>(1, options.shards)),
+      shardBudget_(options.maxBytes / shardCount_),
+      shards_(new Shard[shardCount_]) {}
+
+/**
+ * @brief Оценка сверху: точный размер зависит от реализации контейнеров.
+ */
+size_t PreparedCipherCache::entryBytes(const CipherSpec& spec) {
+    const size_t alphabetSize = spec.alphabet.empty() ? EN_ALPHABET.size() : spec.alphabet.size();
+    const size_t specBytes = sizeof(CipherSpec) + (spec.key.size() + spec.alphabet.size()) * sizeof(wchar_t);
+    size_t bytes = NODE_OVERHEAD + 2 * specBytes; // описание хранится в записи и в индексе
+
+    switch (spec.kind) {
+    case CipherKind::Xor: {
+        const std::wstring& alphabet = spec.alphabet.empty() ? EN_ALPHABET : spec.alphabet;
+        size_t maxCode = L' ';
+        for (wchar_t c : alphabet) maxCode = std::max(maxCode, static_cast<size_t>(c));
+        const size_t keyUtf8 = spec.key.size() * UTF8_MAX_BYTES;
+        // копия алфавита и его индекс, ключ и keyTable, keyBytes и keyBlock, allowedBits
+        bytes += alphabetSize * (2 * sizeof(wchar_t) + 2 * sizeof(short)) +
+                 (2 * spec.key.size() + simd::MAX_LANES) * sizeof(wchar_t) + 2 * keyUtf8 + XOR_KEY_BLOCK_MIN;
+        if (maxCode <= XOR_BITMAP_MAX_CODE) bytes += (maxCode / 64 + 1) * sizeof(std::uint64_t);
+        break;
+    }
+    case CipherKind::Gronsfeld:
+    case CipherKind::Affine:
+        // копия алфавита, его индекс и ключ
+        bytes += alphabetSize * (2 * sizeof(wchar_t) + 2 * sizeof(short)) + spec.key.size() * sizeof(int);
+        break;
+    case CipherKind::Vigenere:
+        // ключ и четыре таблицы сдвигов по period_ + MAX_LANES; period_ < длины ключа + MAX_LANES
+        bytes += (spec.key.size() + 4 * (spec.key.size() + 2 * simd::MAX_LANES)) * sizeof(wchar_t);
+        break;
+    case CipherKind::Polybius:
+        bytes += 8 * (sizeof(std::vector<wchar_t>) + 8 * sizeof(wchar_t));
+        break;
+    case CipherKind::Pi:
+        bytes += 2 * alphabetSize * MAP_NODE_BYTES;
+        break;
+    case CipherKind::RailFence:
+    case CipherKind::TurnGrid:
+    case CipherKind::Reverser:
+        break;
+    }
+    return bytes;
+}
+
+PreparedCipherCache::Shard& PreparedCipherCache::shardFor(const CipherSpec& spec) {
+    size_t h = CipherSpecHash()(spec);
+    return shards_[(h ^ (h >> 29)) % shardCount_];
+}
+
+/**
+ * @brief Вытесняет давно не использованные записи, пока сегмент не уложится в бюджет.
+ *
+ * Самая свежая запись (голова списка) не вытесняется.
+ */
+void PreparedCipherCache::evict(Shard& shard) {
+    while (shard.bytes > shardBudget_ && shard.lru.size() > 1) {
+        Entry& victim = shard.lru.back();
+        metrics::add(victim.spec.kind, metrics::Counter::CacheEvictions, 1);
+        shard.bytes -= victim.bytes;
+        shard.index.erase(victim.spec);
+        shard.lru.pop_back();
+        ++shard.evictions;
+    }
+}
+
+/**
+ * @brief Поиск под блокировкой сегмента; подготовка шифра — без неё.
+ *
+ * Ошибки ключа не попадают в кэш, а медленная подготовка одного ключа не
+ * задерживает запросы к другим ключам того же сегмента. Если два потока
+ * подготовили один ключ одновременно, в кэше остаётся первый результат.
+ */
+std::shared_ptr<const PreparedCipher> PreparedCipherCache::get(const CipherSpec& spec) {
+    Shard& shard = shardFor(spec);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(spec);
+        if (it != shard.index.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            ++shard.hits;
+            metrics::add(spec.kind, metrics::Counter::CacheHits, 1);
+            return it->second->cipher;
+        }
+    }
+
+    auto cipher = PreparedCipher::create(spec);
+    const size_t bytes = entryBytes(spec);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ++shard.misses;
+    metrics::add(spec.kind, metrics::Counter::CacheMisses, 1);
+    auto it = shard.index.find(spec);
+    if (it != shard.index.end()) {
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return it->second->cipher;
+    }
+    if (bytes > shardBudget_) {
+        return cipher;
+    }
+
+    shard.lru.push_front(Entry{spec, cipher, bytes});
+    shard.index.emplace(spec, shard.lru.begin());
+    shard.bytes += bytes;
+    evict(shard);
+    return cipher;
+}
+
+PreparedCacheStats PreparedCipherCache::stats() const {
+    PreparedCacheStats total;
+    for (size_t i = 0; i < shardCount_; ++i) {
+        const Shard& shard = shards_[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total.hits += shard.hits;
+        total.misses += shard.misses;
+        total.evictions += shard.evictions;
+        total.entries += shard.lru.size();
+        total.bytes += shard.bytes;
+    }
+    return total;
+}
+
+void PreparedCipherCache::clear() {
+    for (size_t i = 0; i < shardCount_; ++i) {
+        Shard& shard = shards_[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.lru.clear();
+        shard.bytes = 0;
+    }
+}
@@ -0,0 +1,100 @@
+/**
+ * @file prepared_cache.h
+ * @brief Потокобезопасный LRU-кэш подготовленных шифров с ограничением памяти.
+ *
+ * Ключ кэша — CipherSpec (шифр, ключ, алфавит), значение — неизменяемый
+ * PreparedCipher. Кэш разбит на сегменты со своими мьютексами, поэтому
+ * потоки, запрашивающие разные ключи, почти не конкурируют за блокировку.
+ */
+
+#ifndef PREPARED_CACHE_H
+#define PREPARED_CACHE_H
+
+#include "cipher_service.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * @brief Параметры кэша.
+ */
+struct PreparedCacheOptions {
+    size_t shards = 16;          ///< Число сегментов
+    size_t maxBytes = 64 << 20;  ///< Ограничение памяти на весь кэш (оценка), байт
+};
+
+/**
+ * @brief Счётчики кэша.
+ */
+struct PreparedCacheStats {
+    std::uint64_t hits = 0;      ///< Найдено в кэше
+    std::uint64_t misses = 0;    ///< Подготовлено заново
+    std::uint64_t evictions = 0; ///< Вытеснено по ограничению памяти
+    size_t entries = 0;          ///< Записей сейчас
+    size_t bytes = 0;            ///< Оценка занятой памяти, байт
+};
+
+/**
+ * @class PreparedCipherCache
+ * @brief Сегментированный LRU-кэш CipherSpec -> PreparedCipher.
+ *
+ * Каждому сегменту отводится maxBytes / shards байт; при превышении вытесняются
+ * давно не использованные записи. Запись, которая одна больше доли сегмента,
+ * возвращается вызывающему, но не кэшируется. Вытесненный шифр живёт, пока
+ * на него есть shared_ptr у выполняющихся запросов.
+ */
+class PreparedCipherCache {
+public:
+    explicit PreparedCipherCache(PreparedCacheOptions options = {});
+
+    /**
+     * @brief Подготовленный шифр для spec: из кэша или созданный заново.
+     * @throw std::invalid_argument, std::runtime_error Как PreparedCipher::create.
+     */
+    std::shared_ptr<const PreparedCipher> get(const CipherSpec& spec);
+
+    /**
+     * @brief Сумма счётчиков всех сегментов.
+     */
+    PreparedCacheStats stats() const;
+
+    /**
+     * @brief Удаляет все записи (счётчики попаданий и промахов сохраняются).
+     */
+    void clear();
+
+    /**
+     * @brief Оценка памяти записи: описание, таблицы шифра и узлы контейнеров.
+     */
+    static size_t entryBytes(const CipherSpec& spec);
+
+private:
+    struct Entry {
+        CipherSpec spec;
+        std::shared_ptr<const PreparedCipher> cipher;
+        size_t bytes;
+    };
+
+    using LruList = std::list<Entry>;
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        LruList lru; ///< От недавно использованных к давно не использованным
+        std::unordered_map<CipherSpec, LruList::iterator, CipherSpecHash> index;
+        size_t bytes = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+    };
+
+    Shard& shardFor(const CipherSpec& spec);
+    void evict(Shard& shard);
+
+    size_t shardCount_;
+    size_t shardBudget_;
+    std::unique_ptr<Shard[]> shards_;
+};
+
+#endif // PREPARED_CACHE_H
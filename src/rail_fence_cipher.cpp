@@ -6,6 +6,8 @@
  */
 
 #include "rail_fence_cipher.h"
+#include "cipher_batch.h"
+#include "metrics.h"
 #include <vector>
 #include <stdexcept>
 
@@ -18,26 +20,74 @@ RailFenceCipher::RailFenceCipher(int rails) : rails_(rails) {
     }
 }
 
+namespace
+{
+    /**
+     * @brief Перебирает позиции исходного текста в порядке шифртекста: рельс за рельсом.
+     *
+     * Рельс r зигзага с периодом cycle = 2 * (rails - 1) содержит позиции
+     * base + r и (кроме крайних рельс) base + cycle - r для base = 0, cycle, 2*cycle, ...
+     */
+    template <class F>
+    void forEachRailPosition(int rails, size_t length, F&& f)
+    {
+        const size_t cycle = 2 * static_cast<size_t>(rails - 1);
+        for (size_t r = 0; r < static_cast<size_t>(rails); ++r) {
+            for (size_t base = 0; base < length; base += cycle) {
+                if (base + r < length) f(base + r);
+                if (r != 0 && r != cycle / 2 && base + cycle - r < length) f(base + cycle - r);
+            }
+        }
+    }
+}
+
 /**
- * @brief Шифрует текст методом рельсовой погони.
+ * @brief Дописывает в out символы текста рельс за рельсом.
+ *
+ * Позиции каждого рельса вычисляются арифметически, поэтому промежуточные
+ * строки рельс не нужны.
  */
-std::wstring RailFenceCipher::encrypt(const std::wstring& text) const {
-    if (rails_ == 1 || text.empty()) return text;
+template <class String>
+void RailFenceCipher::encryptInto(std::wstring_view text, String& out) const {
+    metrics::CallScope scope(CipherKind::RailFence, text.size(), out);
+    if (rails_ == 1 || text.empty()) {
+        out.append(text.data(), text.size());
+        return;
+    }
 
-    std::vector<std::wstring> fence(rails_);
-    int rail = 0;
-    int direction = 1;
+    out.reserve(out.size() + text.size());
+    forEachRailPosition(rails_, text.size(), [&](size_t pos) {
+        out += text[pos];
+    });
+}
 
-    for (wchar_t c : text) {
-        fence[rail] += c;
-        rail += direction;
-        if (rail == rails_ - 1 || rail == 0) direction = -direction;
+/**
+ * @brief Восстанавливает исходный порядок символов и дописывает его в out.
+ *
+ * k-й символ шифртекста возвращается на k-ю позицию в порядке обхода рельс.
+ */
+template <class String>
+void RailFenceCipher::decryptInto(std::wstring_view text, String& out) const {
+    metrics::CallScope scope(CipherKind::RailFence, text.size(), out);
+    if (rails_ == 1 || text.empty()) {
+        out.append(text.data(), text.size());
+        return;
     }
 
+    size_t base = out.size();
+    out.resize(base + text.size());
+    size_t k = 0;
+    forEachRailPosition(rails_, text.size(), [&](size_t pos) {
+        out[base + pos] = text[k++];
+    });
+}
+
+/**
+ * @brief Шифрует текст методом рельсовой погони.
+ */
+std::wstring RailFenceCipher::encrypt(const std::wstring& text) const {
     std::wstring encrypted;
-    for (const auto& rail_str : fence) {
-        encrypted += rail_str;
-    }
+    encryptInto(text, encrypted);
     return encrypted;
 }
 
@@ -45,37 +95,54 @@ std::wstring RailFenceCipher::encrypt(const std::wstring& text) const {
  * @brief Дешифрует текст, зашифрованный методом рельсовой погони.
  */
 std::wstring RailFenceCipher::decrypt(const std::wstring& text) const {
-    if (rails_ == 1 || text.empty()) return text;
+    std::wstring decrypted;
+    decryptInto(text, decrypted);
+    return decrypted;
+}
 
-    std::vector<int> rail_indices(text.size());
-    int rail = 0, direction = 1;
-    for (size_t i = 0; i < text.size(); ++i) {
-        rail_indices[i] = rail;
-        rail += direction;
-        if (rail == rails_ - 1 || rail == 0) direction = -direction;
-    }
+/**
+ * @brief Шифрует текст, выделяя всю память из ресурса mr.
+ */
+std::pmr::wstring RailFenceCipher::encrypt(const std::wstring& text, std::pmr::memory_resource* mr) const {
+    std::pmr::wstring encrypted(mr);
+    encryptInto(text, encrypted);
+    return encrypted;
+}
 
-    std::vector<size_t> rail_lengths(rails_, 0);
-    for (int r : rail_indices) {
-        rail_lengths[r]++;
-    }
+/**
+ * @brief Дешифрует текст, выделяя всю память из ресурса mr.
+ */
+std::pmr::wstring RailFenceCipher::decrypt(const std::wstring& text, std::pmr::memory_resource* mr) const {
+    std::pmr::wstring decrypted(mr);
+    decryptInto(text, decrypted);
+    return decrypted;
+}
 
-    std::vector<std::wstring> fence(rails_);
-    size_t pos = 0;
-    for (int r = 0; r < rails_; ++r) {
-        fence[r] = text.substr(pos, rail_lengths[r]);
-        pos += rail_lengths[r];
+/**
+ * @brief Пакетная обработка, результаты дописываются в out.
+ */
+void RailFenceCipher::processBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const {
+    if (encrypt) {
+        out.appendEach(texts, [this](std::wstring_view text, std::pmr::wstring& data) { encryptInto(text, data); });
+    } else {
+        out.appendEach(texts, [this](std::wstring_view text, std::pmr::wstring& data) { decryptInto(text, data); });
     }
+}
 
-    std::wstring decrypted;
-    rail = 0; direction = 1;
-    std::vector<size_t> rail_positions(rails_, 0);
-
-    for (size_t i = 0; i < text.size(); ++i) {
-        decrypted += fence[rail][rail_positions[rail]++];
-        rail += direction;
-        if (rail == rails_ - 1 || rail == 0) direction = -direction;
+/**
+ * @brief Перестановка позиций для текста длины length.
+ *
+ * Рельс r содержит позиции r и cycle - r каждого периода cycle = 2 * (rails - 1),
+ * поэтому перестановка строится без раскладки текста по рельсам.
+ */
+std::vector<size_t> RailFenceCipher::permutation(size_t length) const {
+    std::vector<size_t> src;
+    src.reserve(length);
+    if (rails_ == 1) {
+        for (size_t i = 0; i < length; ++i) src.push_back(i);
+        return src;
     }
 
-    return decrypted;
+    forEachRailPosition(rails_, length, [&src](size_t pos) { src.push_back(pos); });
+    return src;
 }
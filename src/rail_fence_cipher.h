@@ -2,6 +2,12 @@
 #define RAIL_FENCE_CIPHER_H
 
 #include <string>
+#include <string_view>
+#include <vector>
+#include <memory_resource>
+
+class TextBatch;
+class CipherBatch;
 
 /**
  * @class RailFenceCipher
@@ -33,8 +39,45 @@ public:
      */
     std::wstring decrypt(const std::wstring& text) const;
 
+    /**
+     * @brief Шифрует текст; результат и рельсы размещаются в ресурсе памяти mr.
+     * @param text Исходный текст.
+     * @param mr Ресурс памяти вызывающего кода.
+     * @return Зашифрованный текст.
+     */
+    std::pmr::wstring encrypt(const std::wstring& text, std::pmr::memory_resource* mr) const;
+
+    /**
+     * @brief Дешифрует текст; результат и временные буферы размещаются в mr.
+     * @param text Зашифрованный текст.
+     * @param mr Ресурс памяти вызывающего кода.
+     * @return Расшифрованный текст.
+     */
+    std::pmr::wstring decrypt(const std::wstring& text, std::pmr::memory_resource* mr) const;
+
+    /**
+     * @brief Шифрует или дешифрует пакет сообщений, дописывая результаты в out (см. cipher_batch.h).
+     * @param texts Входные сообщения.
+     * @param encrypt true — шифровать, false — дешифровать.
+     * @param[out] out Пакет результатов; рельсы берутся из его пула.
+     */
+    void processBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const;
+
+    /**
+     * @brief Перестановка позиций, которую выполняет шифрование текста длины length.
+     * @param length Длина текста.
+     * @return Вектор src: encrypt(text)[k] == text[src[k]].
+     */
+    std::vector<size_t> permutation(size_t length) const;
+
 private:
     int rails_;
+
+    template <class String>
+    void encryptInto(std::wstring_view text, String& out) const;
+
+    template <class String>
+    void decryptInto(std::wstring_view text, String& out) const;
 };
 
 #endif // RAIL_FENCE_CIPHER_H
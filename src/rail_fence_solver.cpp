@@ -0,0 +1,168 @@
+/**
+ * @file rail_fence_solver.cpp
+ * @brief Реализация подбора числа рельс для шифра рельсовой погони.
+ */
+
+#include "rail_fence_solver.h"
+#include "rail_fence_cipher.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cwctype>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace
+{
+    constexpr size_t SAMPLE_WINDOWS = 64;      ///< Сколько окон открытого текста оценивается
+    constexpr size_t SAMPLE_WINDOW_SIZE = 32;  ///< Длина одного окна
+
+    /**
+     * @brief Частые биграммы (в процентах) английского и русского языков.
+     */
+    const std::unordered_map<std::wstring, double>& bigramTable()
+    {
+        static const std::unordered_map<std::wstring, double> table = {
+            {L"TH", 3.56}, {L"HE", 3.07}, {L"IN", 2.43}, {L"ER", 2.05}, {L"AN", 1.99}, {L"RE", 1.85},
+            {L"ON", 1.76}, {L"AT", 1.49}, {L"EN", 1.45}, {L"ND", 1.35}, {L"TI", 1.34}, {L"ES", 1.34},
+            {L"OR", 1.28}, {L"TE", 1.20}, {L"OF", 1.17}, {L"ED", 1.17}, {L"IS", 1.13}, {L"IT", 1.12},
+            {L"AL", 1.09}, {L"AR", 1.07}, {L"ST", 1.05}, {L"TO", 1.04}, {L"NT", 1.04}, {L"NG", 0.95},
+            {L"SE", 0.93}, {L"HA", 0.93}, {L"AS", 0.87}, {L"OU", 0.87}, {L"IO", 0.83}, {L"LE", 0.83},
+            {L"VE", 0.83}, {L"CO", 0.79}, {L"ME", 0.79}, {L"DE", 0.76}, {L"HI", 0.76}, {L"RI", 0.73},
+            {L"RO", 0.73}, {L"IC", 0.70}, {L"NE", 0.69}, {L"EA", 0.69}, {L"RA", 0.69}, {L"CE", 0.65},
+            {L"СТ", 1.75}, {L"НО", 1.62}, {L"ТО", 1.55}, {L"НА", 1.52}, {L"ЕН", 1.50}, {L"ОВ", 1.38},
+            {L"НИ", 1.37}, {L"РА", 1.34}, {L"ВО", 1.31}, {L"КО", 1.30}, {L"ЛИ", 1.20}, {L"ПО", 1.18},
+            {L"ЕР", 1.16}, {L"РО", 1.14}, {L"ОС", 1.12}, {L"ГО", 1.10}, {L"ОР", 1.08}, {L"ТА", 1.06},
+            {L"АЛ", 1.05}, {L"ЕС", 1.02}, {L"ОЛ", 1.00}, {L"ЛА", 0.98}, {L"ОТ", 0.96}, {L"ЕЛ", 0.94},
+        };
+        return table;
+    }
+
+    /**
+     * @brief Начало каждой рельсы в шифртексте для данной длины.
+     */
+    std::vector<size_t> railStarts(size_t length, int rails)
+    {
+        const size_t cycle = 2 * static_cast<size_t>(rails - 1);
+        const size_t full = length / cycle;
+        const size_t rem = length % cycle;
+
+        std::vector<size_t> starts(rails, 0);
+        for (int r = 0; r + 1 < rails; ++r) {
+            size_t len;
+            if (r == 0) {
+                len = full + (rem > 0 ? 1 : 0);
+            } else {
+                len = 2 * full + (rem > static_cast<size_t>(r) ? 1 : 0) + (rem > cycle - r ? 1 : 0);
+            }
+            starts[r + 1] = starts[r] + len;
+        }
+        return starts;
+    }
+
+    /**
+     * @brief Позиция символа открытого текста в шифртексте при известных началах рельс.
+     */
+    size_t cipherIndexWithStarts(size_t plainIndex, int rails, const std::vector<size_t>& starts)
+    {
+        const size_t cycle = 2 * static_cast<size_t>(rails - 1);
+        const size_t k = plainIndex / cycle;
+        const size_t j = plainIndex % cycle;
+        const size_t rail = j < static_cast<size_t>(rails) ? j : cycle - j;
+
+        size_t offset;
+        if (rail == 0 || rail == static_cast<size_t>(rails - 1)) {
+            offset = k;
+        } else {
+            offset = 2 * k + (j > rail ? 1 : 0);
+        }
+        return starts[rail] + offset;
+    }
+
+    /**
+     * @brief Оценивает выборочные окна открытого текста без полной расшифровки.
+     */
+    double sampleScore(const std::wstring& ciphertext, int rails, const TextScorer& scorer)
+    {
+        const size_t n = ciphertext.size();
+        const std::vector<size_t> starts = railStarts(n, rails);
+
+        size_t windows = SAMPLE_WINDOWS;
+        size_t windowSize = SAMPLE_WINDOW_SIZE;
+        if (n <= windows * windowSize) {
+            windows = 1;
+            windowSize = n;
+        }
+        const size_t stride = n / windows;
+
+        std::wstring fragment;
+        double score = 0.0;
+        for (size_t w = 0; w < windows; ++w) {
+            fragment.clear();
+            size_t begin = w * stride;
+            for (size_t i = begin; i < begin + windowSize && i < n; ++i) {
+                fragment += ciphertext[cipherIndexWithStarts(i, rails, starts)];
+            }
+            score += scorer(fragment);
+        }
+        return score;
+    }
+}
+
+size_t RailFenceSolver::cipherIndex(size_t plainIndex, size_t length, int rails) {
+    if (rails < 2) {
+        throw std::invalid_argument("Number of rails must be at least 2");
+    }
+    return cipherIndexWithStarts(plainIndex, rails, railStarts(length, rails));
+}
+
+double RailFenceSolver::bigramScore(std::wstring_view fragment) {
+    const auto& table = bigramTable();
+    std::wstring pair(2, L' ');
+    double score = 0.0;
+    for (size_t i = 0; i + 1 < fragment.size(); ++i) {
+        pair[0] = towupper(fragment[i]);
+        pair[1] = towupper(fragment[i + 1]);
+        auto it = table.find(pair);
+        if (it != table.end()) {
+            score += std::log1p(it->second);
+        }
+    }
+    return score;
+}
+
+std::vector<RailFenceCandidate> RailFenceSolver::solve(const std::wstring& ciphertext, int maxRails,
+                                                       size_t top, const TextScorer& scorer) {
+    if (maxRails < 2) {
+        throw std::invalid_argument("Maximum number of rails must be at least 2");
+    }
+    if (ciphertext.size() < 2) {
+        return {};
+    }
+    // При числе рельс >= длины текста шифр не переставляет символы.
+    maxRails = static_cast<int>(std::min<size_t>(maxRails, ciphertext.size()));
+
+    std::vector<RailFenceCandidate> candidates;
+    for (int r = 2; r <= maxRails; ++r) {
+        candidates.push_back({r, 0.0, {}});
+    }
+
+    ThreadPool::shared().parallelFor(0, candidates.size(), 1, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            candidates[i].score = sampleScore(ciphertext, candidates[i].rails, scorer);
+        }
+    });
+
+    auto byScore = [](const RailFenceCandidate& a, const RailFenceCandidate& b) { return a.score > b.score; };
+    top = std::min(top, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + top, candidates.end(), byScore);
+    candidates.resize(top);
+
+    // Полная расшифровка и окончательная оценка только для лучших кандидатов.
+    for (auto& c : candidates) {
+        c.plaintext = RailFenceCipher(c.rails).decrypt(ciphertext);
+        c.score = scorer(c.plaintext);
+    }
+    std::sort(candidates.begin(), candidates.end(), byScore);
+    return candidates;
+}
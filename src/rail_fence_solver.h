@@ -0,0 +1,68 @@
+/**
+ * @file rail_fence_solver.h
+ * @brief Заголовочный файл для класса RailFenceSolver — подбор числа рельс для RailFenceCipher.
+ */
+
+#ifndef RAIL_FENCE_SOLVER_H
+#define RAIL_FENCE_SOLVER_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Кандидат решения шифра рельсовой погони.
+ */
+struct RailFenceCandidate {
+    int rails;              ///< Число рельс
+    double score;           ///< Оценка открытого текста (больше — лучше)
+    std::wstring plaintext; ///< Полностью расшифрованный текст
+};
+
+/**
+ * @brief Функция оценки фрагмента открытого текста (больше — лучше).
+ */
+using TextScorer = std::function<double(std::wstring_view fragment)>;
+
+/**
+ * @class RailFenceSolver
+ * @brief Подбор числа рельс для шифртекста RailFenceCipher.
+ *
+ * Шифр рельсовой погони — перестановка, поэтому позицию в шифртексте любой буквы
+ * открытого текста можно вычислить за O(1). Для каждого числа рельс оцениваются
+ * только выборочные окна открытого текста, а полностью расшифровываются лишь лучшие
+ * кандидаты. Числа рельс перебираются параллельно.
+ */
+class RailFenceSolver {
+public:
+    /**
+     * @brief Позиция в шифртексте символа открытого текста.
+     * @param plainIndex Индекс символа в открытом тексте.
+     * @param length Длина текста.
+     * @param rails Число рельс (>= 2).
+     * @return Индекс того же символа в шифртексте.
+     */
+    static size_t cipherIndex(size_t plainIndex, size_t length, int rails);
+
+    /**
+     * @brief Оценка по частым биграммам английского и русского языков.
+     *
+     * Учитываются только пары соседних букв без учёта регистра.
+     */
+    static double bigramScore(std::wstring_view fragment);
+
+    /**
+     * @brief Перебирает числа рельс от 2 до maxRails и возвращает лучшие решения.
+     * @param ciphertext Шифртекст.
+     * @param maxRails Максимальное число рельс.
+     * @param top Сколько лучших кандидатов расшифровать и вернуть.
+     * @param scorer Функция оценки открытого текста.
+     * @return Кандидаты, упорядоченные от лучшего к худшему.
+     * @throw std::invalid_argument Если maxRails < 2.
+     */
+    static std::vector<RailFenceCandidate> solve(const std::wstring& ciphertext, int maxRails,
+                                                 size_t top = 3, const TextScorer& scorer = bigramScore);
+};
+
+#endif // RAIL_FENCE_SOLVER_H
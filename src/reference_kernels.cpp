@@ -0,0 +1,208 @@
+/**
+ * @file reference_kernels.cpp
+ * @brief Эталонные реализации шифров — исходный код XORCipher, AffineCipher,
+ * GronsfeldCipher и VigenereCipher в виде свободных функций.
+ */
+
+#include "reference_kernels.h"
+#include <cstdlib>
+#include <cwctype>
+#include <stdexcept>
+
+namespace
+{
+    int charToInt(const std::wstring& alphabet, wchar_t c)
+    {
+        for (int i = 0; i < static_cast<int>(alphabet.size()); ++i) {
+            if (alphabet[i] == c) return i;
+        }
+        return -1;
+    }
+
+    int modInverse(int a, int m)
+    {
+        int m0 = m, x0 = 0, x1 = 1;
+        if (m == 1) return 0;
+        while (a > 1) {
+            int q = a / m;
+            int t = m;
+            m = a % m; a = t;
+            t = x0;
+            x0 = x1 - q * x0;
+            x1 = t;
+        }
+        if (x1 < 0) x1 += m0;
+        return x1;
+    }
+
+    wchar_t hexToChar(wchar_t h)
+    {
+        if (h >= L'0' && h <= L'9') return h - L'0';
+        if (h >= L'A' && h <= L'F') return h - L'A' + 10;
+        if (h >= L'a' && h <= L'f') return h - L'a' + 10;
+        throw std::runtime_error("Некорректный HEX-символ");
+    }
+
+    wchar_t vigenereLetter(wchar_t bukva, wchar_t bukvaKlyucha, bool shifrovat)
+    {
+        if (bukva == L' ' || !iswalpha(bukva))
+            return bukva;
+
+        wchar_t upper_a;
+        int alphabet_size;
+
+        if ((bukva >= L'A' && bukva <= L'Z') || (bukva >= L'a' && bukva <= L'z')) {
+            upper_a = iswupper(bukva) ? L'A' : L'a';
+            alphabet_size = 26;
+        } else if ((bukva >= L'А' && bukva <= L'Я') || (bukva >= L'а' && bukva <= L'я')) {
+            upper_a = iswupper(bukva) ? L'А' : L'а';
+            alphabet_size = 32;
+        } else {
+            return bukva;
+        }
+
+        wchar_t key_upper_a = iswupper(bukvaKlyucha) ? upper_a : towlower(upper_a);
+        int sdvig = towupper(bukvaKlyucha) - towupper(key_upper_a);
+        if (!shifrovat)
+            sdvig = -sdvig;
+
+        int normSdvig = (bukva - upper_a + sdvig + alphabet_size) % alphabet_size;
+        return static_cast<wchar_t>(normSdvig + upper_a);
+    }
+}
+
+namespace reference
+{
+    std::wstring xorProcess(std::wstring_view input, const std::wstring& key)
+    {
+        std::vector<wchar_t> result;
+        for (size_t i = 0; i < input.size(); ++i) {
+            if (input[i] == L' ') {
+                result.push_back(L' ');
+            } else {
+                result.push_back(input[i] ^ key[i % key.size()]);
+            }
+        }
+        return std::wstring(result.begin(), result.end());
+    }
+
+    std::wstring xorEncryptToHex(std::wstring_view text, const std::wstring& key, const std::wstring& alphabet)
+    {
+        for (wchar_t c : text) {
+            if (alphabet.find(c) == std::wstring::npos && c != L' ') {
+                throw std::runtime_error("Текст содержит символы не из алфавита");
+            }
+        }
+        std::wstring encrypted = xorProcess(text, key);
+        std::wstring result;
+        const wchar_t hex[] = L"0123456789ABCDEF";
+
+        for (wchar_t c : encrypted) {
+            result += hex[(c >> 4) & 0x0F];
+            result += hex[c & 0x0F];
+            result += L' ';
+        }
+        return result;
+    }
+
+    std::wstring xorDecryptFromHex(std::wstring_view hex, const std::wstring& key)
+    {
+        std::vector<wchar_t> bytes;
+        std::wstring cleanHex;
+
+        for (wchar_t c : hex) {
+            if ((c >= L'0' && c <= L'9') ||
+                (c >= L'A' && c <= L'F') ||
+                (c >= L'a' && c <= L'f')) {
+                cleanHex += towupper(c);
+            }
+        }
+
+        if (cleanHex.size() % 2 != 0) {
+            throw std::runtime_error("Некорректная длина HEX-строки");
+        }
+
+        for (size_t i = 0; i + 1 < cleanHex.size(); i += 2) {
+            wchar_t high = hexToChar(cleanHex[i]);
+            wchar_t low = hexToChar(cleanHex[i + 1]);
+            bytes.push_back((high << 4) | low);
+        }
+
+        return xorProcess(std::wstring(bytes.begin(), bytes.end()), key);
+    }
+
+    std::wstring affine(std::wstring_view text, int a, int b, const std::wstring& alphabet, bool encrypt)
+    {
+        const int m = static_cast<int>(alphabet.size());
+        const int a_inv = modInverse(a, m);
+        std::wstring result;
+        for (wchar_t c : text) {
+            if (c == L' ') {
+                result += L' ';
+                continue;
+            }
+            int index = charToInt(alphabet, towupper(c));
+            if (index == -1) {
+                result += c;
+            } else if (encrypt) {
+                result += alphabet[(a * index + b) % m];
+            } else {
+                result += alphabet[(a_inv * (index - b + m)) % m];
+            }
+        }
+        return result;
+    }
+
+    std::wstring gronsfeld(std::wstring_view text, const std::vector<int>& key, const std::wstring& alphabet,
+                           bool encrypt)
+    {
+        std::vector<int> normalized(key);
+        for (int& num : normalized) {
+            num = std::abs(num) % alphabet.size();
+        }
+
+        std::wstring result;
+        std::vector<int> fullKey(text.size());
+        for (size_t i = 0; i < text.size(); ++i) {
+            fullKey[i] = normalized[i % normalized.size()];
+        }
+
+        for (size_t i = 0; i < text.size(); ++i) {
+            wchar_t c = text[i];
+            size_t pos = alphabet.find(c);
+            if (pos != std::wstring::npos) {
+                int shift = fullKey[i] * (encrypt ? 1 : -1);
+                pos = (pos + shift + alphabet.size()) % alphabet.size();
+                result += alphabet[pos];
+            } else {
+                result += c;
+            }
+        }
+        return result;
+    }
+
+    std::wstring vigenere(std::wstring_view text, const std::wstring& key, bool encrypt)
+    {
+        std::wstring rezultat;
+        rezultat.reserve(text.length());
+        size_t poziciyaKlyucha = 0;
+
+        for (wchar_t c : text) {
+            if (!iswalpha(c) && c != L' ') {
+                rezultat += c;
+                continue;
+            }
+
+            wchar_t bukvaKlyucha = key[poziciyaKlyucha % key.length()];
+            if (c == L' ') {
+                rezultat += L' ';
+            } else {
+                rezultat += vigenereLetter(c, bukvaKlyucha, encrypt);
+            }
+
+            if (bukvaKlyucha != L' ')
+                poziciyaKlyucha++;
+        }
+        return rezultat;
+    }
+}
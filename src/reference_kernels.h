@@ -0,0 +1,56 @@
+/**
+ * @file reference_kernels.h
+ * @brief Эталонные реализации XOR, аффинного шифра, шифров Гронсфельда и Виженера.
+ *
+ * Это исходные, прямолинейные версии шифров: поиск по строке алфавита, результат
+ * собирается посимвольно. Они не используются в рабочем коде и служат образцом,
+ * с которым сверяются оптимизированные реализации (см. differential.h).
+ * Менять их можно только вместе с намеренным изменением поведения шифра.
+ */
+
+#ifndef REFERENCE_KERNELS_H
+#define REFERENCE_KERNELS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace reference
+{
+    /**
+     * @brief XOR с ключом; пробелы не меняются. Текст не проверяется.
+     */
+    std::wstring xorProcess(std::wstring_view input, const std::wstring& key);
+
+    /**
+     * @brief XOR с проверкой текста по алфавиту и запись в HEX (пара цифр и пробел на символ).
+     * @throw std::runtime_error Если текст содержит символы не из алфавита.
+     */
+    std::wstring xorEncryptToHex(std::wstring_view text, const std::wstring& key, const std::wstring& alphabet);
+
+    /**
+     * @brief Разбор HEX и XOR с ключом.
+     * @throw std::runtime_error Если число HEX-цифр нечётно.
+     */
+    std::wstring xorDecryptFromHex(std::wstring_view hex, const std::wstring& key);
+
+    /**
+     * @brief Аффинный шифр: (a*x + b) mod m и обратное преобразование.
+     *
+     * Буквы ищутся после towupper; пробелы и символы вне алфавита копируются.
+     */
+    std::wstring affine(std::wstring_view text, int a, int b, const std::wstring& alphabet, bool encrypt);
+
+    /**
+     * @brief Шифр Гронсфельда; ключ нормализуется как |k| mod m. Регистр учитывается.
+     */
+    std::wstring gronsfeld(std::wstring_view text, const std::vector<int>& key, const std::wstring& alphabet,
+                           bool encrypt);
+
+    /**
+     * @brief Шифр Виженера для латиницы и кириллицы; пробел в ключе не сдвигает позицию ключа.
+     */
+    std::wstring vigenere(std::wstring_view text, const std::wstring& key, bool encrypt);
+}
+
+#endif // REFERENCE_KERNELS_H
@@ -6,7 +6,10 @@
  */
 
 #include "reverser_cipher.h"
+#include "cipher_batch.h"
+#include "metrics.h"
 #include <algorithm>
+#include <stdexcept>
 #include <vector>
 
 /**
@@ -23,7 +26,8 @@
  * @param start Индекс начала блока.
  * @param end Индекс конца блока (не включительно).
  */
-void ReverserCipher::reverse_block(std::wstring& result, size_t start, size_t end) {
+template <class String>
+void ReverserCipher::reverse_block(String& result, size_t start, size_t end) {
     size_t left = start, right = end - 1;
     while (left < right) {
         std::swap(result[left], result[right]);
@@ -33,41 +37,82 @@ void ReverserCipher::reverse_block(std::wstring& result, size_t start, size_t en
 }
 
 /**
- * @brief Шифрует текст методом реверса по блокам.
- *
- * Текст разбивается на блоки фиксированного размера. Каждый блок инвертируется.
- * Если включён режим уменьшения, размер блока уменьшается на 1 после каждого шага,
- * но не может быть меньше 2.
+ * @brief Разворачивает блоки строки result на интервале [base, result.size()).
  *
- * @param text Исходный текст для шифрования.
- * @param block_size Начальный размер блока.
- * @param shrinking true — блоки уменьшаются, false — размер фиксирован.
- * @return Зашифрованный текст.
+ * Размер первого блока block_size; при shrinking каждый следующий на 1 меньше, но не меньше 2.
  */
-std::wstring ReverserCipher::encrypt(const std::wstring& text, int block_size, bool shrinking) {
-    std::wstring result = text;
-    size_t len = text.size();
+template <class String>
+void ReverserCipher::reverse_blocks(String& result, size_t base, int block_size, bool shrinking) {
+    size_t len = result.size() - base;
     size_t i = 0;
     int cur_block = block_size;
 
     while (i < len) {
         size_t end = std::min(i + static_cast<size_t>(cur_block), len);
-        reverse_block(result, i, end);
+        reverse_block(result, base + i, base + end);
         i += cur_block;
 
         if (shrinking && cur_block > 2) {
             --cur_block;
-            if (cur_block < 2) cur_block = 2;
         }
     }
-    return result;
+}
+
+/**
+ * @brief Шифрует текст методом реверса по блокам.
+ *
+ * Текст разбивается на блоки фиксированного размера. Каждый блок инвертируется.
+ * Если включён режим уменьшения, размер блока уменьшается на 1 после каждого шага,
+ * но не может быть меньше 2.
+ *
+ * @param text Исходный текст для шифрования.
+ * @param block_size Начальный размер блока.
+ * @param shrinking true — блоки уменьшаются, false — размер фиксирован.
+ * @param[out] out Строка, в которую дописывается результат.
+ */
+template <class String>
+void ReverserCipher::encryptInto(std::wstring_view text, int block_size, bool shrinking, String& out) {
+    metrics::CallScope scope(CipherKind::Reverser, text.size(), out);
+    size_t base = out.size();
+    out.append(text.data(), text.size());
+    reverse_blocks(out, base, block_size, shrinking);
 }
 
 /**
  * @brief Дешифрует текст, зашифрованный методом реверса по блокам.
  *
- * Для правильного восстановления текста блоки реверсируются в обратном порядке,
- * с использованием той же последовательности длин, что была при шифровании.
+ * Блоки не пересекаются, и разворот каждого обратим сам по себе, поэтому
+ * та же последовательность длин разворачивается на месте, без списка блоков.
+ *
+ * @param text Зашифрованный текст.
+ * @param block_size Начальный размер блока.
+ * @param shrinking true — блоки уменьшались при шифровании, false — размер фиксирован.
+ * @param[out] out Строка, в которую дописывается результат.
+ */
+template <class String>
+void ReverserCipher::decryptInto(std::wstring_view text, int block_size, bool shrinking, String& out) {
+    metrics::CallScope scope(CipherKind::Reverser, text.size(), out);
+    size_t base = out.size();
+    out.append(text.data(), text.size());
+    reverse_blocks(out, base, block_size, shrinking);
+}
+
+/**
+ * @brief Шифрует текст методом реверса по блокам.
+ *
+ * @param text Исходный текст для шифрования.
+ * @param block_size Начальный размер блока.
+ * @param shrinking true — блоки уменьшаются, false — размер фиксирован.
+ * @return Зашифрованный текст.
+ */
+std::wstring ReverserCipher::encrypt(const std::wstring& text, int block_size, bool shrinking) {
+    std::wstring result;
+    encryptInto(text, block_size, shrinking, result);
+    return result;
+}
+
+/**
+ * @brief Дешифрует текст, зашифрованный методом реверса по блокам.
  *
  * @param text Зашифрованный текст.
  * @param block_size Начальный размер блока.
@@ -75,31 +120,69 @@ std::wstring ReverserCipher::encrypt(const std::wstring& text, int block_size, b
  * @return Расшифрованный текст.
  */
 std::wstring ReverserCipher::decrypt(const std::wstring& text, int block_size, bool shrinking) {
-    std::vector<int> blocks;
-    size_t len = text.size();
-    int cur_block = block_size;
-    size_t i = 0;
+    std::wstring result;
+    decryptInto(text, block_size, shrinking, result);
+    return result;
+}
 
-    // Формируем последовательность длин блоков
-    while (i < len) {
-        int this_block = std::min(cur_block, static_cast<int>(len - i));
-        blocks.push_back(this_block);
-        i += this_block;
+/**
+ * @brief Шифрует текст методом реверса по блокам в памяти вызывающего кода.
+ *
+ * @param text Исходный текст для шифрования.
+ * @param block_size Начальный размер блока.
+ * @param shrinking true — блоки уменьшаются, false — размер фиксирован.
+ * @param mr Ресурс памяти для результата.
+ * @return Зашифрованный текст.
+ */
+std::pmr::wstring ReverserCipher::encrypt(const std::wstring& text, int block_size, bool shrinking,
+                                          std::pmr::memory_resource* mr) {
+    std::pmr::wstring result(mr);
+    encryptInto(text, block_size, shrinking, result);
+    return result;
+}
 
-        if (shrinking && cur_block > 2) {
-            --cur_block;
-            if (cur_block < 2) cur_block = 2;
-        }
-    }
+/**
+ * @brief Дешифрует текст методом реверса по блокам в памяти вызывающего кода.
+ *
+ * @param text Зашифрованный текст.
+ * @param block_size Начальный размер блока.
+ * @param shrinking true — блоки уменьшались при шифровании, false — размер фиксирован.
+ * @param mr Ресурс памяти для результата и списка длин блоков.
+ * @return Расшифрованный текст.
+ */
+std::pmr::wstring ReverserCipher::decrypt(const std::wstring& text, int block_size, bool shrinking,
+                                          std::pmr::memory_resource* mr) {
+    std::pmr::wstring result(mr);
+    decryptInto(text, block_size, shrinking, result);
+    return result;
+}
 
-    // Реверсируем блоки в обратном порядке
-    std::wstring result = text;
-    size_t pos = len;
+/**
+ * @brief Пакетная обработка, результаты дописываются в out.
+ */
+void ReverserCipher::processBatch(const TextBatch& texts, int block_size, bool shrinking, bool encrypt,
+                                  CipherBatch& out) {
+    out.appendEach(texts, [&](std::wstring_view text, std::pmr::wstring& data) {
+        if (encrypt) {
+            encryptInto(text, block_size, shrinking, data);
+        } else {
+            decryptInto(text, block_size, shrinking, data);
+        }
+    });
+}
 
-    for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
-        pos -= *it;
-        reverse_block(result, pos, pos + *it);
+/**
+ * @brief Перестановка позиций для текста длины length.
+ *
+ * Блоки разворачиваются тем же reverse_blocks, что и в encryptInto, но над вектором индексов.
+ */
+std::vector<size_t> ReverserCipher::permutation(size_t length, int block_size, bool shrinking) {
+    if (block_size < 1) {
+        throw std::invalid_argument("Block size must be positive");
     }
 
-    return result;
+    std::vector<size_t> src(length);
+    for (size_t i = 0; i < length; ++i) src[i] = i;
+    reverse_blocks(src, 0, block_size, shrinking);
+    return src;
 }
@@ -6,6 +6,12 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <vector>
+#include <memory_resource>
+
+class TextBatch;
+class CipherBatch;
 
 /**
  * @class ReverserCipher
@@ -31,6 +37,49 @@ public:
      */
     static std::wstring decrypt(const std::wstring& text, int block_size, bool shrinking);
 
+    /**
+     * @brief Шифрует текст; результат размещается в ресурсе памяти mr.
+     * @param text Исходный текст.
+     * @param block_size Размер блока.
+     * @param shrinking Если true — блоки уменьшаются.
+     * @param mr Ресурс памяти вызывающего кода.
+     * @return Зашифрованный текст.
+     */
+    static std::pmr::wstring encrypt(const std::wstring& text, int block_size, bool shrinking,
+                                     std::pmr::memory_resource* mr);
+
+    /**
+     * @brief Дешифрует текст; результат и список блоков размещаются в mr.
+     * @param text Зашифрованный текст.
+     * @param block_size Размер блока.
+     * @param shrinking Если true — блоки уменьшались.
+     * @param mr Ресурс памяти вызывающего кода.
+     * @return Расшифрованный текст.
+     */
+    static std::pmr::wstring decrypt(const std::wstring& text, int block_size, bool shrinking,
+                                     std::pmr::memory_resource* mr);
+
+    /**
+     * @brief Шифрует или дешифрует пакет сообщений, дописывая результаты в out (см. cipher_batch.h).
+     * @param texts Входные сообщения.
+     * @param block_size Размер блока.
+     * @param shrinking Если true — блоки уменьшаются.
+     * @param encrypt true — шифровать, false — дешифровать.
+     * @param[out] out Пакет результатов.
+     */
+    static void processBatch(const TextBatch& texts, int block_size, bool shrinking, bool encrypt,
+                             CipherBatch& out);
+
+    /**
+     * @brief Перестановка позиций, которую выполняет шифрование текста длины length.
+     * @param length Длина текста.
+     * @param block_size Размер блока (>= 1).
+     * @param shrinking Если true — блоки уменьшаются.
+     * @return Вектор src: encrypt(text)[k] == text[src[k]].
+     * @throw std::invalid_argument Если block_size < 1.
+     */
+    static std::vector<size_t> permutation(size_t length, int block_size, bool shrinking);
+
 private:
     /**
      * @brief Выполняет реверс блока символов.
@@ -38,5 +87,18 @@ private:
      * @param start Начало блока.
      * @param end Конец блока (не включительно).
      */
-    static void reverse_block(std::wstring& result, size_t start, size_t end);
+    template <class String>
+    static void reverse_block(String& result, size_t start, size_t end);
+
+    /**
+     * @brief Разворачивает все блоки строки result, начиная с позиции base.
+     */
+    template <class String>
+    static void reverse_blocks(String& result, size_t base, int block_size, bool shrinking);
+
+    template <class String>
+    static void encryptInto(std::wstring_view text, int block_size, bool shrinking, String& out);
+
+    template <class String>
+    static void decryptInto(std::wstring_view text, int block_size, bool shrinking, String& out);
 };
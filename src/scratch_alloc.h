@@ -0,0 +1,30 @@
+/**
+ * @file scratch_alloc.h
+ * @brief Вспомогательные псевдонимы для выделения временных буферов тем же аллокатором, что и у результата.
+ *
+ * Шифры реализуют основную логику как шаблон по типу строки-результата.
+ * Для std::wstring временные буферы берутся из обычной кучи, для std::pmr::wstring —
+ * из того же std::pmr::memory_resource, что передал вызывающий код.
+ */
+
+#ifndef SCRATCH_ALLOC_H
+#define SCRATCH_ALLOC_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Аллокатор строки String, перепривязанный к типу T.
+ */
+template <class String, class T>
+using rebind_alloc_t =
+    typename std::allocator_traits<typename String::allocator_type>::template rebind_alloc<T>;
+
+/**
+ * @brief Вектор временных данных, использующий аллокатор строки String.
+ */
+template <class String, class T>
+using scratch_vector = std::vector<T, rebind_alloc_t<String, T>>;
+
+#endif // SCRATCH_ALLOC_H
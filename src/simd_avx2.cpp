@@ -0,0 +1,91 @@
+/**
+ * @file simd_avx2.cpp
+ * @brief Векторные ядра на 256-битных регистрах (AVX2).
+ *
+ * Собирается с -mavx2 (/arch:AVX2); вызывается только через simd_dispatch.cpp после
+ * проверки процессора и поддержки регистров YMM операционной системой.
+ */
+
+#include "simd_kernels.h"
+#include <cwchar>
+#include <immintrin.h>
+
+namespace
+{
+    struct Ops {
+        using Vec = __m256i;
+        static constexpr std::size_t lanes = sizeof(Vec) / sizeof(wchar_t);
+
+        static Vec load(const wchar_t* p) { return _mm256_loadu_si256(reinterpret_cast<const Vec*>(p)); }
+        static void store(wchar_t* p, Vec v) { _mm256_storeu_si256(reinterpret_cast<Vec*>(p), v); }
+        static Vec blend(Vec a, Vec b, Vec mask) { return _mm256_blendv_epi8(a, b, mask); }
+        static unsigned maskBits(Vec mask) { return static_cast<unsigned>(_mm256_movemask_epi8(mask)); }
+        static Vec and_(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+        static Vec or_(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+        static Vec andnot(Vec a, Vec b) { return _mm256_andnot_si256(a, b); }
+        static Vec xor_(Vec a, Vec b) { return _mm256_xor_si256(a, b); }
+
+        /// Последняя дорожка нижней половины, размноженная в верхнюю (нижняя — нули).
+        static Vec carryToHighHalf(Vec x) {
+            Vec t = _mm256_permute2x128_si256(x, x, 0x08);
+#if WCHAR_MAX <= 0xFFFF
+            t = _mm256_shufflehi_epi16(t, 0xFF);
+#endif
+            return _mm256_shuffle_epi32(t, 0xFF);
+        }
+
+#if WCHAR_MAX > 0xFFFF
+        static Vec set1(int x) { return _mm256_set1_epi32(x); }
+        static Vec add(Vec a, Vec b) { return _mm256_add_epi32(a, b); }
+        static Vec sub(Vec a, Vec b) { return _mm256_sub_epi32(a, b); }
+        static Vec minu(Vec a, Vec b) { return _mm256_min_epu32(a, b); }
+        static Vec cmpeq(Vec a, Vec b) { return _mm256_cmpeq_epi32(a, b); }
+        static Vec cmpgt(Vec a, Vec b) { return _mm256_cmpgt_epi32(a, b); }
+        static Vec srli8(Vec a) { return _mm256_srli_epi32(a, 8); }
+        static Vec mullo(Vec a, Vec b) { return _mm256_mullo_epi32(a, b); }
+        /// (a * b) >> 16 для произведений меньше 2^32.
+        static Vec mulhi16(Vec a, Vec b) { return _mm256_srli_epi32(_mm256_mullo_epi32(a, b), 16); }
+
+        /// Дорожка i результата — дорожка idx[i] окна (idx[i] < lanes).
+        static Vec permute(Vec window, Vec idx) { return _mm256_permutevar8x32_epi32(window, idx); }
+
+        /// Включающая префиксная сумма по дорожкам: внутри половин сдвигами, затем перенос.
+        static Vec prefixSum(Vec x) {
+            x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+            x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+            return _mm256_add_epi32(x, carryToHighHalf(x));
+        }
+#else
+        static Vec set1(int x) { return _mm256_set1_epi16(static_cast<short>(x)); }
+        static Vec add(Vec a, Vec b) { return _mm256_add_epi16(a, b); }
+        static Vec sub(Vec a, Vec b) { return _mm256_sub_epi16(a, b); }
+        static Vec minu(Vec a, Vec b) { return _mm256_min_epu16(a, b); }
+        static Vec cmpeq(Vec a, Vec b) { return _mm256_cmpeq_epi16(a, b); }
+        static Vec cmpgt(Vec a, Vec b) { return _mm256_cmpgt_epi16(a, b); }
+        static Vec srli8(Vec a) { return _mm256_srli_epi16(a, 8); }
+        static Vec mullo(Vec a, Vec b) { return _mm256_mullo_epi16(a, b); }
+        static Vec mulhi16(Vec a, Vec b) { return _mm256_mulhi_epu16(a, b); }
+
+        /// _mm256_shuffle_epi8 не пересекает половины: выборка из обеих половин окна и смешивание.
+        static Vec permute(Vec window, Vec idx) {
+            Vec lo = _mm256_permute2x128_si256(window, window, 0x00);
+            Vec hi = _mm256_permute2x128_si256(window, window, 0x11);
+            Vec local = _mm256_and_si256(idx, _mm256_set1_epi16(7));
+            Vec bytes = _mm256_add_epi16(_mm256_mullo_epi16(local, _mm256_set1_epi16(0x0202)),
+                                         _mm256_set1_epi16(0x0100));
+            Vec fromHigh = _mm256_cmpgt_epi16(idx, _mm256_set1_epi16(7));
+            return _mm256_blendv_epi8(_mm256_shuffle_epi8(lo, bytes), _mm256_shuffle_epi8(hi, bytes), fromHigh);
+        }
+
+        static Vec prefixSum(Vec x) {
+            x = _mm256_add_epi16(x, _mm256_slli_si256(x, 2));
+            x = _mm256_add_epi16(x, _mm256_slli_si256(x, 4));
+            x = _mm256_add_epi16(x, _mm256_slli_si256(x, 8));
+            return _mm256_add_epi16(x, carryToHighHalf(x));
+        }
+#endif
+    };
+}
+
+#define SIMD_ISA avx2
+#include "simd_kernels_impl.h"
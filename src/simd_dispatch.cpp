@@ -0,0 +1,189 @@
+/**
+ * @file simd_dispatch.cpp
+ * @brief Определение набора инструкций, выбор ядра и скалярные варианты.
+ */
+
+#include "simd_dispatch.h"
+#include "simd_kernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(CIPHER_SIMD) && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace
+{
+    /**
+     * @brief Что поддерживают процессор и ОС (AVX2 требует сохранения регистров YMM ядром ОС).
+     */
+    simd::Level detectCpu()
+    {
+#if !defined(CIPHER_SIMD)
+        return simd::Level::Scalar;
+#elif defined(_MSC_VER)
+        int regs[4];
+        __cpuid(regs, 0);
+        const int maxLeaf = regs[0];
+        __cpuid(regs, 1);
+        const bool sse41 = (regs[2] & (1 << 19)) != 0;
+        const bool osxsave = (regs[2] & (1 << 27)) != 0;
+        bool avx2 = false;
+        if (maxLeaf >= 7 && osxsave && (_xgetbv(0) & 0x6) == 0x6) {
+            __cpuidex(regs, 7, 0);
+            avx2 = (regs[1] & (1 << 5)) != 0;
+        }
+        return avx2 ? simd::Level::Avx2 : sse41 ? simd::Level::Sse41 : simd::Level::Scalar;
+#else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return simd::Level::Avx2;
+        if (__builtin_cpu_supports("sse4.1")) return simd::Level::Sse41;
+        return simd::Level::Scalar;
+#endif
+    }
+
+    simd::Level levelFromEnvironment()
+    {
+        const char* value = std::getenv("CIPHER_SIMD");
+        if (value == nullptr) return simd::Level::Avx2;
+        for (simd::Level level : {simd::Level::Scalar, simd::Level::Sse41, simd::Level::Avx2}) {
+            if (std::strcmp(value, simd::levelName(level)) == 0) return level;
+        }
+        return simd::Level::Avx2;
+    }
+
+    std::atomic<simd::Level>& maxLevel()
+    {
+        static std::atomic<simd::Level> level(levelFromEnvironment());
+        return level;
+    }
+
+    /**
+     * @brief Скалярный вариант shiftContiguous с фазы start (хвост после векторов или весь текст).
+     */
+    std::size_t shiftScalar(const wchar_t* in, std::size_t start, std::size_t length, wchar_t* out,
+                            wchar_t first, int count, const wchar_t* shifts, std::size_t period)
+    {
+        std::size_t passthrough = 0;
+        std::size_t phase = start % period;
+        for (std::size_t i = start; i < length; ++i) {
+            unsigned long d = static_cast<unsigned long>(in[i]) - static_cast<unsigned long>(first);
+            if (d < static_cast<unsigned long>(count)) {
+                d += static_cast<unsigned long>(shifts[phase]);
+                if (d >= static_cast<unsigned long>(count)) d -= count;
+                out[i] = static_cast<wchar_t>(first + d);
+            } else {
+                out[i] = in[i];
+                ++passthrough;
+            }
+            if (++phase == period) phase = 0;
+        }
+        return passthrough;
+    }
+}
+
+namespace simd
+{
+    Level supportedLevel()
+    {
+        static const Level level = detectCpu();
+        return level;
+    }
+
+    Level activeLevel()
+    {
+        return std::min(supportedLevel(), maxLevel().load(std::memory_order_relaxed));
+    }
+
+    void setMaxLevel(Level level)
+    {
+        maxLevel().store(level, std::memory_order_relaxed);
+    }
+
+    const char* levelName(Level level)
+    {
+        switch (level) {
+        case Level::Sse41: return "sse4.1";
+        case Level::Avx2: return "avx2";
+        default: return "scalar";
+        }
+    }
+
+    std::size_t shiftContiguous(const wchar_t* in, std::size_t length, wchar_t* out,
+                                wchar_t first, int count, const wchar_t* shifts, std::size_t period)
+    {
+        std::size_t passthrough = 0;
+        std::size_t done = 0;
+#ifdef CIPHER_SIMD
+        switch (activeLevel()) {
+        case Level::Avx2:
+            done = avx2::shiftContiguous(in, length, out, first, count, shifts, period, passthrough);
+            break;
+        case Level::Sse41:
+            done = sse41::shiftContiguous(in, length, out, first, count, shifts, period, passthrough);
+            break;
+        default:
+            break;
+        }
+#endif
+        return passthrough + shiftScalar(in, done, length, out, first, count, shifts, period);
+    }
+
+    std::size_t vigenereBlocks(const wchar_t* in, std::size_t length, wchar_t* out,
+                               const VigenereTables& tables, std::size_t& keyPos)
+    {
+#ifdef CIPHER_SIMD
+        switch (activeLevel()) {
+        case Level::Avx2: return avx2::vigenereBlocks(in, length, out, tables, keyPos);
+        case Level::Sse41: return sse41::vigenereBlocks(in, length, out, tables, keyPos);
+        default: break;
+        }
+#endif
+        (void)in; (void)length; (void)out; (void)tables; (void)keyPos;
+        return 0;
+    }
+
+    std::size_t affineContiguous(const wchar_t* in, std::size_t length, wchar_t* out,
+                                 const AffineMap& map, std::size_t& passthrough)
+    {
+#ifdef CIPHER_SIMD
+        switch (activeLevel()) {
+        case Level::Avx2: return avx2::affineContiguous(in, length, out, map, passthrough);
+        case Level::Sse41: return sse41::affineContiguous(in, length, out, map, passthrough);
+        default: break;
+        }
+#endif
+        (void)in; (void)length; (void)out; (void)map; (void)passthrough;
+        return 0;
+    }
+
+    std::size_t xorAlphabet(const wchar_t* in, std::size_t length, wchar_t* out,
+                            const wchar_t* keys, std::size_t period, wchar_t first, int count)
+    {
+#ifdef CIPHER_SIMD
+        switch (activeLevel()) {
+        case Level::Avx2: return avx2::xorAlphabet(in, length, out, keys, period, first, count);
+        case Level::Sse41: return sse41::xorAlphabet(in, length, out, keys, period, first, count);
+        default: break;
+        }
+#endif
+        (void)in; (void)length; (void)out; (void)keys; (void)period; (void)first; (void)count;
+        return 0;
+    }
+
+    std::size_t letterBins(const wchar_t* in, std::size_t length, wchar_t* bins)
+    {
+#ifdef CIPHER_SIMD
+        switch (activeLevel()) {
+        case Level::Avx2: return avx2::letterBins(in, length, bins);
+        case Level::Sse41: return sse41::letterBins(in, length, bins);
+        default: break;
+        }
+#endif
+        (void)in; (void)length; (void)bins;
+        return 0;
+    }
+}
@@ -0,0 +1,167 @@
+/**
+ * @file simd_dispatch.h
+ * @brief Векторные ядра шифров для непрерывных алфавитов и выбор набора инструкций во время выполнения.
+ *
+ * Ядра для SSE4.1 и AVX2 собираются в отдельных единицах трансляции со своими флагами
+ * (опция CMake CIPHER_SIMD, только x86). При первом вызове определяется, что
+ * поддерживают процессор и ОС, и дальше используется лучший доступный вариант.
+ * Без CIPHER_SIMD, на других архитектурах и для хвостов короче вектора работает
+ * скалярный цикл с той же арифметикой.
+ *
+ * Строки обрабатываются как массивы wchar_t: по 32 бита на символ (Linux, macOS)
+ * или по 16 бит (Windows); ширина дорожки вектора совпадает с sizeof(wchar_t).
+ */
+
+#ifndef SIMD_DISPATCH_H
+#define SIMD_DISPATCH_H
+
+#include <cstddef>
+
+namespace simd
+{
+    /**
+     * @brief Набор инструкций, которым выполняются ядра.
+     */
+    enum class Level {
+        Scalar, ///< Обычный цикл
+        Sse41,  ///< 128-битные векторы
+        Avx2    ///< 256-битные векторы
+    };
+
+    /// Наибольшее число символов в одном векторе (AVX2, 16-битный wchar_t).
+    constexpr std::size_t MAX_LANES = 16;
+
+    /**
+     * @brief Лучший уровень, который поддерживают процессор, ОС и сборка.
+     */
+    Level supportedLevel();
+
+    /**
+     * @brief Уровень, которым выполняются ядра: supportedLevel(), ограниченный setMaxLevel().
+     *
+     * Начальное ограничение берётся из переменной окружения CIPHER_SIMD
+     * ("scalar", "sse4.1" или "avx2").
+     */
+    Level activeLevel();
+
+    /**
+     * @brief Ограничивает уровень сверху (тесты, сравнение скорости вариантов).
+     */
+    void setMaxLevel(Level level);
+
+    /**
+     * @brief Имя уровня: "scalar", "sse4.1" или "avx2".
+     */
+    const char* levelName(Level level);
+
+    /**
+     * @brief Периодический сдвиг символов непрерывного алфавита [first, first + count).
+     *
+     * out[i] = first + (in[i] - first + shifts[i % period]) mod count для символов алфавита,
+     * остальные копируются. Сдвиги лежат в [0, count); массив shifts должен содержать
+     * period + MAX_LANES элементов: shifts[t] == shifts[t % period], чтобы вектор сдвигов
+     * для любой фазы читался одной невыровненной загрузкой.
+     *
+     * @return Число символов вне алфавита.
+     */
+    std::size_t shiftContiguous(const wchar_t* in, std::size_t length, wchar_t* out,
+                                wchar_t first, int count, const wchar_t* shifts, std::size_t period);
+
+    /**
+     * @brief XOR с периодическим ключом и проверкой алфавита за один проход.
+     *
+     * out[i] = in[i] ^ keys[i % period], пробелы копируются. Массив keys содержит
+     * period + MAX_LANES элементов (keys[t] == keys[t % period]). Останавливается перед
+     * блоком, где есть символ вне [first, first + count) и не пробел, и перед хвостом
+     * короче вектора: вызывающий код дорабатывает их скалярно и сообщает позицию ошибки.
+     *
+     * @return Число обработанных символов (0 на скалярном уровне).
+     */
+    std::size_t xorAlphabet(const wchar_t* in, std::size_t length, wchar_t* out,
+                            const wchar_t* keys, std::size_t period, wchar_t first, int count);
+
+    /**
+     * @brief Аффинное отображение непрерывного алфавита [first, first + count) для affineContiguous.
+     *
+     * Индекс x переходит в (multiplier * x + offset) mod count; multiplier и offset
+     * лежат в [0, count), count <= 32. Строчные буквы [first + 0x20, first + 0x20 + count)
+     * при foldLower считаются заглавными (так их переводит towupper в обычных локалях).
+     */
+    struct AffineMap {
+        wchar_t first = 0;
+        int count = 1;
+        int multiplier = 1;
+        int offset = 0;
+        bool foldLower = false;
+    };
+
+    /**
+     * @brief Аффинный шифр для блоков из символов U+0000–U+00FF и U+0400–U+04FF.
+     *
+     * Индекс — умножение в дорожках, остаток по модулю count — редукция Барретта
+     * (умножение на floor((2^16 - 1) / count) и сдвиг вместо деления). Символы вне
+     * алфавита копируются смешиванием по маске. Останавливается перед блоком с другими
+     * символами (их регистр определяет towupper вызывающего кода) и перед хвостом
+     * короче вектора.
+     *
+     * @param[out] passthrough Увеличивается на число скопированных символов.
+     * @return Число обработанных символов (0 на скалярном уровне).
+     */
+    std::size_t affineContiguous(const wchar_t* in, std::size_t length, wchar_t* out,
+                                 const AffineMap& map, std::size_t& passthrough);
+
+    /**
+     * @brief Подготовленный ключ Виженера для vigenereBlocks.
+     *
+     * Для позиции ключа t таблицы хранят упакованные значения shift | threshold << 8
+     * отдельно для латиницы (m = 26) и кириллицы (m = 32): буква с индексом x
+     * переходит в (x + shift) mod m, а если x < threshold (исходная формула даёт
+     * отрицательный остаток), — ещё на m ниже, кроме случая нулевого остатка.
+     * Длина каждой таблицы period + MAX_LANES.
+     */
+    struct VigenereTables {
+        const wchar_t* latin = nullptr;    ///< Упакованные сдвиги для A–Z / a–z
+        const wchar_t* cyrillic = nullptr; ///< Упакованные сдвиги для А–Я / а–я
+        std::size_t period = 1;            ///< Период позиции ключа (или позиция остановки)
+        bool saturate = false;             ///< Позиция не растёт дальше period (в ключе пробел)
+        bool cyrillicLetters = false;      ///< А–я — буквы в текущей локали
+    };
+
+    /**
+     * @brief Шифр Виженера для блоков из ASCII и кириллицы А–я.
+     *
+     * Позиция ключа растёт на буквах и пробелах; номер позиции в каждой дорожке —
+     * префиксная сумма маски «продвигает ключ» внутри регистра, сдвиги выбираются
+     * перестановкой загруженного окна таблицы. Останавливается перед блоком, где есть
+     * другие символы (их классифицирует iswalpha вызывающего кода), и перед хвостом
+     * короче вектора.
+     *
+     * @param keyPos Позиция ключа на входе и на выходе.
+     * @return Число обработанных символов (0 на скалярном уровне).
+     */
+    std::size_t vigenereBlocks(const wchar_t* in, std::size_t length, wchar_t* out,
+                               const VigenereTables& tables, std::size_t& keyPos);
+
+    /// Корзина пробела в letterBins (после 26 латинских и 32 русских букв).
+    constexpr int LETTER_BIN_SPACE = 58;
+    /// Корзина остальных символов ASCII в letterBins.
+    constexpr int LETTER_BIN_OTHER = 59;
+    /// Прибавляется к корзине строчной буквы в letterBins.
+    constexpr int LETTER_BIN_LOWER = 64;
+
+    /**
+     * @brief Корзины гистограммы букв (letter_histogram.h) для блоков из ASCII и кириллицы А–я.
+     *
+     * bins[i] = 0–25 для A–Z, 26–57 для А–Я, то же плюс LETTER_BIN_LOWER для строчных,
+     * LETTER_BIN_SPACE для пробела, LETTER_BIN_OTHER для остальных символов ASCII.
+     * Классификация — сравнения и смешивание по маскам, без таблиц; сам подсчёт
+     * остаётся скалярным. Останавливается
+     * перед блоком с другими символами (их классифицирует вызывающий код, в том числе
+     * iswalpha) и перед хвостом короче вектора.
+     *
+     * @return Число обработанных символов (0 на скалярном уровне).
+     */
+    std::size_t letterBins(const wchar_t* in, std::size_t length, wchar_t* bins);
+}
+
+#endif // SIMD_DISPATCH_H
@@ -0,0 +1,39 @@
+/**
+ * @file simd_kernels.h
+ * @brief Объявления векторных ядер для каждого набора инструкций (используется simd_dispatch.cpp).
+ *
+ * Каждое ядро обрабатывает только целые векторы и возвращает число обработанных
+ * символов; хвост (и блоки, которые ядро не берёт) дорабатывает скалярный код.
+ */
+
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include "simd_dispatch.h"
+#include <cstddef>
+
+#ifdef CIPHER_SIMD
+
+#define SIMD_DECLARE_KERNELS(isa)                                                                 \
+    namespace simd::isa                                                                           \
+    {                                                                                             \
+        std::size_t shiftContiguous(const wchar_t* in, std::size_t length, wchar_t* out,          \
+                                    wchar_t first, int count, const wchar_t* shifts,              \
+                                    std::size_t period, std::size_t& passthrough);                \
+        std::size_t vigenereBlocks(const wchar_t* in, std::size_t length, wchar_t* out,           \
+                                   const VigenereTables& tables, std::size_t& keyPos);            \
+        std::size_t affineContiguous(const wchar_t* in, std::size_t length, wchar_t* out,         \
+                                     const AffineMap& map, std::size_t& passthrough);             \
+        std::size_t xorAlphabet(const wchar_t* in, std::size_t length, wchar_t* out,              \
+                                const wchar_t* keys, std::size_t period, wchar_t first, int count); \
+        std::size_t letterBins(const wchar_t* in, std::size_t length, wchar_t* bins);             \
+    }
+
+SIMD_DECLARE_KERNELS(sse41)
+SIMD_DECLARE_KERNELS(avx2)
+
+#undef SIMD_DECLARE_KERNELS
+
+#endif // CIPHER_SIMD
+
+#endif // SIMD_KERNELS_H
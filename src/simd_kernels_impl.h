@@ -0,0 +1,246 @@
+/**
+ * @file simd_kernels_impl.h
+ * @brief Тела векторных ядер, общие для всех наборов инструкций.
+ *
+ * Включается только из simd_sse41.cpp и simd_avx2.cpp. Перед включением файл
+ * определяет макрос SIMD_ISA (имя пространства имён) и в безымянном пространстве
+ * имён структуру Ops с операциями над дорожками ширины sizeof(wchar_t):
+ * lanes, load, store, set1, add, sub, minu, cmpeq, cmpgt, blend, maskBits, and_, or_,
+ * andnot, xor_, srli8, mullo, mulhi16 ((a * b) >> 16), permute (выбор дорожек окна по индексам)
+ * и prefixSum (включающая префиксная сумма по дорожкам).
+ *
+ * Кроме интринсиков здесь нельзя использовать встроенные функции из общих
+ * заголовков: их копии, собранные с флагами AVX2, компоновщик может выбрать
+ * и для остальной программы.
+ */
+
+#ifndef SIMD_ISA
+#error "simd_kernels_impl.h: define SIMD_ISA and Ops before including"
+#endif
+
+namespace
+{
+    using Vec = Ops::Vec;
+
+    /// Число единичных битов (без инструкции POPCNT, которой нет у части процессоров с SSE4.1).
+    inline unsigned bitCount(unsigned x)
+    {
+        x = x - ((x >> 1) & 0x55555555u);
+        x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+        x = (x + (x >> 4)) & 0x0F0F0F0Fu;
+        return (x * 0x01010101u) >> 24;
+    }
+
+    /// Число дорожек, где mask установлена (маска сравнения: все биты дорожки одинаковы).
+    inline unsigned laneCount(Vec mask)
+    {
+        return bitCount(Ops::maskBits(mask)) / sizeof(wchar_t);
+    }
+
+    /**
+     * @brief Индекс символа в непрерывном алфавите и маска принадлежности.
+     *
+     * d = c - first (по модулю 2^ширины); символ в алфавите, если d <= count - 1
+     * как беззнаковое: min(d, count - 1) == d.
+     */
+    struct RangeIndex {
+        Vec index;
+        Vec inRange;
+    };
+
+    inline RangeIndex rangeIndex(Vec c, Vec first, Vec last)
+    {
+        Vec d = Ops::sub(c, first);
+        return {d, Ops::cmpeq(Ops::minu(d, last), d)};
+    }
+
+    /// r mod m для r из [0, 2m): если r >= m, то r - m меньше r как беззнаковое.
+    inline Vec reduceOnce(Vec r, Vec m)
+    {
+        return Ops::minu(r, Ops::sub(r, m));
+    }
+
+    /// Маска дорожек с c из [lo, lo + count).
+    inline Vec inRange(Vec c, int lo, int count)
+    {
+        Vec d = Ops::sub(c, Ops::set1(lo));
+        return Ops::cmpeq(Ops::minu(d, Ops::set1(count - 1)), d);
+    }
+}
+
+namespace simd::SIMD_ISA
+{
+    std::size_t shiftContiguous(const wchar_t* in, std::size_t length, wchar_t* out,
+                                wchar_t first, int count, const wchar_t* shifts,
+                                std::size_t period, std::size_t& passthrough)
+    {
+        constexpr std::size_t W = Ops::lanes;
+        const Vec vFirst = Ops::set1(first);
+        const Vec vLast = Ops::set1(count - 1);
+        const Vec vCount = Ops::set1(count);
+        const std::size_t step = W % period;
+
+        std::size_t phase = 0;
+        std::size_t kept = 0;
+        std::size_t i = 0;
+        for (; i + W <= length; i += W) {
+            Vec c = Ops::load(in + i);
+            RangeIndex r = rangeIndex(c, vFirst, vLast);
+            Vec shifted = reduceOnce(Ops::add(r.index, Ops::load(shifts + phase)), vCount);
+            Ops::store(out + i, Ops::blend(c, Ops::add(shifted, vFirst), r.inRange));
+            kept += laneCount(r.inRange);
+            phase += step;
+            if (phase >= period) phase -= period;
+        }
+        passthrough += i - kept;
+        return i;
+    }
+
+    std::size_t vigenereBlocks(const wchar_t* in, std::size_t length, wchar_t* out,
+                               const VigenereTables& tables, std::size_t& keyPos)
+    {
+        constexpr std::size_t W = Ops::lanes;
+        const Vec one = Ops::set1(1);
+        const Vec low5 = Ops::set1(31);
+        const Vec lowByte = Ops::set1(0xFF);
+        const Vec latinFirst = Ops::set1(L'A');
+        const Vec cyrillicFirst = Ops::set1(L'А');
+        const Vec latinSize = Ops::set1(26);
+        const Vec cyrillicSize = Ops::set1(32);
+        const Vec space = Ops::set1(L' ');
+        const Vec caseBit = Ops::set1(0x20);
+        const Vec cyrillicLetters = Ops::set1(tables.cyrillicLetters ? -1 : 0);
+
+        std::size_t phase = tables.saturate ? keyPos : keyPos % tables.period;
+        std::size_t i = 0;
+        for (; i + W <= length; i += W) {
+            Vec c = Ops::load(in + i);
+            Vec cyrillic = inRange(c, L'А', 64);                     // А–Я и а–я
+            Vec known = Ops::or_(inRange(c, 0, 128), cyrillic);
+            if (laneCount(known) != W) break;                         // другие символы: скалярный код
+
+            Vec latin = inRange(Ops::or_(c, caseBit), L'a', 26);     // 'A'–'Z' | 0x20 == 'a'–'z'
+            Vec letter = Ops::or_(latin, Ops::and_(cyrillic, cyrillicLetters));
+            Vec advance = Ops::or_(letter, Ops::cmpeq(c, space));
+
+            // Позиция ключа в дорожке: фаза блока плюс число продвижений в дорожках левее.
+            Vec steps = Ops::and_(advance, one);
+            Vec before = Ops::sub(Ops::prefixSum(steps), steps);
+            Vec info = Ops::blend(Ops::permute(Ops::load(tables.latin + phase), before),
+                                  Ops::permute(Ops::load(tables.cyrillic + phase), before), cyrillic);
+            Vec shift = Ops::and_(info, lowByte);
+            Vec threshold = Ops::srli8(info);
+
+            Vec m = Ops::blend(latinSize, cyrillicSize, cyrillic);
+            Vec x = Ops::and_(Ops::sub(c, Ops::blend(latinFirst, cyrillicFirst, cyrillic)), low5);
+            Vec r = reduceOnce(Ops::add(x, shift), m);
+            Vec negative = Ops::andnot(Ops::cmpeq(r, Ops::set1(0)), Ops::cmpgt(threshold, x));
+            Vec shifted = Ops::sub(Ops::add(Ops::sub(c, x), r), Ops::and_(negative, m));
+            Ops::store(out + i, Ops::blend(c, shifted, letter));
+
+            phase += laneCount(advance);
+            if (tables.saturate) {
+                if (phase > tables.period) phase = tables.period;
+            } else if (phase >= tables.period) {
+                phase -= tables.period;
+            }
+        }
+        keyPos = phase;
+        return i;
+    }
+
+    std::size_t affineContiguous(const wchar_t* in, std::size_t length, wchar_t* out,
+                                 const AffineMap& map, std::size_t& passthrough)
+    {
+        constexpr std::size_t W = Ops::lanes;
+        const Vec first = Ops::set1(map.first);
+        const Vec lowerFirst = Ops::set1(map.first + 0x20);
+        const Vec last = Ops::set1(map.count - 1);
+        const Vec count = Ops::set1(map.count);
+        const Vec multiplier = Ops::set1(map.multiplier);
+        const Vec offset = Ops::set1(map.offset);
+        const Vec barrett = Ops::set1(0xFFFF / map.count);
+        const Vec fold = Ops::set1(map.foldLower ? -1 : 0);
+
+        std::size_t kept = 0;
+        std::size_t i = 0;
+        for (; i + W <= length; i += W) {
+            Vec c = Ops::load(in + i);
+            Vec known = Ops::or_(inRange(c, 0, 0x100), inRange(c, 0x400, 0x100));
+            if (laneCount(known) != W) break;                         // другие символы: скалярный код
+
+            RangeIndex upper = rangeIndex(c, first, last);
+            RangeIndex lower = rangeIndex(c, lowerFirst, last);
+            Vec folded = Ops::and_(lower.inRange, fold);
+            Vec x = Ops::blend(upper.index, lower.index, folded);
+            Vec inAlphabet = Ops::or_(upper.inRange, folded);
+
+            // v < count^2 <= 1024: частное Барретта меньше точного не больше чем на 1.
+            Vec v = Ops::add(Ops::mullo(x, multiplier), offset);
+            Vec q = Ops::mulhi16(v, barrett);
+            Vec r = reduceOnce(Ops::sub(v, Ops::mullo(q, count)), count);
+            Ops::store(out + i, Ops::blend(c, Ops::add(r, first), inAlphabet));
+            kept += laneCount(inAlphabet);
+        }
+        passthrough += i - kept;
+        return i;
+    }
+
+    std::size_t xorAlphabet(const wchar_t* in, std::size_t length, wchar_t* out,
+                            const wchar_t* keys, std::size_t period, wchar_t first, int count)
+    {
+        constexpr std::size_t W = Ops::lanes;
+        const Vec vFirst = Ops::set1(first);
+        const Vec vLast = Ops::set1(count - 1);
+        const Vec space = Ops::set1(L' ');
+        const std::size_t step = W % period;
+
+        std::size_t phase = 0;
+        std::size_t i = 0;
+        for (; i + W <= length; i += W) {
+            Vec c = Ops::load(in + i);
+            Vec isSpace = Ops::cmpeq(c, space);
+            Vec valid = Ops::or_(rangeIndex(c, vFirst, vLast).inRange, isSpace);
+            if (laneCount(valid) != W) break;                         // ошибку найдёт скалярный код
+
+            Ops::store(out + i, Ops::blend(Ops::xor_(c, Ops::load(keys + phase)), c, isSpace));
+            phase += step;
+            if (phase >= period) phase -= period;
+        }
+        return i;
+    }
+
+    std::size_t letterBins(const wchar_t* in, std::size_t length, wchar_t* bins)
+    {
+        constexpr std::size_t W = Ops::lanes;
+        const Vec caseBit = Ops::set1(0x20);
+        const Vec latinFirst = Ops::set1(L'a');
+        const Vec cyrillicFirst = Ops::set1(L'А');
+        const Vec low5 = Ops::set1(31);
+        const Vec cyrillicBase = Ops::set1(26);
+        const Vec space = Ops::set1(L' ');
+        const Vec spaceBin = Ops::set1(LETTER_BIN_SPACE);
+        const Vec otherBin = Ops::set1(LETTER_BIN_OTHER);
+
+        std::size_t i = 0;
+        for (; i + W <= length; i += W) {
+            Vec c = Ops::load(in + i);
+            Vec cyrillic = inRange(c, L'А', 64);                     // А–Я и а–я
+            Vec known = Ops::or_(inRange(c, 0, 128), cyrillic);
+            if (laneCount(known) != W) break;                         // другие символы: скалярный код
+
+            Vec lower = Ops::or_(c, caseBit);
+            Vec latin = inRange(lower, L'a', 26);
+            Vec fromA = Ops::sub(c, cyrillicFirst);
+            // Строчные: у латиницы бит 0x20 в коде, у кириллицы — в смещении от А (а–я = А + 32..63).
+            Vec lowerFlag = Ops::blend(Ops::and_(c, caseBit), Ops::and_(fromA, caseBit), cyrillic);
+            lowerFlag = Ops::add(lowerFlag, lowerFlag);               // 0x20 → LETTER_BIN_LOWER
+            Vec bin = Ops::blend(otherBin, spaceBin, Ops::cmpeq(c, space));
+            bin = Ops::blend(bin, Ops::add(Ops::sub(lower, latinFirst), lowerFlag), latin);
+            Vec cyrillicIndex = Ops::add(Ops::and_(fromA, low5), cyrillicBase);
+            bin = Ops::blend(bin, Ops::add(cyrillicIndex, lowerFlag), cyrillic);
+            Ops::store(bins + i, bin);
+        }
+        return i;
+    }
+}
@@ -0,0 +1,78 @@
+/**
+ * @file simd_sse41.cpp
+ * @brief Векторные ядра на 128-битных регистрах (SSE4.1).
+ *
+ * Собирается с -msse4.1; вызывается только через simd_dispatch.cpp после проверки процессора.
+ * SSE4.1 нужен ради беззнакового минимума (_mm_min_epu16/_mm_min_epu32), _mm_blendv_epi8
+ * и _mm_mullo_epi32; перестановка дорожек — _mm_shuffle_epi8 (SSSE3).
+ */
+
+#include "simd_kernels.h"
+#include <cwchar>
+#include <immintrin.h>
+
+namespace
+{
+    struct Ops {
+        using Vec = __m128i;
+        static constexpr std::size_t lanes = sizeof(Vec) / sizeof(wchar_t);
+
+        static Vec load(const wchar_t* p) { return _mm_loadu_si128(reinterpret_cast<const Vec*>(p)); }
+        static void store(wchar_t* p, Vec v) { _mm_storeu_si128(reinterpret_cast<Vec*>(p), v); }
+        static Vec blend(Vec a, Vec b, Vec mask) { return _mm_blendv_epi8(a, b, mask); }
+        static unsigned maskBits(Vec mask) { return static_cast<unsigned>(_mm_movemask_epi8(mask)); }
+        static Vec and_(Vec a, Vec b) { return _mm_and_si128(a, b); }
+        static Vec or_(Vec a, Vec b) { return _mm_or_si128(a, b); }
+        static Vec andnot(Vec a, Vec b) { return _mm_andnot_si128(a, b); }
+        static Vec xor_(Vec a, Vec b) { return _mm_xor_si128(a, b); }
+
+#if WCHAR_MAX > 0xFFFF
+        static Vec set1(int x) { return _mm_set1_epi32(x); }
+        static Vec add(Vec a, Vec b) { return _mm_add_epi32(a, b); }
+        static Vec sub(Vec a, Vec b) { return _mm_sub_epi32(a, b); }
+        static Vec minu(Vec a, Vec b) { return _mm_min_epu32(a, b); }
+        static Vec cmpeq(Vec a, Vec b) { return _mm_cmpeq_epi32(a, b); }
+        static Vec cmpgt(Vec a, Vec b) { return _mm_cmpgt_epi32(a, b); }
+        static Vec srli8(Vec a) { return _mm_srli_epi32(a, 8); }
+        static Vec mullo(Vec a, Vec b) { return _mm_mullo_epi32(a, b); }
+        /// (a * b) >> 16 для произведений меньше 2^32.
+        static Vec mulhi16(Vec a, Vec b) { return _mm_srli_epi32(_mm_mullo_epi32(a, b), 16); }
+
+        /// Дорожка i результата — дорожка idx[i] окна (idx[i] < lanes).
+        static Vec permute(Vec window, Vec idx) {
+            Vec bytes = _mm_add_epi32(_mm_mullo_epi32(idx, _mm_set1_epi32(0x04040404)), _mm_set1_epi32(0x03020100));
+            return _mm_shuffle_epi8(window, bytes);
+        }
+
+        /// Включающая префиксная сумма по дорожкам.
+        static Vec prefixSum(Vec x) {
+            x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+            return _mm_add_epi32(x, _mm_slli_si128(x, 8));
+        }
+#else
+        static Vec set1(int x) { return _mm_set1_epi16(static_cast<short>(x)); }
+        static Vec add(Vec a, Vec b) { return _mm_add_epi16(a, b); }
+        static Vec sub(Vec a, Vec b) { return _mm_sub_epi16(a, b); }
+        static Vec minu(Vec a, Vec b) { return _mm_min_epu16(a, b); }
+        static Vec cmpeq(Vec a, Vec b) { return _mm_cmpeq_epi16(a, b); }
+        static Vec cmpgt(Vec a, Vec b) { return _mm_cmpgt_epi16(a, b); }
+        static Vec srli8(Vec a) { return _mm_srli_epi16(a, 8); }
+        static Vec mullo(Vec a, Vec b) { return _mm_mullo_epi16(a, b); }
+        static Vec mulhi16(Vec a, Vec b) { return _mm_mulhi_epu16(a, b); }
+
+        static Vec permute(Vec window, Vec idx) {
+            Vec bytes = _mm_add_epi16(_mm_mullo_epi16(idx, _mm_set1_epi16(0x0202)), _mm_set1_epi16(0x0100));
+            return _mm_shuffle_epi8(window, bytes);
+        }
+
+        static Vec prefixSum(Vec x) {
+            x = _mm_add_epi16(x, _mm_slli_si128(x, 2));
+            x = _mm_add_epi16(x, _mm_slli_si128(x, 4));
+            return _mm_add_epi16(x, _mm_slli_si128(x, 8));
+        }
+#endif
+    };
+}
+
+#define SIMD_ISA sse41
+#include "simd_kernels_impl.h"
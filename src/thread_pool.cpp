@@ -0,0 +1,230 @@
+/**
+ * @file thread_pool.cpp
+ * @brief Реализация пула: очереди задач, перехват работы, ожидание с помощью и привязка к процессорам.
+ */
+
+#include "thread_pool.h"
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+    constexpr int IDLE_SPINS = 64;                                ///< Попыток найти задачу перед сном рабочего потока
+    constexpr auto HELP_WAIT = std::chrono::microseconds(50);     ///< Сколько ждущий цикл спит, если задач нет
+
+    thread_local const ThreadPool* currentPool = nullptr; ///< Пул, рабочим потоком которого является поток
+    thread_local size_t currentQueue = 0;                 ///< Его очередь
+
+    std::mutex sharedMutex;
+    std::unique_ptr<ThreadPool> sharedPool;
+    ThreadPoolOptions sharedOptions;
+
+    /**
+     * @brief Привязывает текущий поток к процессору (только Linux; ошибка не фатальна).
+     */
+    void pinCurrentThread(int cpu)
+    {
+#ifdef __linux__
+        if (cpu >= CPU_SETSIZE) return;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)cpu;
+#endif
+    }
+}
+
+/**
+ * @brief Цикл parallelFor: тело и число ещё не выполненных элементов.
+ *
+ * Последнее уменьшение remaining и уведомление идут под mutex: ждущий поток,
+ * увидев ноль, берёт mutex перед выходом, поэтому цикл на его стеке не
+ * уничтожается, пока другой поток к нему обращается.
+ */
+struct ThreadPool::Loop {
+    Loop(Invoke f, void* b, size_t g, size_t count) : invoke(f), body(b), grain(g), remaining(count) {}
+
+    Invoke invoke;
+    void* body;
+    size_t grain;
+    std::atomic<size_t> remaining;
+    std::atomic<bool> failed{false};
+    std::exception_ptr error; ///< Под mutex
+    std::mutex mutex;
+    std::condition_variable done;
+};
+
+struct ThreadPool::Task {
+    Loop* loop;
+    size_t first;
+    size_t last;
+};
+
+struct alignas(64) ThreadPool::Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks; ///< Владелец работает с конца, остальные забирают с начала
+};
+
+ThreadPool::ThreadPool(ThreadPoolOptions options) : options_(std::move(options)) {
+    for (int cpu : options_.cpus) {
+        if (cpu < 0) {
+            throw std::invalid_argument("CPU number must not be negative.");
+        }
+    }
+    size_t threads = options_.threads;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    }
+    for (size_t i = 0; i <= threads; ++i) queues_.push_back(std::make_unique<Queue>());
+    threads_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_) thread.join();
+}
+
+void ThreadPool::configureShared(ThreadPoolOptions options) {
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    if (sharedPool) {
+        throw std::logic_error("Shared thread pool is already running.");
+    }
+    sharedOptions = std::move(options);
+}
+
+ThreadPool& ThreadPool::shared() {
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    if (!sharedPool) sharedPool = std::make_unique<ThreadPool>(sharedOptions);
+    return *sharedPool;
+}
+
+size_t ThreadPool::ownQueue() const {
+    return currentPool == this ? currentQueue : queues_.size() - 1;
+}
+
+void ThreadPool::push(const Task& task) {
+    Queue& queue = *queues_[ownQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(task);
+    }
+    ++queued_;
+    if (sleeping_.load() != 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        wake_.notify_one();
+    }
+}
+
+bool ThreadPool::pop(Task& task) {
+    if (queued_.load() == 0) return false;
+    const size_t own = ownQueue();
+    {
+        Queue& queue = *queues_[own];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+            --queued_;
+            return true;
+        }
+    }
+    // Чужие очереди — с начала: там лежат самые крупные половины.
+    for (size_t k = 1; k < queues_.size(); ++k) {
+        Queue& queue = *queues_[(own + k) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            --queued_;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::execute(Task task) {
+    Loop& loop = *task.loop;
+    while (task.last - task.first > loop.grain) {
+        const size_t middle = task.first + (task.last - task.first) / 2;
+        push({&loop, middle, task.last});
+        task.last = middle;
+    }
+    if (!loop.failed.load()) {
+        try {
+            loop.invoke(loop.body, task.first, task.last);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(loop.mutex);
+            if (!loop.error) loop.error = std::current_exception();
+            loop.failed = true;
+        }
+    }
+    const size_t count = task.last - task.first;
+    std::lock_guard<std::mutex> lock(loop.mutex);
+    if (loop.remaining.fetch_sub(count) == count) loop.done.notify_all();
+}
+
+void ThreadPool::run(size_t begin, size_t end, size_t grain, Invoke invoke, void* body) {
+    if (end <= begin) return;
+    grain = std::max<size_t>(grain, 1);
+    if (threads_.empty() || end - begin <= grain) {
+        invoke(body, begin, end);
+        return;
+    }
+
+    Loop loop(invoke, body, grain, end - begin);
+    execute({&loop, begin, end});
+    // Пока цикл не закончен, поток выполняет задачи (свои, затем чужие), а не просто ждёт.
+    while (loop.remaining.load() != 0) {
+        Task task;
+        if (pop(task)) {
+            execute(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(loop.mutex);
+        loop.done.wait_for(lock, HELP_WAIT, [&] { return loop.remaining.load() == 0; });
+    }
+    std::lock_guard<std::mutex> lock(loop.mutex);
+    if (loop.error) std::rethrow_exception(loop.error);
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentQueue = index;
+    if (!options_.cpus.empty()) pinCurrentThread(options_.cpus[index % options_.cpus.size()]);
+
+    int idle = 0;
+    for (;;) {
+        Task task;
+        if (pop(task)) {
+            execute(task);
+            idle = 0;
+            continue;
+        }
+        if (++idle < IDLE_SPINS) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        ++sleeping_;
+        wake_.wait(lock, [&] { return queued_.load() != 0 || stopping_; });
+        --sleeping_;
+        if (stopping_) return;
+        idle = 0;
+    }
+}
@@ -0,0 +1,145 @@
+/**
+ * @file thread_pool.h
+ * @brief Общий пул потоков с перехватом работы для параллельных частей библиотеки.
+ *
+ * Модули анализа и подбора ключей не создают свои std::thread: они делят диапазон
+ * работы через ThreadPool::shared(). У каждого рабочего потока своя очередь задач;
+ * поток кладёт и берёт задачи со своего конца, а свободные потоки забирают их
+ * с противоположного конца чужих очередей. Поток, ждущий окончания цикла, не
+ * засыпает, а выполняет задачи сам, поэтому вложенный цикл (решатель внутри
+ * параллельного конвейера) не создаёт новых потоков и не перегружает ядра.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Параметры пула.
+ */
+struct ThreadPoolOptions {
+    size_t threads = 0;    ///< Рабочих потоков; 0 — hardware_concurrency() - 1 (вызывающий поток тоже работает)
+    std::vector<int> cpus; ///< Привязка: рабочий поток i — к процессору cpus[i % cpus.size()]; пусто — без привязки
+};
+
+/**
+ * @class ThreadPool
+ * @brief Пул рабочих потоков с очередями задач на поток и циклами parallelFor / parallelReduce.
+ *
+ * Цикл делится пополам, пока часть больше grain: правая половина кладётся в
+ * очередь текущего потока, левая делится дальше и выполняется. Потоки вне пула
+ * кладут задачи в общую очередь, которую рабочие потоки тоже просматривают.
+ * Исключение из тела цикла прерывает ещё не начатые части и передаётся
+ * вызывающему после их завершения.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Запускает рабочие потоки.
+     * @throw std::invalid_argument Если в cpus есть отрицательный номер процессора.
+     */
+    explicit ThreadPool(ThreadPoolOptions options = {});
+
+    /**
+     * @brief Останавливает рабочие потоки (циклы к этому моменту должны завершиться).
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Задаёт параметры общего пула; действует, если вызвана до первого shared().
+     * @throw std::logic_error Если общий пул уже запущен.
+     */
+    static void configureShared(ThreadPoolOptions options);
+
+    /**
+     * @brief Общий пул библиотеки (создаётся при первом обращении).
+     */
+    static ThreadPool& shared();
+
+    /** @brief Число рабочих потоков. */
+    size_t workers() const { return threads_.size(); }
+
+    /** @brief Сколько потоков выполняет цикл: рабочие и вызывающий. */
+    size_t concurrency() const { return threads_.size() + 1; }
+
+    /**
+     * @brief Вызывает body(first, last) для непересекающихся частей [begin, end).
+     * @param grain Части не длиннее grain не делятся дальше.
+     * @throw Первое исключение, выброшенное body.
+     */
+    template <class Body>
+    void parallelFor(size_t begin, size_t end, size_t grain, Body&& body)
+    {
+        using Function = std::remove_reference_t<Body>;
+        run(begin, end, grain,
+            [](void* f, size_t first, size_t last) { (*static_cast<Function*>(f))(first, last); },
+            const_cast<void*>(static_cast<const void*>(std::addressof(body))));
+    }
+
+    /**
+     * @brief Свёртка по частям: map(first, last) для частей по grain, затем combine слева направо.
+     *
+     * Части и порядок свёртки не зависят от числа потоков, поэтому результат
+     * (в том числе суммы double) повторяется от запуска к запуску.
+     */
+    template <class T, class Map, class Combine>
+    T parallelReduce(size_t begin, size_t end, size_t grain, T identity, Map&& map, Combine&& combine)
+    {
+        if (end <= begin) return identity;
+        grain = std::max<size_t>(grain, 1);
+        const size_t parts = (end - begin - 1) / grain + 1;
+        std::vector<T> partial(parts, identity);
+        parallelFor(0, parts, 1, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                const size_t from = begin + i * grain;
+                partial[i] = map(from, std::min(end, from + grain));
+            }
+        });
+        T result = std::move(identity);
+        for (T& part : partial) result = combine(std::move(result), std::move(part));
+        return result;
+    }
+
+private:
+    struct Loop;
+    struct Task;
+    struct Queue;
+    using Invoke = void (*)(void* body, size_t first, size_t last);
+
+    /// Общая часть parallelFor: делит диапазон, помогает выполнять задачи и ждёт окончания.
+    void run(size_t begin, size_t end, size_t grain, Invoke invoke, void* body);
+
+    /// Делит задачу до grain, кладя правые половины в очередь, и выполняет левую часть.
+    void execute(Task task);
+
+    void push(const Task& task);
+    bool pop(Task& task);
+    void workerLoop(size_t index);
+
+    /// Очередь текущего потока: своя у рабочего потока этого пула, общая у остальных.
+    size_t ownQueue() const;
+
+    ThreadPoolOptions options_;
+    std::vector<std::unique_ptr<Queue>> queues_; ///< По одной на рабочий поток и общая (последняя)
+    std::vector<std::thread> threads_;
+    std::atomic<size_t> queued_{0};              ///< Задач во всех очередях
+    std::atomic<size_t> sleeping_{0};            ///< Рабочих потоков, ждущих задач на wake_
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;                      ///< Под sleepMutex_
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,155 @@
+/**
+ * @file transposition_chain.cpp
+ * @brief Реализация композиции перестановочных шифров.
+ */
+
+#include "transposition_chain.h"
+#include "rail_fence_cipher.h"
+#include "reverser_cipher.h"
+#include "turn_grid_cipher.h"
+#include <stdexcept>
+#include <utility>
+
+TranspositionChain::TranspositionChain(size_t cacheCapacity) : cacheCapacity(cacheCapacity) {}
+
+TranspositionChain& TranspositionChain::addRailFence(int rails) {
+    RailFenceCipher cipher(rails);
+    return addStage([cipher](size_t length) { return cipher.permutation(length); });
+}
+
+TranspositionChain& TranspositionChain::addReverser(int block_size, bool shrinking) {
+    if (block_size < 1) {
+        throw std::invalid_argument("Block size must be positive");
+    }
+    return addStage([block_size, shrinking](size_t length) {
+        return ReverserCipher::permutation(length, block_size, shrinking);
+    });
+}
+
+TranspositionChain& TranspositionChain::addTurnGrid(int size) {
+    TurnGridCipher cipher(size);
+    cipher.permutation(0); // проверка решётки при построении цепочки
+    return addStage([cipher](size_t length) { return cipher.permutation(length); });
+}
+
+TranspositionChain& TranspositionChain::addStage(PermutationStage stage) {
+    stages.push_back(std::move(stage));
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cache.clear();
+    cacheOrder.clear();
+    return *this;
+}
+
+/**
+ * @brief Перемножает перестановки ступеней.
+ *
+ * Если ступень i даёт src_i, то после неё символ k взят из позиции
+ * total[src_i[k]] исходного текста. Произвольная ступень может вернуть
+ * перестановку другой длины, поэтому каждая ступень получает текущую длину.
+ */
+Permutation TranspositionChain::compose(size_t length) const {
+    Permutation total(length);
+    for (size_t i = 0; i < length; ++i) total[i] = i;
+
+    Permutation next;
+    for (const auto& stage : stages) {
+        Permutation src = stage(total.size());
+        next.resize(src.size());
+        for (size_t k = 0; k < src.size(); ++k) {
+            if (src[k] >= total.size()) {
+                throw std::logic_error("Permutation stage returned an out-of-range index.");
+            }
+            next[k] = total[src[k]];
+        }
+        total.swap(next);
+    }
+    return total;
+}
+
+/**
+ * @brief Составная перестановка из кэша или вычисленная заново.
+ *
+ * Кэш вытесняет давно не использованные длины, когда их больше cacheCapacity.
+ * Вычисление идёт без блокировки, поэтому параллельные вызовы не ждут друг друга.
+ */
+std::shared_ptr<const Permutation> TranspositionChain::permutation(size_t length) const {
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = cache.find(length);
+        if (it != cache.end()) {
+            cacheOrder.splice(cacheOrder.begin(), cacheOrder, it->second.second);
+            return it->second.first;
+        }
+    }
+
+    auto perm = std::make_shared<const Permutation>(compose(length));
+    if (cacheCapacity == 0) {
+        return perm;
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(length);
+    if (it != cache.end()) {
+        return it->second.first;
+    }
+    cacheOrder.push_front(length);
+    cache.emplace(length, std::make_pair(perm, cacheOrder.begin()));
+    if (cache.size() > cacheCapacity) {
+        cache.erase(cacheOrder.back());
+        cacheOrder.pop_back();
+    }
+    return perm;
+}
+
+/**
+ * @brief Один проход сбора: out[k] = text[src[k]].
+ */
+template <class String>
+void TranspositionChain::encryptInto(std::wstring_view text, String& out) const {
+    auto perm = permutation(text.size());
+    size_t base = out.size();
+    out.resize(base + perm->size());
+    for (size_t k = 0; k < perm->size(); ++k) {
+        out[base + k] = text[(*perm)[k]];
+    }
+}
+
+/**
+ * @brief Один проход разброса: out[src[k]] = text[k].
+ */
+template <class String>
+void TranspositionChain::decryptInto(std::wstring_view text, String& out) const {
+    auto perm = permutation(text.size());
+    if (perm->size() != text.size()) {
+        throw std::invalid_argument("Permutation is not invertible for this text length.");
+    }
+    size_t base = out.size();
+    out.resize(base + text.size());
+    for (size_t k = 0; k < perm->size(); ++k) {
+        out[base + (*perm)[k]] = text[k];
+    }
+}
+
+std::wstring TranspositionChain::encrypt(const std::wstring& text) const {
+    std::wstring result;
+    encryptInto(text, result);
+    return result;
+}
+
+std::wstring TranspositionChain::decrypt(const std::wstring& text) const {
+    std::wstring result;
+    decryptInto(text, result);
+    return result;
+}
+
+std::pmr::wstring TranspositionChain::encrypt(const std::wstring& text, std::pmr::memory_resource* mr) const {
+    std::pmr::wstring result(mr);
+    encryptInto(text, result);
+    return result;
+}
+
+std::pmr::wstring TranspositionChain::decrypt(const std::wstring& text, std::pmr::memory_resource* mr) const {
+    std::pmr::wstring result(mr);
+    decryptInto(text, result);
+    return result;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file transposition_chain.h
+ * @brief Заголовочный файл для класса TranspositionChain — композиция перестановочных шифров.
+ */
+
+#ifndef TRANSPOSITION_CHAIN_H
+#define TRANSPOSITION_CHAIN_H
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Перестановка позиций: результат[k] == вход[src[k]].
+ */
+using Permutation = std::vector<size_t>;
+
+/**
+ * @brief Ступень цепочки: перестановка для текста заданной длины.
+ */
+using PermutationStage = std::function<Permutation(size_t length)>;
+
+/**
+ * @class TranspositionChain
+ * @brief Последовательность перестановочных шифров, применяемая одним проходом.
+ *
+ * RailFenceCipher, ReverserCipher и TurnGridCipher переставляют позиции символов,
+ * не глядя на сами символы. Перестановки ступеней для данной длины текста
+ * перемножаются в одну, и результат собирается одним проходом по тексту.
+ * Составные перестановки кэшируются по длине текста.
+ */
+class TranspositionChain {
+public:
+    /**
+     * @brief Конструктор.
+     * @param cacheCapacity Сколько составных перестановок (по длинам) хранить в кэше.
+     */
+    explicit TranspositionChain(size_t cacheCapacity = 16);
+
+    /**
+     * @brief Добавляет ступень RailFenceCipher.
+     * @throw std::invalid_argument Если rails <= 0.
+     */
+    TranspositionChain& addRailFence(int rails);
+
+    /**
+     * @brief Добавляет ступень ReverserCipher.
+     * @throw std::invalid_argument Если block_size < 1.
+     */
+    TranspositionChain& addReverser(int block_size, bool shrinking);
+
+    /**
+     * @brief Добавляет ступень TurnGridCipher.
+     *
+     * В отличие от process(), пробелы переставляются наравне с остальными символами.
+     * @throw std::invalid_argument Если размер решётки нечётный.
+     * @throw std::runtime_error Если решётка этого размера некорректна.
+     */
+    TranspositionChain& addTurnGrid(int size);
+
+    /**
+     * @brief Добавляет произвольную перестановочную ступень.
+     */
+    TranspositionChain& addStage(PermutationStage stage);
+
+    /**
+     * @brief Составная перестановка для текста длины length.
+     * @return Перестановка; при повторных вызовах с той же длиной берётся из кэша.
+     */
+    std::shared_ptr<const Permutation> permutation(size_t length) const;
+
+    /**
+     * @brief Применяет все ступени (шифрование).
+     */
+    std::wstring encrypt(const std::wstring& text) const;
+
+    /**
+     * @brief Применяет обратную перестановку (дешифрование).
+     * @throw std::invalid_argument Если составная перестановка необратима
+     *        (ступень вернула перестановку другой длины).
+     */
+    std::wstring decrypt(const std::wstring& text) const;
+
+    /**
+     * @brief Варианты с размещением результата в ресурсе памяти mr.
+     */
+    std::pmr::wstring encrypt(const std::wstring& text, std::pmr::memory_resource* mr) const;
+    std::pmr::wstring decrypt(const std::wstring& text, std::pmr::memory_resource* mr) const;
+
+private:
+    std::vector<PermutationStage> stages;
+
+    size_t cacheCapacity;
+    mutable std::mutex cacheMutex;
+    mutable std::list<size_t> cacheOrder; ///< Длины от недавно использованных к давним
+    mutable std::unordered_map<size_t, std::pair<std::shared_ptr<const Permutation>,
+                                                 std::list<size_t>::iterator>> cache;
+
+    Permutation compose(size_t length) const;
+
+    template <class String>
+    void encryptInto(std::wstring_view text, String& out) const;
+
+    template <class String>
+    void decryptInto(std::wstring_view text, String& out) const;
+};
+
+#endif // TRANSPOSITION_CHAIN_H
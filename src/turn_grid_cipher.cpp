@@ -7,6 +7,10 @@
  */
 
 #include "turn_grid_cipher.h"
+#include "cipher_batch.h"
+#include "metrics.h"
+#include "scratch_alloc.h"
+#include <algorithm>
 #include <vector>
 #include <stdexcept>
 #include <iostream>
@@ -31,18 +35,29 @@ TurnGridCipher::TurnGridCipher(int size) : size_(size) {
 }
 
 /**
- * @brief Шифрует или дешифрует текст.
+ * @brief Общая реализация шифрования/дешифрования.
+ *
+ * Решётка и сетка выделяются тем же аллокатором, что и out.
+ *
  * @param text Входной текст.
- * @param encrypt true — шифровать, false — дешифровать.
- * @return Результат.
+ * @param[out] out Строка, в которую дописывается результат.
+ * @param verbose true — выводить состояние решётки и сетки в консоль.
  */
-std::wstring TurnGridCipher::process(const std::wstring& text, bool encrypt) {
-    if (text.empty()) return L"";
-
-    auto grille = createGrille();
+template <class String>
+void TurnGridCipher::processInto(std::wstring_view text, String& out, bool verbose) const {
+    metrics::CallScope scope(CipherKind::TurnGrid, text.size(), out);
+    if (text.empty()) return;
+
+    using BoolRow = scratch_vector<String, bool>;
+    using CharRow = scratch_vector<String, wchar_t>;
+    using Grille = scratch_vector<String, BoolRow>;
+    using Grid = scratch_vector<String, CharRow>;
+
+    auto alloc = out.get_allocator();
+    auto grille = createGrille<Grille>(alloc);
     validateGrilleHoles(grille);
 
-    std::vector<std::vector<wchar_t>> grid(size_, std::vector<wchar_t>(size_, L' '));
+    Grid grid(size_, CharRow(size_, L' ', alloc), alloc);
     size_t pos = 0;
 
     for (int rotation = 0; rotation < 4 && pos < text.size(); ++rotation) {
@@ -53,29 +68,110 @@ std::wstring TurnGridCipher::process(const std::wstring& text, bool encrypt) {
                 }
             }
         }
-        std::wcout << L"\n[Rotation " << rotation + 1 << L"]\n";
-        printGrille(grille);
-        printGrid(grid);
+        if (verbose) {
+            std::wcout << L"\n[Rotation " << rotation + 1 << L"]\n";
+            printGrille(grille);
+            printGrid(grid);
+        }
         rotateGrille(grille);
     }
 
-    std::wstring result;
+    out.reserve(out.size() + std::min(text.size(), static_cast<size_t>(size_) * size_));
     for (int j = 0; j < size_; ++j) {
         for (int i = 0; i < size_; ++i) {
             if (grid[i][j] != L' ') {
-                result += grid[i][j];
+                out += grid[i][j];
             }
         }
     }
+}
+
+/**
+ * @brief Шифрует или дешифрует текст.
+ * @param text Входной текст.
+ * @param encrypt true — шифровать, false — дешифровать.
+ * @return Результат.
+ */
+std::wstring TurnGridCipher::process(const std::wstring& text, bool encrypt) {
+    if (text.empty()) return L"";
+
+    std::wstring result;
+    processInto(text, result, true);
 
     std::wcout << L"Final output: " << result << L"\n";
     return result;
 }
 
+/**
+ * @brief Шифрует или дешифрует текст без вывода в консоль.
+ * @param text Входной текст.
+ * @param encrypt true — шифровать, false — дешифровать.
+ * @param mr Ресурс памяти, из которого выделяются результат и временные сетки.
+ * @return Результат.
+ */
+std::pmr::wstring TurnGridCipher::process(const std::wstring& text, bool /*encrypt*/,
+                                         std::pmr::memory_resource* mr) const {
+    std::pmr::wstring result(mr);
+    processInto(text, result, false);
+    return result;
+}
+
+/**
+ * @brief Пакетная обработка без вывода в консоль.
+ */
+void TurnGridCipher::processBatch(const TextBatch& texts, bool, CipherBatch& out) const {
+    out.appendEach(texts, [this](std::wstring_view text, std::pmr::wstring& data) {
+        processInto(text, data, false);
+    });
+}
+
+/**
+ * @brief Перестановка позиций для текста длины length.
+ *
+ * Повторяет заполнение сетки из processInto, но записывает в клетки номера позиций.
+ */
+std::vector<size_t> TurnGridCipher::permutation(size_t length) const {
+    const size_t cells = static_cast<size_t>(size_) * size_;
+    if (length > cells) {
+        throw std::invalid_argument("Text does not fit into the grille.");
+    }
+
+    using Grille = std::vector<std::vector<bool>>;
+    auto grille = createGrille<Grille>(Grille::allocator_type());
+    validateGrilleHoles(grille);
+
+    const size_t EMPTY = cells;
+    std::vector<std::vector<size_t>> grid(size_, std::vector<size_t>(size_, EMPTY));
+    size_t pos = 0;
+    for (int rotation = 0; rotation < 4 && pos < length; ++rotation) {
+        for (int i = 0; i < size_; ++i) {
+            for (int j = 0; j < size_; ++j) {
+                if (grille[i][j] && pos < length) {
+                    grid[i][j] = pos++;
+                }
+            }
+        }
+        rotateGrille(grille);
+    }
+
+    std::vector<size_t> src;
+    src.reserve(length);
+    for (int j = 0; j < size_; ++j) {
+        for (int i = 0; i < size_; ++i) {
+            if (grid[i][j] != EMPTY) {
+                src.push_back(grid[i][j]);
+            }
+        }
+    }
+    return src;
+}
+
 // === Вспомогательные методы класса ===
 
-std::vector<std::vector<bool>> TurnGridCipher::createGrille() const {
-    std::vector<std::vector<bool>> grille(size_, std::vector<bool>(size_, false));
+template <class Grille>
+Grille TurnGridCipher::createGrille(const typename Grille::allocator_type& alloc) const {
+    using Row = typename Grille::value_type;
+    Grille grille(size_, Row(size_, false, alloc), alloc);
 
     if (size_ == 4) {
         grille[0][0] = true;
@@ -90,7 +186,8 @@ std::vector<std::vector<bool>> TurnGridCipher::createGrille() const {
     return grille;
 }
 
-void TurnGridCipher::printGrille(const std::vector<std::vector<bool>>& grille) const {
+template <class Grille>
+void TurnGridCipher::printGrille(const Grille& grille) const {
     std::wcout << L"Grille state:\n";
     for (const auto& row : grille) {
         for (bool cell : row) {
@@ -101,7 +198,8 @@ void TurnGridCipher::printGrille(const std::vector<std::vector<bool>>& grille) c
     std::wcout << std::endl;
 }
 
-void TurnGridCipher::printGrid(const std::vector<std::vector<wchar_t>>& grid) const {
+template <class Grid>
+void TurnGridCipher::printGrid(const Grid& grid) const {
     std::wcout << L"Grid state:\n";
     for (const auto& row : grid) {
         for (wchar_t c : row) {
@@ -112,7 +210,8 @@ void TurnGridCipher::printGrid(const std::vector<std::vector<wchar_t>>& grid) co
     std::wcout << std::endl;
 }
 
-void TurnGridCipher::rotateGrille(std::vector<std::vector<bool>>& grille) const {
+template <class Grille>
+void TurnGridCipher::rotateGrille(Grille& grille) const {
     const int n = grille.size();
     for (int i = 0; i < n / 2; ++i) {
         for (int j = i; j < n - i - 1; ++j) {
@@ -125,7 +224,8 @@ void TurnGridCipher::rotateGrille(std::vector<std::vector<bool>>& grille) const
     }
 }
 
-void TurnGridCipher::validateGrilleHoles(const std::vector<std::vector<bool>>& grille) const {
+template <class Grille>
+void TurnGridCipher::validateGrilleHoles(const Grille& grille) const {
     int holeCount = 0;
     for (const auto& row : grille) {
         for (bool cell : row) {
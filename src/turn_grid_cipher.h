@@ -2,7 +2,12 @@
 #define TURN_GRID_CIPHER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <memory_resource>
+
+class TextBatch;
+class CipherBatch;
 
 /**
  * @class TurnGridCipher
@@ -28,14 +33,58 @@ public:
      */
     std::wstring process(const std::wstring& text, bool encrypt);
 
+    /**
+     * @brief Шифрует или дешифрует текст без визуализации.
+     *
+     * Результат, решётка и сетка размещаются в ресурсе памяти mr.
+     *
+     * @param text Исходный текст.
+     * @param encrypt true — шифровать, false — дешифровать.
+     * @param mr Ресурс памяти вызывающего кода.
+     * @return Результат.
+     */
+    std::pmr::wstring process(const std::wstring& text, bool encrypt, std::pmr::memory_resource* mr) const;
+
+    /**
+     * @brief Шифрует или дешифрует пакет сообщений без визуализации.
+     *
+     * Результаты дописываются в out (см. cipher_batch.h), решётка и сетка берутся из его пула.
+     *
+     * @param texts Входные сообщения.
+     * @param encrypt true — шифровать, false — дешифровать.
+     * @param[out] out Пакет результатов.
+     */
+    void processBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const;
+
+    /**
+     * @brief Перестановка позиций, которую выполняет решётка для текста длины length.
+     *
+     * process() дополнительно удаляет пробелы из результата, поэтому совпадает с
+     * перестановкой только для текстов без пробелов.
+     *
+     * @param length Длина текста (не больше size * size).
+     * @return Вектор src: результат[k] == text[src[k]].
+     * @throw std::invalid_argument Если текст не помещается в решётку.
+     * @throw std::runtime_error Если решётка некорректна.
+     */
+    std::vector<size_t> permutation(size_t length) const;
+
 private:
     int size_;
 
-    std::vector<std::vector<bool>> createGrille() const;
-    void rotateGrille(std::vector<std::vector<bool>>& grille) const;
-    void validateGrilleHoles(const std::vector<std::vector<bool>>& grille) const;
-    void printGrille(const std::vector<std::vector<bool>>& grille) const;
-    void printGrid(const std::vector<std::vector<wchar_t>>& grid) const;
+    template <class String>
+    void processInto(std::wstring_view text, String& out, bool verbose) const;
+
+    template <class Grille>
+    Grille createGrille(const typename Grille::allocator_type& alloc) const;
+    template <class Grille>
+    void rotateGrille(Grille& grille) const;
+    template <class Grille>
+    void validateGrilleHoles(const Grille& grille) const;
+    template <class Grille>
+    void printGrille(const Grille& grille) const;
+    template <class Grid>
+    void printGrid(const Grid& grid) const;
 };
 
 #endif // TURN_GRID_CIPHER_H
@@ -0,0 +1,144 @@
+/**
+ * @file unix_socket.cpp
+ * @brief Реализация обёрток над сокетами Unix domain.
+ */
+
+#include "unix_socket.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    [[noreturn]] void throwErrno(const std::string& what)
+    {
+        throw std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    sockaddr_un makeAddress(const std::string& path)
+    {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path)) {
+            throw std::runtime_error("Socket path is too long: " + path);
+        }
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        return addr;
+    }
+
+    SocketFile socketFile(const std::string& path)
+    {
+        SocketFile file;
+        struct stat info;
+        if (::lstat(path.c_str(), &info) == 0) {
+            file.device = static_cast<std::uint64_t>(info.st_dev);
+            file.inode = static_cast<std::uint64_t>(info.st_ino);
+            file.valid = true;
+        }
+        return file;
+    }
+
+    /**
+     * @brief Удаляет файл сокета, оставшийся от завершившегося сервера.
+     * @throw std::runtime_error Если по пути лежит не сокет или сокет принимает соединения.
+     */
+    void removeStaleSocket(const std::string& path, const sockaddr_un& addr)
+    {
+        struct stat info;
+        if (::lstat(path.c_str(), &info) < 0) {
+            if (errno == ENOENT) return;
+            throwErrno("stat " + path);
+        }
+        if (!S_ISSOCK(info.st_mode)) {
+            throw std::runtime_error("Path exists and is not a socket: " + path);
+        }
+        int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (probe < 0) throwErrno("socket");
+        int result = ::connect(probe, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+        int saved = errno;
+        ::close(probe);
+        if (result == 0) {
+            throw std::runtime_error("Socket is already in use: " + path);
+        }
+        if (saved != ECONNREFUSED && saved != ENOENT) {
+            errno = saved;
+            throwErrno("connect " + path);
+        }
+        ::unlink(path.c_str());
+    }
+}
+
+int listenUnix(const std::string& path, int backlog, SocketFile* file) {
+    sockaddr_un addr = makeAddress(path);
+    removeStaleSocket(path, addr);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) throwErrno("socket");
+
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        int saved = errno;
+        ::close(fd);
+        errno = saved;
+        throwErrno("bind " + path);
+    }
+    if (::listen(fd, backlog) < 0) {
+        int saved = errno;
+        ::close(fd);
+        errno = saved;
+        throwErrno("listen");
+    }
+    if (file) *file = socketFile(path);
+    return fd;
+}
+
+void removeSocketFile(const std::string& path, const SocketFile& file) {
+    SocketFile current = socketFile(path);
+    if (file.valid && current.valid && current.device == file.device && current.inode == file.inode) {
+        ::unlink(path.c_str());
+    }
+}
+
+int connectUnix(const std::string& path) {
+    sockaddr_un addr = makeAddress(path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) throwErrno("socket");
+
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        int saved = errno;
+        ::close(fd);
+        errno = saved;
+        throwErrno("connect " + path);
+    }
+    return fd;
+}
+
+void sendAll(int fd, std::string_view data) {
+    while (!data.empty()) {
+        ssize_t n = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throwErrno("send");
+        }
+        data.remove_prefix(static_cast<size_t>(n));
+    }
+}
+
+bool recvExact(int fd, char* buffer, size_t size) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = ::recv(fd, buffer + done, size - done, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throwErrno("recv");
+        }
+        if (n == 0) {
+            if (done == 0) return false;
+            throw std::runtime_error("Connection closed in the middle of a frame.");
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
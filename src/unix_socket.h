@@ -0,0 +1,61 @@
+/**
+ * @file unix_socket.h
+ * @brief Обёртки над сокетами Unix domain для сервера и клиента (только POSIX).
+ */
+
+#ifndef UNIX_SOCKET_H
+#define UNIX_SOCKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Файл сокета в файловой системе (устройство и inode).
+ */
+struct SocketFile {
+    std::uint64_t device = 0;
+    std::uint64_t inode = 0;
+    bool valid = false; ///< false, если файла нет
+};
+
+/**
+ * @brief Создаёт слушающий сокет по пути path.
+ *
+ * Существующий файл удаляется, только если это сокет, к которому нельзя
+ * подключиться (остался от завершившегося процесса).
+ *
+ * @param[out] file Если не nullptr — файл созданного сокета (для removeSocketFile).
+ * @return Дескриптор сокета.
+ * @throw std::runtime_error Если по пути работает другой сервер, лежит не сокет
+ *        или системный вызов завершился ошибкой.
+ */
+int listenUnix(const std::string& path, int backlog = 128, SocketFile* file = nullptr);
+
+/**
+ * @brief Удаляет файл сокета, если по пути всё ещё лежит именно file.
+ */
+void removeSocketFile(const std::string& path, const SocketFile& file);
+
+/**
+ * @brief Подключается к сокету по пути path.
+ * @return Дескриптор сокета.
+ * @throw std::runtime_error При ошибке подключения.
+ */
+int connectUnix(const std::string& path);
+
+/**
+ * @brief Отправляет все байты data (без SIGPIPE при закрытом соединении).
+ * @throw std::runtime_error Если соединение закрыто или произошла ошибка.
+ */
+void sendAll(int fd, std::string_view data);
+
+/**
+ * @brief Читает ровно size байт.
+ * @return false, если соединение закрыто до первого байта.
+ * @throw std::runtime_error При ошибке или обрыве посреди данных.
+ */
+bool recvExact(int fd, char* buffer, size_t size);
+
+#endif // UNIX_SOCKET_H
@@ -0,0 +1,190 @@
+/**
+ * @file utf8.h
+ * @brief Преобразование между std::wstring и UTF-8 для обмена данными вне процесса.
+ *
+ * Шифры работают с wchar_t, а сокеты и файлы — с байтами. wchar_t имеет 32 бита
+ * на Linux и 16 бит (UTF-16) на Windows; оба случая поддерживаются.
+ */
+
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Записывает кодовую точку cp в UTF-8 по адресу dest.
+ * @return Число записанных байтов (1–4).
+ */
+inline size_t encodeUtf8(char* dest, char32_t cp) {
+    if (cp < 0x80) {
+        dest[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800) {
+        dest[0] = static_cast<char>(0xC0 | (cp >> 6));
+        dest[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        dest[0] = static_cast<char>(0xE0 | (cp >> 12));
+        dest[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        dest[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    dest[0] = static_cast<char>(0xF0 | (cp >> 18));
+    dest[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    dest[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    dest[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+/**
+ * @brief Дописывает кодовую точку cp в UTF-8 к out.
+ */
+inline void appendUtf8(std::string& out, char32_t cp) {
+    char bytes[4];
+    out.append(bytes, encodeUtf8(bytes, cp));
+}
+
+/**
+ * @brief Дописывает строку в UTF-8 к out (буфер out можно переиспользовать между вызовами).
+ *
+ * Место под худший случай выделяется один раз, символы пишутся по указателю.
+ */
+inline void appendUtf8(std::string& out, std::wstring_view text) {
+    const size_t base = out.size();
+    out.resize(base + text.size() * (sizeof(wchar_t) == 2 ? 3 : 4)); // суррогатная пара: 4 байта на 2 wchar_t
+    char* dest = &out[base];
+    size_t n = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        char32_t cp = static_cast<char32_t>(text[i]);
+        if (cp < 0x80) {
+            dest[n++] = static_cast<char>(cp);
+            continue;
+        }
+        if constexpr (sizeof(wchar_t) == 2) {
+            if (cp >= 0xD800 && cp < 0xDC00 && i + 1 < text.size()) {
+                char32_t low = static_cast<char32_t>(text[i + 1]);
+                if (low >= 0xDC00 && low < 0xE000) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    ++i;
+                }
+            }
+        }
+        n += encodeUtf8(dest + n, cp);
+    }
+    out.resize(base + n);
+}
+
+/**
+ * @brief Кодирует строку в UTF-8.
+ */
+inline std::string toUtf8(std::wstring_view text) {
+    std::string out;
+    appendUtf8(out, text);
+    return out;
+}
+
+/**
+ * @brief Длина начала bytes из целых последовательностей UTF-8.
+ *
+ * Отбрасывает только незаконченную последовательность в конце (не больше 3 байт),
+ * чтобы поток можно было резать на блоки по границам символов.
+ */
+inline size_t utf8CompletePrefix(std::string_view bytes) {
+    size_t n = bytes.size();
+    for (size_t back = 1; back <= 3 && back <= n; ++back) {
+        unsigned char c = static_cast<unsigned char>(bytes[n - back]);
+        if ((c & 0xC0) == 0x80) {
+            continue;
+        }
+        size_t length = c < 0x80 ? 1 : (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : 4;
+        return length > back ? n - back : n;
+    }
+    return n;
+}
+
+/**
+ * @brief Декодирует UTF-8 и дописывает результат к out.
+ *
+ * Символов не больше, чем байтов (суррогатная пара получается из 4 байт), поэтому
+ * место выделяется один раз и символы пишутся по указателю.
+ *
+ * @throw std::invalid_argument Если последовательность некорректна; в out остаётся
+ *        результат до ошибочной последовательности.
+ */
+inline void appendFromUtf8(std::wstring& out, std::string_view bytes) {
+    const size_t base = out.size();
+    out.resize(base + bytes.size());
+    wchar_t* dest = &out[base];
+    size_t n = 0;
+    const char* error = nullptr;
+    size_t i = 0;
+    while (i < bytes.size()) {
+        unsigned char lead = static_cast<unsigned char>(bytes[i]);
+        if (lead < 0x80) {
+            dest[n++] = static_cast<wchar_t>(lead);
+            ++i;
+            continue;
+        }
+        char32_t cp;
+        size_t extra;
+        if ((lead & 0xE0) == 0xC0) {
+            cp = lead & 0x1F;
+            extra = 1;
+        } else if ((lead & 0xF0) == 0xE0) {
+            cp = lead & 0x0F;
+            extra = 2;
+        } else if ((lead & 0xF8) == 0xF0) {
+            cp = lead & 0x07;
+            extra = 3;
+        } else {
+            error = "Invalid UTF-8 lead byte.";
+            break;
+        }
+        if (i + extra >= bytes.size()) {
+            error = "Truncated UTF-8 sequence.";
+            break;
+        }
+        for (size_t k = 1; k <= extra; ++k) {
+            unsigned char cont = static_cast<unsigned char>(bytes[i + k]);
+            if ((cont & 0xC0) != 0x80) {
+                error = "Invalid UTF-8 continuation byte.";
+                break;
+            }
+            cp = (cp << 6) | (cont & 0x3F);
+        }
+        if (error) {
+            break;
+        }
+        i += extra + 1;
+
+        if constexpr (sizeof(wchar_t) == 2) {
+            if (cp >= 0x10000) {
+                cp -= 0x10000;
+                dest[n++] = static_cast<wchar_t>(0xD800 + (cp >> 10));
+                dest[n++] = static_cast<wchar_t>(0xDC00 + (cp & 0x3FF));
+                continue;
+            }
+        }
+        dest[n++] = static_cast<wchar_t>(cp);
+    }
+    out.resize(base + n);
+    if (error) {
+        throw std::invalid_argument(error);
+    }
+}
+
+/**
+ * @brief Декодирует UTF-8 в std::wstring.
+ * @throw std::invalid_argument Если последовательность некорректна.
+ */
+inline std::wstring fromUtf8(std::string_view bytes) {
+    std::wstring out;
+    appendFromUtf8(out, bytes);
+    return out;
+}
+
+#endif // UTF8_H
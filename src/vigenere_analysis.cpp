@@ -0,0 +1,201 @@
+/**
+ * @file vigenere_analysis.cpp
+ * @brief Реализация определения длины ключа шифра Виженера (индекс совпадений и метод Касиски).
+ */
+
+#include "vigenere_analysis.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cwctype>
+#include <stdexcept>
+
+namespace
+{
+    constexpr size_t PARALLEL_THRESHOLD = 1 << 20;  ///< С какой длины текста подсчёт идёт в несколько потоков
+    constexpr double BEST_PERIOD_RATIO = 0.9;       ///< Доля от максимального индекса совпадений для выбора периода
+
+    /**
+     * @brief Смещение таблицы периода p в плоском массиве счётчиков.
+     *
+     * Для периода p хранится p столбцов по BIN_COUNT корзин; периоды идут подряд.
+     */
+    size_t periodOffset(size_t p)
+    {
+        return (p - 1) * p / 2 * VigenereAnalysis::BIN_COUNT;
+    }
+
+    /**
+     * @brief Считает позиции ключа на участке текста [begin, end).
+     */
+    size_t countKeyPositions(const wchar_t* begin, const wchar_t* end)
+    {
+        size_t n = 0;
+        for (const wchar_t* p = begin; p != end; ++p) {
+            if (VigenereAnalysis::consumesKey(*p)) ++n;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Заполняет столбцовые гистограммы всех периодов для участка текста.
+     *
+     * Вместо деления по модулю для каждого периода хранится текущий номер столбца,
+     * который увеличивается и сбрасывается в ноль при достижении периода.
+     *
+     * @param begin Начало участка.
+     * @param end Конец участка.
+     * @param firstPosition Номер позиции ключа первого символа участка.
+     * @param maxPeriod Максимальный период.
+     * @param[out] counts Плоский массив счётчиков (см. periodOffset).
+     */
+    void countColumns(const wchar_t* begin, const wchar_t* end, size_t firstPosition,
+                      size_t maxPeriod, std::vector<uint64_t>& counts)
+    {
+        std::vector<size_t> column(maxPeriod + 1);
+        for (size_t p = 1; p <= maxPeriod; ++p) {
+            column[p] = firstPosition % p;
+        }
+
+        for (const wchar_t* c = begin; c != end; ++c) {
+            if (!VigenereAnalysis::consumesKey(*c)) continue;
+
+            int bin = VigenereAnalysis::letterBin(*c);
+            for (size_t p = 1; p <= maxPeriod; ++p) {
+                if (bin >= 0) {
+                    ++counts[periodOffset(p) + column[p] * VigenereAnalysis::BIN_COUNT + bin];
+                }
+                if (++column[p] == p) column[p] = 0;
+            }
+        }
+    }
+}
+
+int VigenereAnalysis::letterBin(wchar_t c) {
+    if (!iswalpha(c)) return -1;
+    if (c >= L'A' && c <= L'Z') return c - L'A';
+    if (c >= L'a' && c <= L'z') return c - L'a';
+    if (c >= L'А' && c <= L'Я') return LATIN_SIZE + (c - L'А');
+    if (c >= L'а' && c <= L'я') return LATIN_SIZE + (c - L'а');
+    return -1;
+}
+
+bool VigenereAnalysis::consumesKey(wchar_t c) {
+    return c == L' ' || iswalpha(c);
+}
+
+size_t VigenereAnalysis::keyPosition(const std::wstring& key, size_t t) {
+    size_t firstSpace = key.find(L' ');
+    if (firstSpace != std::wstring::npos && t >= firstSpace) {
+        return firstSpace;
+    }
+    return t % key.size();
+}
+
+std::vector<double> VigenereAnalysis::periodicIndexOfCoincidence(const std::wstring& text, size_t maxPeriod) {
+    const size_t tableSize = periodOffset(maxPeriod + 1);
+    std::vector<uint64_t> counts(tableSize, 0);
+
+    ThreadPool& pool = ThreadPool::shared();
+    const size_t parts = text.size() < PARALLEL_THRESHOLD ? 1 : pool.concurrency();
+    if (parts == 1) {
+        countColumns(text.data(), text.data() + text.size(), 0, maxPeriod, counts);
+    } else {
+        size_t chunk = (text.size() + parts - 1) / parts;
+        auto partBegin = [&](size_t t) { return text.data() + std::min(text.size(), t * chunk); };
+
+        // Первый проход: сколько позиций ключа в каждой части, чтобы знать начальный столбец.
+        std::vector<size_t> positions(parts + 1, 0);
+        pool.parallelFor(0, parts, 1, [&](size_t first, size_t last) {
+            for (size_t t = first; t < last; ++t) positions[t + 1] = countKeyPositions(partBegin(t), partBegin(t + 1));
+        });
+        for (size_t t = 0; t < parts; ++t) positions[t + 1] += positions[t];
+
+        // Второй проход: частные гистограммы каждой части, затем слияние.
+        std::vector<std::vector<uint64_t>> partial(parts, std::vector<uint64_t>(tableSize, 0));
+        pool.parallelFor(0, parts, 1, [&](size_t first, size_t last) {
+            for (size_t t = first; t < last; ++t) {
+                countColumns(partBegin(t), partBegin(t + 1), positions[t], maxPeriod, partial[t]);
+            }
+        });
+        for (const auto& part : partial) {
+            for (size_t i = 0; i < tableSize; ++i) counts[i] += part[i];
+        }
+    }
+
+    std::vector<double> ic(maxPeriod + 1, 0.0);
+    for (size_t p = 1; p <= maxPeriod; ++p) {
+        double sum = 0.0;
+        size_t columns = 0;
+        for (size_t col = 0; col < p; ++col) {
+            const uint64_t* hist = &counts[periodOffset(p) + col * BIN_COUNT];
+            uint64_t n = 0, pairs = 0;
+            for (int b = 0; b < BIN_COUNT; ++b) {
+                n += hist[b];
+                if (hist[b] > 1) pairs += hist[b] * (hist[b] - 1);
+            }
+            if (n > 1) {
+                sum += static_cast<double>(pairs) / (static_cast<double>(n) * (n - 1));
+                ++columns;
+            }
+        }
+        ic[p] = columns > 0 ? sum / columns : 0.0;
+    }
+    return ic;
+}
+
+std::vector<uint64_t> VigenereAnalysis::kasiski(const std::wstring& text, size_t maxPeriod) {
+    // Код триграммы — три корзины по 6 бит; таблица последних вхождений индексируется кодом
+    // напрямую (2^18 элементов), без коллизий и с предсказуемым доступом к памяти.
+    constexpr int BITS = 6;
+    std::vector<uint64_t> lastSeen(size_t(1) << (3 * BITS), 0);
+    std::vector<uint64_t> votes(maxPeriod + 1, 0);
+
+    uint64_t position = 0;   // номер позиции ключа
+    uint32_t code = 0;
+    int run = 0;             // сколько подряд идущих позиций ключа были буквами
+    const uint32_t mask = (1u << (3 * BITS)) - 1;
+
+    for (wchar_t c : text) {
+        if (!consumesKey(c)) continue;
+        ++position;
+
+        int bin = letterBin(c);
+        if (bin < 0) {
+            run = 0;
+            continue;
+        }
+        code = ((code << BITS) | static_cast<uint32_t>(bin)) & mask;
+        if (++run < 3) continue;
+
+        uint64_t& last = lastSeen[code];
+        if (last != 0) {
+            uint64_t distance = position - last;
+            for (size_t p = 2; p <= maxPeriod; ++p) {
+                if (distance % p == 0) ++votes[p];
+            }
+        }
+        last = position;
+    }
+    return votes;
+}
+
+VigenerePeriodReport VigenereAnalysis::analyze(const std::wstring& ciphertext, size_t maxPeriod) {
+    if (maxPeriod == 0) {
+        throw std::invalid_argument("Maximum period must be positive.");
+    }
+
+    VigenerePeriodReport report;
+    report.indexOfCoincidence = periodicIndexOfCoincidence(ciphertext, maxPeriod);
+    report.kasiskiVotes = kasiski(ciphertext, maxPeriod);
+
+    // Кратные истинного периода дают такой же индекс совпадений, поэтому выбирается
+    // наименьший период, близкий к максимуму.
+    double best = *std::max_element(report.indexOfCoincidence.begin() + 1, report.indexOfCoincidence.end());
+    for (size_t p = 1; p <= maxPeriod; ++p) {
+        if (report.indexOfCoincidence[p] >= BEST_PERIOD_RATIO * best) {
+            report.bestPeriod = p;
+            break;
+        }
+    }
+    return report;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file vigenere_analysis.h
+ * @brief Заголовочный файл для класса VigenereAnalysis — определение длины ключа шифра Виженера.
+ */
+
+#ifndef VIGENERE_ANALYSIS_H
+#define VIGENERE_ANALYSIS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Результат анализа периода шифртекста Виженера.
+ */
+struct VigenerePeriodReport {
+    std::vector<double> indexOfCoincidence; ///< [p] — средний индекс совпадений по столбцам для периода p (p >= 1)
+    std::vector<uint64_t> kasiskiVotes;     ///< [p] — число расстояний между повторами триграмм, кратных p (p >= 2)
+    size_t bestPeriod = 1;                  ///< Наиболее вероятная длина ключа
+};
+
+/**
+ * @class VigenereAnalysis
+ * @brief Определение длины ключа для шифртекстов VigenereCipher.
+ *
+ * Анализ ведётся по тем же правилам, что и VigenereCipher::obrabotatTekst:
+ * позицию ключа занимают только буквы (iswalpha) и пробелы, остальные символы
+ * пропускаются. Сдвигаются только латинские и русские буквы; в гистограммах они
+ * учитываются без регистра в 26 + 32 корзинах. Пробелы занимают позицию ключа,
+ * но в гистограммы не попадают.
+ *
+ * Пробел в ключе останавливает продвижение ключа (см. keyPosition): после первого
+ * пробела весь оставшийся текст шифруется одним сдвигом и ведёт себя как период 1.
+ */
+class VigenereAnalysis {
+public:
+    static constexpr int LATIN_SIZE = 26;                         ///< Корзины латинских букв
+    static constexpr int CYRILLIC_SIZE = 32;                      ///< Корзины русских букв (без Ё)
+    static constexpr int BIN_COUNT = LATIN_SIZE + CYRILLIC_SIZE;  ///< Всего корзин
+
+    /**
+     * @brief Корзина гистограммы для символа.
+     * @param c Символ.
+     * @return 0..25 для латиницы, 26..57 для кириллицы, -1 для остальных символов.
+     */
+    static int letterBin(wchar_t c);
+
+    /**
+     * @brief true, если символ занимает позицию ключа (буква или пробел).
+     */
+    static bool consumesKey(wchar_t c);
+
+    /**
+     * @brief Индекс символа ключа для t-го символа, занимающего позицию ключа.
+     *
+     * Совпадает с продвижением позиции ключа в VigenereCipher: позиция растёт
+     * только пока текущий символ ключа не пробел.
+     *
+     * @param key Ключ.
+     * @param t Номер символа текста среди занимающих позицию ключа.
+     * @return Индекс в строке ключа.
+     */
+    static size_t keyPosition(const std::wstring& key, size_t t);
+
+    /**
+     * @brief Средний индекс совпадений по столбцам для периодов 1..maxPeriod за один проход.
+     * @param text Шифртекст.
+     * @param maxPeriod Максимальный проверяемый период.
+     * @return Вектор размера maxPeriod + 1; элемент [0] не используется.
+     */
+    static std::vector<double> periodicIndexOfCoincidence(const std::wstring& text, size_t maxPeriod);
+
+    /**
+     * @brief Метод Касиски: голоса за периоды по расстояниям между повторами триграмм.
+     * @param text Шифртекст.
+     * @param maxPeriod Максимальный проверяемый период.
+     * @return Вектор размера maxPeriod + 1; элементы [0] и [1] не используются.
+     */
+    static std::vector<uint64_t> kasiski(const std::wstring& text, size_t maxPeriod);
+
+    /**
+     * @brief Полный анализ: индекс совпадений, метод Касиски и выбор длины ключа.
+     * @param ciphertext Шифртекст.
+     * @param maxPeriod Максимальный проверяемый период.
+     * @return Отчёт с оценками по каждому периоду.
+     * @throw std::invalid_argument Если maxPeriod == 0.
+     */
+    static VigenerePeriodReport analyze(const std::wstring& ciphertext, size_t maxPeriod = 20);
+};
+
+#endif // VIGENERE_ANALYSIS_H
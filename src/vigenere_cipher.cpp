@@ -4,6 +4,10 @@
  */
 
 #include "vigenere_cipher.h"
+#include "cipher_batch.h"
+#include "metrics.h"
+#include "simd_dispatch.h"
+#include <algorithm>
 #include <stdexcept>
 #include <cwctype> // для iswalpha, towupper
 #include <iostream>
@@ -76,6 +80,48 @@ namespace
         return static_cast<wchar_t>(normSdvig + upper_a);
     }
 
+    /**
+     * @brief Как текущая локаль классифицирует буквы, от которых зависит векторное ядро.
+     *
+     * Ядро считает буквами ровно A–Z, a–z и (в режиме 1) А–я, а регистр латинских
+     * букв ключа — по ASCII.
+     *
+     * @return 0 — кириллица не буквы (локаль "C"), 1 — А–я буквы с обычным регистром,
+     *         -1 — иная локаль (только скалярный код).
+     */
+    int rezhimLokali()
+    {
+        if (towupper(L'i') != L'I')
+            return -1;
+        const bool bolshaya = iswalpha(L'Я') != 0;
+        const bool malaya = iswalpha(L'я') != 0;
+        if (!bolshaya && !malaya)
+            return 0;
+        if (bolshaya && malaya && iswupper(L'Я') && !iswupper(L'я') && towupper(L'я') == L'Я')
+            return 1;
+        return -1;
+    }
+
+    /**
+     * @brief Упакованный сдвиг буквы ключа для алфавита с первой заглавной baza и размером razmer.
+     *
+     * Повторяет арифметику obrabotatBukvu: буква с индексом x переходит в
+     * (x + e) % razmer с остатком языка C, e = ±sdvig + razmer.
+     */
+    wchar_t upakovatSdvig(wchar_t bukvaKlyucha, wchar_t baza, int razmer, bool shifrovat)
+    {
+        // Для ASCII регистр меняется без локали: таблицы ASCII-ключа верны в любом режиме.
+        wchar_t verhnyaya = bukvaKlyucha >= L'a' && bukvaKlyucha <= L'z'
+                                ? static_cast<wchar_t>(bukvaKlyucha - 0x20)
+                            : bukvaKlyucha < 0x80 ? bukvaKlyucha
+                                                  : static_cast<wchar_t>(towupper(bukvaKlyucha));
+        int sdvig = static_cast<int>(verhnyaya) - static_cast<int>(baza);
+        int e = (shifrovat ? sdvig : -sdvig) + razmer;
+        int ostatok = ((e % razmer) + razmer) % razmer;
+        int porog = std::clamp(-e, 0, razmer);
+        return static_cast<wchar_t>(ostatok | (porog << 8));
+    }
+
     /**
      * @brief Формирует строку-лозунг для вывода.
      * @param tekst Текст.
@@ -118,6 +164,95 @@ namespace
 VigenereCipher::VigenereCipher(const std::wstring &klyuch) : klyuch_(klyuch)
 {
     proveritKlyuch(klyuch_);
+    postroitTablicy();
+}
+
+/**
+ * @brief Таблицы сдвигов для позиций ключа 0 .. period_ + MAX_LANES.
+ *
+ * Без пробела в ключе позиция берётся по модулю period_ — кратного длины ключа
+ * и не меньшего ширины вектора, чтобы ядру хватало одного вычитания на блок.
+ * С пробелом в позиции s позиция ключа не растёт дальше s, и все элементы
+ * таблицы после s повторяют сдвиг пробела.
+ */
+void VigenereCipher::postroitTablicy()
+{
+    const size_t dlina = klyuch_.length();
+    const size_t probel = klyuch_.find(L' ');
+    nasyshchenie_ = probel != std::wstring::npos;
+    period_ = nasyshchenie_ ? probel : dlina * ((simd::MAX_LANES + dlina - 1) / dlina);
+    klyuchAscii_ = std::all_of(klyuch_.begin(), klyuch_.end(), [](wchar_t c) { return c < 0x80; });
+    rezhimLokali_ = rezhimLokali();
+
+    for (int shifrovat = 0; shifrovat < 2; ++shifrovat)
+    {
+        for (int kirillica = 0; kirillica < 2; ++kirillica)
+        {
+            std::wstring &tablica = tablicy_[shifrovat][kirillica];
+            tablica.resize(period_ + simd::MAX_LANES);
+            for (size_t t = 0; t < tablica.size(); ++t)
+            {
+                wchar_t bukvaKlyucha = nasyshchenie_ ? klyuch_[std::min(t, probel)] : klyuch_[t % dlina];
+                tablica[t] = kirillica ? upakovatSdvig(bukvaKlyucha, RUS_UPPER_A, RUS_ALPHABET_SIZE, shifrovat)
+                                       : upakovatSdvig(bukvaKlyucha, L'A', 26, shifrovat);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Внутренняя обработка текста (шифрование или дешифрование).
+ * @param tekst Входной текст.
+ * @param shifrovat true — шифровать, false — дешифровать.
+ * @param[out] rezultat Строка, в которую дописывается результат.
+ * @param shagKlyucha Позиция ключа для первого символа.
+ */
+template <class String>
+void VigenereCipher::obrabotatTekst(std::wstring_view tekst, bool shifrovat, String &rezultat,
+                                    std::uint64_t shagKlyucha) const
+{
+    metrics::CallScope scope(CipherKind::Vigenere, tekst.size(), rezultat);
+    const size_t nachalo = rezultat.size();
+    rezultat.resize(nachalo + tekst.length());
+    wchar_t *vyhod = &rezultat[nachalo];
+    // С пробелом в ключе позиция останавливается на нём, иначе важна только позиция по модулю period_.
+    size_t poziciyaKlyucha = nasyshchenie_ ? static_cast<size_t>(std::min<std::uint64_t>(shagKlyucha, period_))
+                                           : static_cast<size_t>(shagKlyucha % period_);
+
+    // Векторное ядро берёт целые блоки из ASCII и А–я; блоки с другими символами
+    // (их классифицирует iswalpha) и хвост обрабатывает скалярный цикл ниже.
+    int rezhim = tekst.length() >= simd::MAX_LANES && simd::activeLevel() != simd::Level::Scalar ? rezhimLokali() : -1;
+    bool vektor = rezhim >= 0 && (klyuchAscii_ || rezhim == rezhimLokali_);
+    simd::VigenereTables tablicy;
+    tablicy.latin = tablicy_[shifrovat][0].data();
+    tablicy.cyrillic = tablicy_[shifrovat][1].data();
+    tablicy.period = period_;
+    tablicy.saturate = nasyshchenie_;
+    tablicy.cyrillicLetters = rezhim == 1;
+
+    size_t i = 0;
+    while (i < tekst.length())
+    {
+        if (vektor)
+            i += simd::vigenereBlocks(tekst.data() + i, tekst.length() - i, vyhod + i, tablicy, poziciyaKlyucha);
+        const size_t konec = vektor ? std::min(tekst.length(), i + simd::MAX_LANES) : tekst.length();
+
+        for (; i < konec; ++i)
+        {
+            wchar_t c = tekst[i];
+            if (!iswalpha(c) && c != L' ')
+            {
+                vyhod[i] = c;
+                continue;
+            }
+
+            wchar_t bukvaKlyucha = klyuch_[poziciyaKlyucha % klyuch_.length()];
+            vyhod[i] = c == L' ' ? L' ' : obrabotatBukvu(c, bukvaKlyucha, shifrovat);
+
+            if (bukvaKlyucha != L' ')
+                poziciyaKlyucha++;
+        }
+    }
 }
 
 /**
@@ -127,7 +262,8 @@ VigenereCipher::VigenereCipher(const std::wstring &klyuch) : klyuch_(klyuch)
  */
 std::wstring VigenereCipher::zasifrovat(const std::wstring &tekst) const
 {
-    std::wstring result = obrabotatTekst(tekst, true);
+    std::wstring result;
+    obrabotatTekst(tekst, true, result);
     std::wcout << sozdatLozung(tekst, true) << std::endl;
     std::wcout << sozdatLozung(result, false) << std::endl;
     return result;
@@ -140,45 +276,79 @@ std::wstring VigenereCipher::zasifrovat(const std::wstring &tekst) const
  */
 std::wstring VigenereCipher::rasshifrovat(const std::wstring &tekst) const
 {
-    std::wstring result = obrabotatTekst(tekst, false);
+    std::wstring result;
+    obrabotatTekst(tekst, false, result);
     std::wcout << sozdatLozung(tekst, false) << std::endl;
     std::wcout << sozdatLozung(result, true) << std::endl;
     return result;
 }
 
 /**
- * @brief Внутренняя обработка текста (шифрование или дешифрование).
- * @param tekst Входной текст.
+ * @brief Шифрует текст без вывода лозунгов, результат размещается в mr.
+ * @param tekst Исходный текст.
+ * @param mr Ресурс памяти вызывающего кода.
+ * @return Зашифрованная строка.
+ */
+std::pmr::wstring VigenereCipher::zasifrovat(const std::wstring &tekst, std::pmr::memory_resource *mr) const
+{
+    std::pmr::wstring result(mr);
+    obrabotatTekst(tekst, true, result);
+    return result;
+}
+
+/**
+ * @brief Дешифрует текст без вывода лозунгов, результат размещается в mr.
+ * @param tekst Зашифрованный текст.
+ * @param mr Ресурс памяти вызывающего кода.
+ * @return Расшифрованная строка.
+ */
+std::pmr::wstring VigenereCipher::rasshifrovat(const std::wstring &tekst, std::pmr::memory_resource *mr) const
+{
+    std::pmr::wstring result(mr);
+    obrabotatTekst(tekst, false, result);
+    return result;
+}
+
+/**
+ * @brief Пакетная обработка без лозунгов, результаты дописываются в out.
+ * @param teksty Входные сообщения.
+ * @param shifrovat true — шифровать, false — дешифровать.
+ * @param[out] out Пакет результатов.
+ */
+void VigenereCipher::obrabotatPaket(const TextBatch &teksty, bool shifrovat, CipherBatch &out) const
+{
+    out.appendEach(teksty, [&](std::wstring_view tekst, std::pmr::wstring &data)
+                   { obrabotatTekst(tekst, shifrovat, data); });
+}
+
+/**
+ * @brief Обработка продолжения текста с позиции ключа shagKlyucha, без лозунгов.
+ * @param tekst Фрагмент текста.
  * @param shifrovat true — шифровать, false — дешифровать.
- * @return Результат.
+ * @param shagKlyucha Позиция ключа для первого символа фрагмента.
+ * @param mr Ресурс памяти вызывающего кода.
+ * @return Результат обработки фрагмента.
  */
-std::wstring VigenereCipher::obrabotatTekst(const std::wstring &tekst, bool shifrovat) const
+std::pmr::wstring VigenereCipher::obrabotat(std::wstring_view tekst, bool shifrovat, std::uint64_t shagKlyucha,
+                                            std::pmr::memory_resource *mr) const
 {
-    std::wstring rezultat;
-    rezultat.reserve(tekst.length());
-    size_t poziciyaKlyucha = 0;
+    std::pmr::wstring result(mr);
+    obrabotatTekst(tekst, shifrovat, result, shagKlyucha);
+    return result;
+}
 
+/**
+ * @brief Число символов, продвигающих ключ (буквы и пробелы).
+ * @param tekst Текст.
+ * @return Число шагов ключа.
+ */
+std::uint64_t VigenereCipher::shagiKlyucha(std::wstring_view tekst) const
+{
+    std::uint64_t shagi = 0;
     for (wchar_t c : tekst)
     {
-        if (!iswalpha(c) && c != L' ')
-        {
-            rezultat += c;
-            continue;
-        }
-
-        wchar_t bukvaKlyucha = klyuch_[poziciyaKlyucha % klyuch_.length()];
-        if (c == L' ')
-        {
-            rezultat += L' ';
-        }
-        else
-        {
-            rezultat += obrabotatBukvu(c, bukvaKlyucha, shifrovat);
-        }
-
-        if (bukvaKlyucha != L' ')
-            poziciyaKlyucha++;
+        if (c == L' ' || iswalpha(c))
+            ++shagi;
     }
-
-    return rezultat;
+    return shagi;
 }
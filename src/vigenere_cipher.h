@@ -2,6 +2,13 @@
 #define VIGENERE_CIPHER_H
 
 #include <string>
+#include <string_view>
+#include <memory_resource>
+#include <cstddef>
+#include <cstdint>
+
+class TextBatch;
+class CipherBatch;
 
 /**
  * @class VigenereCipher
@@ -9,6 +16,8 @@
  *
  * Данный класс реализует классический шифр Виженера, который выполняет символьный сдвиг
  * в пределах алфавита. Для русских букв используется 32-буквенный алфавит (без 'Ё').
+ * Длинные тексты из ASCII и букв А–я обрабатываются векторным ядром (simd_dispatch.h)
+ * по таблицам сдвигов, построенным в конструкторе.
  *
  * Пример использования:
  * @code
@@ -45,6 +54,59 @@ public:
      */
     std::wstring rasshifrovat(const std::wstring& tekst) const;
 
+    /**
+     * @brief Шифрует текст, размещая результат в переданном ресурсе памяти.
+     *
+     * В отличие от основной перегрузки не выводит лозунги в консоль.
+     *
+     * @param tekst Исходный открытый текст (wchar_t).
+     * @param mr Ресурс памяти вызывающего кода.
+     * @return Зашифрованный текст.
+     */
+    std::pmr::wstring zasifrovat(const std::wstring& tekst, std::pmr::memory_resource* mr) const;
+
+    /**
+     * @brief Дешифрует текст, размещая результат в переданном ресурсе памяти.
+     *
+     * В отличие от основной перегрузки не выводит лозунги в консоль.
+     *
+     * @param tekst Зашифрованный текст (wchar_t).
+     * @param mr Ресурс памяти вызывающего кода.
+     * @return Расшифрованный текст.
+     */
+    std::pmr::wstring rasshifrovat(const std::wstring& tekst, std::pmr::memory_resource* mr) const;
+
+    /**
+     * @brief Шифрует или дешифрует пакет сообщений без вывода лозунгов.
+     *
+     * Результаты дописываются подряд в out (см. cipher_batch.h).
+     *
+     * @param teksty Входные сообщения.
+     * @param shifrovat true — шифровать, false — дешифровать.
+     * @param[out] out Пакет результатов.
+     */
+    void obrabotatPaket(const TextBatch& teksty, bool shifrovat, CipherBatch& out) const;
+
+    /**
+     * @brief Шифрует или дешифрует продолжение текста без вывода лозунгов.
+     *
+     * Результат совпадает с соответствующим фрагментом обработки всего текста, если
+     * shagKlyucha — сумма shagiKlyucha() по предшествующим фрагментам (см. file_pipeline.h).
+     *
+     * @param tekst Фрагмент текста.
+     * @param shifrovat true — шифровать, false — дешифровать.
+     * @param shagKlyucha Позиция ключа для первого символа фрагмента.
+     * @param mr Ресурс памяти вызывающего кода.
+     * @return Результат обработки фрагмента.
+     */
+    std::pmr::wstring obrabotat(std::wstring_view tekst, bool shifrovat, std::uint64_t shagKlyucha,
+                                std::pmr::memory_resource* mr) const;
+
+    /**
+     * @brief На сколько позиций текст продвигает ключ: число букв и пробелов.
+     */
+    std::uint64_t shagiKlyucha(std::wstring_view tekst) const;
+
 private:
     /**
      * @brief Внутренний метод для обработки текста.
@@ -53,14 +115,47 @@ private:
      *
      * @param tekst Входной текст (wchar_t).
      * @param shifrovat true — шифровать, false — дешифровать.
-     * @return Результат обработки.
+     * @param[out] rezultat Строка, в которую дописывается результат.
+     * @param shagKlyucha Позиция ключа для первого символа.
      */
-    std::wstring obrabotatTekst(const std::wstring& tekst, bool shifrovat) const;
+    template <class String>
+    void obrabotatTekst(std::wstring_view tekst, bool shifrovat, String& rezultat,
+                        std::uint64_t shagKlyucha = 0) const;
+
+    /**
+     * @brief Строит таблицы сдвигов для векторного ядра.
+     */
+    void postroitTablicy();
 
     /**
      * @brief Сохраняемый ключ (wchar_t).
      */
     std::wstring klyuch_;
+
+    /**
+     * @brief Таблицы сдвигов векторного ядра: [шифрование][кириллица] (см. simd::VigenereTables).
+     */
+    std::wstring tablicy_[2][2];
+
+    /**
+     * @brief Период позиции ключа в таблицах или, если в ключе есть пробел, позиция остановки.
+     */
+    size_t period_ = 1;
+
+    /**
+     * @brief В ключе есть пробел: позиция ключа останавливается на нём.
+     */
+    bool nasyshchenie_ = false;
+
+    /**
+     * @brief Ключ состоит только из ASCII: таблицы не зависят от локали.
+     */
+    bool klyuchAscii_ = true;
+
+    /**
+     * @brief Режим локали при построении таблиц (см. rezhimLokali в vigenere_cipher.cpp).
+     */
+    int rezhimLokali_ = -1;
 };
 
 #endif // VIGENERE_CIPHER_H
\ No newline at end of file
@@ -4,12 +4,39 @@
  */
 
 #include "xor_cipher.h"
+#include "cipher_batch.h"
+#include "metrics.h"
+#include "scratch_alloc.h"
+#include "simd_dispatch.h"
+#include "utf8.h"
 #include <stdexcept>
 #include <cwctype> ///< Для towupper
 #include <algorithm>
+#include <istream>
+#include <ostream>
 
 using namespace std;
 
+namespace {
+    /// Минимальная длина повторённого ключа: непрерывные участки XOR достаточно длинные для векторизации.
+    constexpr size_t KEY_BLOCK_MIN = 256;
+
+    /// Наибольший код, для которого строится битовая карта алфавита (8 КБ).
+    constexpr size_t BITMAP_MAX_CODE = 0xFFFF;
+
+    [[noreturn]] void throwInvalidText(size_t offset) {
+        throw runtime_error("Текст содержит символы не из алфавита (позиция " + to_string(offset) + ")");
+    }
+
+    /// Значение HEX-цифры или -1.
+    int hexDigit(wchar_t h) {
+        if (h >= L'0' && h <= L'9') return h - L'0';
+        if (h >= L'A' && h <= L'F') return h - L'A' + 10;
+        if (h >= L'a' && h <= L'f') return h - L'a' + 10;
+        return -1;
+    }
+}
+
 /**
  * @brief Конструктор класса XORCipher.
  *
@@ -20,9 +47,29 @@ using namespace std;
  * @param alph Алфавит, используемый для проверки символов.
  * @throw std::runtime_error Если ключ некорректен.
  */
-XORCipher::XORCipher(const wstring& k, const wstring& alph) : alphabet(alph) {
+XORCipher::XORCipher(const wstring& k, const wstring& alph)
+    : alphabet(alph), alphabetIndex(alph), alphabetKind(detectBuiltinAlphabet(alph)) {
+    size_t maxCode = L' ';
+    for (wchar_t c : alphabet) {
+        maxCode = max(maxCode, static_cast<size_t>(c));
+    }
+    if (maxCode <= BITMAP_MAX_CODE) {
+        allowedBits.assign(maxCode / 64 + 1, 0);
+        for (wchar_t c : alphabet + L' ') {
+            allowedBits[static_cast<size_t>(c) >> 6] |= uint64_t{1} << (static_cast<size_t>(c) & 63);
+        }
+    }
+
     validateKey(k);
     key = stringToWide(k);
+    keyTable.resize(key.size() + simd::MAX_LANES);
+    for (size_t t = 0; t < keyTable.size(); ++t) {
+        keyTable[t] = key[t % key.size()];
+    }
+    keyBytes = toUtf8(k);
+    while (keyBlock.size() < KEY_BLOCK_MIN) {
+        keyBlock += keyBytes;
+    }
 }
 
 /**
@@ -38,26 +85,35 @@ void XORCipher::validateKey(const wstring& k) {
         throw runtime_error("Ключ не может быть пустым");
     }
     for (wchar_t c : k) {
-        if (alphabet.find(c) == wstring::npos && c != L' ') {
+        if (!isAllowed(c)) {
             throw runtime_error("Ключ содержит символы не из алфавита");
         }
     }
 }
 
 /**
- * @brief Проверяет текст на соответствие алфавиту.
- *
- * Текст должен состоять только из символов алфавита или пробелов.
+ * @brief Ищет первый символ не из алфавита и не пробел.
  *
  * @param text Текст для проверки.
- * @throw std::runtime_error Если текст содержит недопустимые символы.
+ * @return Позиция символа или wstring_view::npos.
  */
-void XORCipher::validateText(const wstring& text) {
-    for (wchar_t c : text) {
-        if (alphabet.find(c) == wstring::npos && c != L' ') {
-            throw runtime_error("Текст содержит символы не из алфавита");
+size_t XORCipher::findInvalid(wstring_view text) const {
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (!allowed(text[i])) {
+            return i;
         }
     }
+    return wstring_view::npos;
+}
+
+/**
+ * @brief Проверяет, допустим ли символ: буква алфавита или пробел.
+ *
+ * @param c Символ.
+ * @return true, если символ входит в алфавит или является пробелом.
+ */
+bool XORCipher::isAllowed(wchar_t c) const {
+    return c == L' ' || alphabetIndex.indexOf(c) >= 0;
 }
 
 /**
@@ -79,7 +135,7 @@ vector<wchar_t> XORCipher::stringToWide(const wstring& str) {
  * @return Числовое значение символа.
  * @throw std::runtime_error Если символ не является допустимой HEX-цифрой.
  */
-wchar_t XORCipher::hexToChar(wchar_t h) {
+wchar_t XORCipher::hexToChar(wchar_t h) const {
     if (h >= L'0' && h <= L'9') return h - L'0';
     if (h >= L'A' && h <= L'F') return h - L'A' + 10;
     if (h >= L'a' && h <= L'f') return h - L'a' + 10;
@@ -90,35 +146,110 @@ wchar_t XORCipher::hexToChar(wchar_t h) {
  * @brief Выполняет XOR-шифрование или дешифрование текста.
  *
  * Каждый символ входного текста XOR-ится с соответствующим символом ключа.
- * Пробелы остаются без изменений.
+ * Пробелы остаются без изменений. С validate символы проверяются по алфавиту в том
+ * же проходе (для встроенных алфавитов — векторным ядром simd::xorAlphabet); при
+ * ошибке out возвращается к исходной длине.
  *
  * @param input Входной текст.
- * @return Результат XOR-операции.
+ * @param[out] out Строка, в которую дописывается результат XOR-операции.
+ * @param validate Проверять ли символы по алфавиту.
+ * @throw std::runtime_error Если validate и в тексте есть символ не из алфавита.
  */
-wstring XORCipher::xorProcess(const wstring& input) {
-    vector<wchar_t> result;
-    for (size_t i = 0; i < input.size(); ++i) {
-        if (input[i] == L' ') {
-            result.push_back(L' ');
-        } else {
-            result.push_back(input[i] ^ key[i % key.size()]);
+template <class String>
+void XORCipher::xorProcess(wstring_view input, String& out, bool validate) const {
+    metrics::CallScope scope(CipherKind::Xor, input.size(), out);
+    size_t base = out.size();
+    out.resize(base + input.size());
+    size_t i = 0;
+    if (validate && alphabetKind != BuiltinAlphabet::None) {
+        i = simd::xorAlphabet(input.data(), input.size(), &out[base], keyTable.data(), key.size(),
+                              alphabet.front(), static_cast<int>(alphabet.size()));
+    }
+    for (size_t k = i % key.size(); i < input.size(); ++i) {
+        if (validate && !allowed(input[i])) {
+            out.resize(base);
+            throwInvalidText(i);
+        }
+        out[base + i] = input[i] == L' ' ? L' ' : static_cast<wchar_t>(input[i] ^ key[k]);
+        if (++k == key.size()) k = 0;
+    }
+}
+
+/**
+ * @brief Шифрует текст и дописывает результат в HEX-формате в out.
+ *
+ * Каждый символ проверяется по алфавиту и после XOR сразу превращается в пару
+ * HEX-символов, без отдельного прохода проверки и промежуточной строки.
+ * При ошибке out возвращается к исходной длине.
+ */
+template <class String>
+void XORCipher::encryptToHexInto(wstring_view text, String& out) const {
+    metrics::CallScope scope(CipherKind::Xor, text.size(), out);
+    const wchar_t hex[] = L"0123456789ABCDEF";
+
+    const size_t base = out.size();
+    out.resize(base + 3 * text.size());
+    wchar_t* dest = &out[base];
+    for (size_t i = 0, k = 0; i < text.size(); ++i, dest += 3) {
+        if (!allowed(text[i])) {
+            out.resize(base);
+            throwInvalidText(i);
         }
+        wchar_t c = text[i] == L' ' ? L' ' : static_cast<wchar_t>(text[i] ^ key[k]);
+        if (++k == key.size()) k = 0;
+        dest[0] = hex[(c >> 4) & 0x0F];
+        dest[1] = hex[c & 0x0F];
+        dest[2] = L' ';
     }
-    return wstring(result.begin(), result.end());
+}
+
+/**
+ * @brief Разбирает HEX-строку и дописывает расшифрованный текст в out.
+ *
+ * Временные буферы выделяются тем же аллокатором, что и out.
+ */
+template <class String>
+void XORCipher::decryptFromHexInto(wstring_view hex, String& out) const {
+    scratch_vector<String, wchar_t> cleanHex(out.get_allocator());
+    cleanHex.reserve(hex.size());
+
+    for (wchar_t c : hex) {
+        if ((c >= L'0' && c <= L'9') ||
+            (c >= L'A' && c <= L'F') ||
+            (c >= L'a' && c <= L'f')) {
+            cleanHex.push_back(towupper(c));
+        }
+    }
+
+    if (cleanHex.size() % 2 != 0) {
+        throw runtime_error("Некорректная длина HEX-строки");
+    }
+
+    scratch_vector<String, wchar_t> bytes(out.get_allocator());
+    bytes.reserve(cleanHex.size() / 2);
+    for (size_t i = 0; i + 1 < cleanHex.size(); i += 2) {
+        wchar_t high = hexToChar(cleanHex[i]);
+        wchar_t low = hexToChar(cleanHex[i + 1]);
+        bytes.push_back((high << 4) | low);
+    }
+
+    // Вызов учитывается в метриках внутри xorProcess (по числу байтов, а не HEX-символов).
+    xorProcess(wstring_view(bytes.data(), bytes.size()), out, false);
 }
 
 /**
  * @brief Шифрует текст методом XOR.
  *
- * Выполняет проверку текста и применяет XOR-шифрование.
+ * Проверяет текст и применяет XOR-шифрование за один проход.
  *
  * @param text Текст для шифрования.
  * @return Зашифрованный текст.
  * @throw std::runtime_error Если текст содержит недопустимые символы.
  */
 wstring XORCipher::encrypt(const wstring& text) {
-    validateText(text);
-    return xorProcess(text);
+    wstring result;
+    xorProcess(text, result, true);
+    return result;
 }
 
 /**
@@ -130,15 +261,8 @@ wstring XORCipher::encrypt(const wstring& text) {
  * @return HEX-строка с пробелами между байтами.
  */
 wstring XORCipher::encryptToHex(const wstring& text) {
-    wstring encrypted = encrypt(text);
     wstring result;
-    const wchar_t hex[] = L"0123456789ABCDEF";
-
-    for (wchar_t c : encrypted) {
-        result += hex[(c >> 4) & 0x0F];
-        result += hex[c & 0x0F];
-        result += L' ';
-    }
+    encryptToHexInto(text, result);
     return result;
 }
 
@@ -153,26 +277,186 @@ wstring XORCipher::encryptToHex(const wstring& text) {
  * @throw std::runtime_error Если строка имеет некорректный HEX-формат.
  */
 wstring XORCipher::decryptFromHex(const wstring& hex) {
-    vector<wchar_t> bytes;
-    wstring cleanHex;
+    wstring result;
+    decryptFromHexInto(hex, result);
+    return result;
+}
 
-    for (wchar_t c : hex) {
-        if ((c >= L'0' && c <= L'9') ||
-            (c >= L'A' && c <= L'F') ||
-            (c >= L'a' && c <= L'f')) {
-            cleanHex += towupper(c);
+/**
+ * @brief Шифрует текст методом XOR в памяти вызывающего кода.
+ *
+ * @param text Текст для шифрования.
+ * @param mr Ресурс памяти для результата.
+ * @return Зашифрованный текст.
+ * @throw std::runtime_error Если текст содержит недопустимые символы.
+ */
+pmr::wstring XORCipher::encrypt(const wstring& text, pmr::memory_resource* mr) const {
+    pmr::wstring result(mr);
+    xorProcess(text, result, true);
+    return result;
+}
+
+/**
+ * @brief Шифрует текст в HEX-формат в памяти вызывающего кода.
+ *
+ * @param text Текст для шифрования.
+ * @param mr Ресурс памяти для результата.
+ * @return HEX-строка с пробелами между байтами.
+ */
+pmr::wstring XORCipher::encryptToHex(const wstring& text, pmr::memory_resource* mr) const {
+    pmr::wstring result(mr);
+    encryptToHexInto(text, result);
+    return result;
+}
+
+/**
+ * @brief Дешифрует HEX-строку в памяти вызывающего кода.
+ *
+ * @param hex HEX-строка (можно с пробелами).
+ * @param mr Ресурс памяти для результата и временных буферов.
+ * @return Расшифрованный текст.
+ * @throw std::runtime_error Если строка имеет некорректный HEX-формат.
+ */
+pmr::wstring XORCipher::decryptFromHex(const wstring& hex, pmr::memory_resource* mr) const {
+    pmr::wstring result(mr);
+    decryptFromHexInto(hex, result);
+    return result;
+}
+
+/**
+ * @brief Пакетная обработка в HEX-представлении, результаты дописываются в out.
+ */
+void XORCipher::processBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const {
+    if (encrypt) {
+        out.appendEach(texts, [this](wstring_view text, pmr::wstring& data) { encryptToHexInto(text, data); });
+    } else {
+        out.appendEach(texts, [this](wstring_view hex, pmr::wstring& data) { decryptFromHexInto(hex, data); });
+    }
+}
+
+/**
+ * @brief XOR байтов с ключом в UTF-8 начиная с позиции потока position.
+ *
+ * Ключ повторён в keyBlock, поэтому внутренний цикл идёт по непрерывным участкам
+ * длиной до keyBlock.size() без деления по модулю на каждый байт.
+ *
+ * @param in Входные байты.
+ * @param size Число байтов.
+ * @param[out] out Результат (может совпадать с in).
+ * @param position Смещение in[0] от начала потока.
+ */
+void XORCipher::xorBytes(const char* in, size_t size, char* out, uint64_t position) const {
+    const auto* src = reinterpret_cast<const unsigned char*>(in);
+    auto* dst = reinterpret_cast<unsigned char*>(out);
+    const auto* block = reinterpret_cast<const unsigned char*>(keyBlock.data());
+    size_t phase = static_cast<size_t>(position % keyBytes.size());
+    while (size > 0) {
+        size_t run = min(size, keyBlock.size() - phase);
+        for (size_t i = 0; i < run; ++i) {
+            dst[i] = src[i] ^ block[phase + i];
         }
+        src += run;
+        dst += run;
+        size -= run;
+        phase = 0;
     }
+}
 
-    if (cleanHex.size() % 2 != 0) {
-        throw runtime_error("Некорректная длина HEX-строки");
+/**
+ * @brief Шифрует байты в двоичном режиме.
+ *
+ * @param bytes Входные байты.
+ * @return Байты шифртекста той же длины.
+ */
+string XORCipher::encryptBytes(string_view bytes) const {
+    string result(bytes.size(), '\0');
+    xorBytes(bytes.data(), bytes.size(), result.data());
+    return result;
+}
+
+/**
+ * @brief Дешифрует байты, зашифрованные encryptBytes.
+ *
+ * @param bytes Шифртекст.
+ * @return Исходные байты.
+ */
+string XORCipher::decryptBytes(string_view bytes) const {
+    return encryptBytes(bytes);
+}
+
+/**
+ * @brief Потоковая обработка в двоичном режиме: память — один буфер chunkSize байт.
+ *
+ * @param in Входной поток (открытый в двоичном режиме).
+ * @param out Выходной поток.
+ * @param chunkSize Размер буфера.
+ * @return Число обработанных байтов.
+ * @throw std::runtime_error При ошибке записи.
+ */
+uint64_t XORCipher::processStream(istream& in, ostream& out, size_t chunkSize) const {
+    vector<char> buffer(max<size_t>(chunkSize, 1));
+    uint64_t position = 0;
+    while (in) {
+        in.read(buffer.data(), static_cast<streamsize>(buffer.size()));
+        size_t got = static_cast<size_t>(in.gcount());
+        if (got == 0) {
+            break;
+        }
+        xorBytes(buffer.data(), got, buffer.data(), position);
+        if (!out.write(buffer.data(), static_cast<streamsize>(got))) {
+            throw runtime_error("Ошибка записи в поток");
+        }
+        position += got;
     }
+    return position;
+}
 
-    for (size_t i = 0; i + 1 < cleanHex.size(); i += 2) {
-        wchar_t high = hexToChar(cleanHex[i]);
-        wchar_t low = hexToChar(cleanHex[i + 1]);
-        bytes.push_back((high << 4) | low);
+/**
+ * @brief Преобразует байты в HEX-формат encryptToHex.
+ *
+ * @param bytes Байты (например, результат encryptBytes).
+ * @return Строка "XX XX ... " с пробелом после каждого байта.
+ */
+wstring XORCipher::bytesToHex(string_view bytes) {
+    const wchar_t hex[] = L"0123456789ABCDEF";
+    wstring result;
+    result.reserve(3 * bytes.size());
+    for (char c : bytes) {
+        unsigned char b = static_cast<unsigned char>(c);
+        result += hex[b >> 4];
+        result += hex[b & 0x0F];
+        result += L' ';
     }
+    return result;
+}
 
-    return xorProcess(wstring(bytes.begin(), bytes.end()));
+/**
+ * @brief Разбирает HEX-строку в байты за один проход.
+ *
+ * Как и decryptFromHex, пропускает все символы, кроме HEX-цифр.
+ *
+ * @param hex HEX-строка.
+ * @return Байты.
+ * @throw std::runtime_error Если число HEX-цифр нечётно.
+ */
+string XORCipher::hexToBytes(wstring_view hex) {
+    string result;
+    result.reserve(hex.size() / 3 + 1);
+    int high = -1;
+    for (wchar_t c : hex) {
+        int digit = hexDigit(c);
+        if (digit < 0) {
+            continue;
+        }
+        if (high < 0) {
+            high = digit;
+        } else {
+            result += static_cast<char>((high << 4) | digit);
+            high = -1;
+        }
+    }
+    if (high >= 0) {
+        throw runtime_error("Некорректная длина HEX-строки");
+    }
+    return result;
 }
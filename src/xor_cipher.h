@@ -1,32 +1,124 @@
 #ifndef XOR_CIPHER_H
 #define XOR_CIPHER_H
 
+#include "alphabet_traits.h"
+#include <cstdint>
+#include <iosfwd>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <memory_resource>
+
+class TextBatch;
+class CipherBatch;
 
 /**
  * @class XORCipher
  * @brief Класс для шифрования/дешифрования текста методом XOR
  *
  * Поддерживает русский и английский алфавиты, преобразование в HEX-формат,
- * проверку корректности вводимых данных.
+ * проверку корректности вводимых данных. Двоичный режим (xorBytes, encryptBytes,
+ * processStream) работает с байтами напрямую: ключ — UTF-8 ключа, каждый байт
+ * (включая пробел) XOR-ится с байтом ключа, алфавит не проверяется.
  */
 class XORCipher {
 private:
     std::vector<wchar_t> key;   ///< Вектор символов ключа
     std::wstring alphabet;      ///< Используемый алфавит
+    AlphabetIndex alphabetIndex;  ///< Индекс символов алфавита
+    BuiltinAlphabet alphabetKind; ///< Встроенный алфавит (EN/RU) или пользовательский
+    std::string keyBytes;       ///< Ключ в UTF-8 для двоичного режима
+    std::string keyBlock;       ///< keyBytes, повторённый до длины не меньше 256 байт
+    std::vector<wchar_t> keyTable;        ///< key, продолженный на simd::MAX_LANES символов
+    std::vector<std::uint64_t> allowedBits; ///< Битовая карта допустимых кодов 0..max (пусто — слишком широкий алфавит)
 
     void validateKey(const std::wstring& k);
-    void validateText(const std::wstring& text);
+    bool isAllowed(wchar_t c) const;
+
+    /// Проверка символа по битовой карте (без неё — через индекс алфавита).
+    bool allowed(wchar_t c) const {
+        const std::size_t code = static_cast<std::size_t>(c);
+        if (code < allowedBits.size() * 64) return (allowedBits[code >> 6] >> (code & 63)) & 1;
+        return allowedBits.empty() && isAllowed(c);
+    }
     std::vector<wchar_t> stringToWide(const std::wstring& str);
-    wchar_t hexToChar(wchar_t h);
-    std::wstring xorProcess(const std::wstring& input);
+    wchar_t hexToChar(wchar_t h) const;
+
+    template <class String>
+    void xorProcess(std::wstring_view input, String& out, bool validate) const;
+    template <class String>
+    void encryptToHexInto(std::wstring_view text, String& out) const;
+    template <class String>
+    void decryptFromHexInto(std::wstring_view hex, String& out) const;
 
 public:
     XORCipher(const std::wstring& k, const std::wstring& alph);
     std::wstring encrypt(const std::wstring& text);
     std::wstring encryptToHex(const std::wstring& text);
     std::wstring decryptFromHex(const std::wstring& hex);
+
+    /**
+     * @brief Варианты с размещением результата и временных буферов в ресурсе памяти mr.
+     */
+    std::pmr::wstring encrypt(const std::wstring& text, std::pmr::memory_resource* mr) const;
+    std::pmr::wstring encryptToHex(const std::wstring& text, std::pmr::memory_resource* mr) const;
+    std::pmr::wstring decryptFromHex(const std::wstring& hex, std::pmr::memory_resource* mr) const;
+
+    /**
+     * @brief Пакет сообщений: encrypt = true — encryptToHex, false — decryptFromHex.
+     *
+     * Результаты дописываются в out (см. cipher_batch.h); сообщение с символами
+     * вне алфавита или некорректным HEX прерывает пакет исключением.
+     */
+    void processBatch(const TextBatch& texts, bool encrypt, CipherBatch& out) const;
+
+    /**
+     * @brief Позиция первого символа не из алфавита и не пробела.
+     *
+     * encrypt и encryptToHex проверяют текст в том же проходе, что и шифруют, и
+     * сообщают эту позицию в тексте исключения.
+     *
+     * @return Позиция или std::wstring_view::npos, если текст допустим.
+     */
+    size_t findInvalid(std::wstring_view text) const;
+
+    /**
+     * @brief Двоичный режим: out[i] = in[i] ^ keyBytes[(position + i) % keyBytes.size()].
+     *
+     * position — смещение первого байта от начала потока, поэтому данные можно
+     * обрабатывать частями любого размера. in и out могут совпадать.
+     */
+    void xorBytes(const char* in, size_t size, char* out, std::uint64_t position = 0) const;
+
+    /**
+     * @brief Шифрует байты (например, текст в UTF-8) в двоичном режиме.
+     */
+    std::string encryptBytes(std::string_view bytes) const;
+
+    /**
+     * @brief Дешифрует результат encryptBytes (операция симметрична).
+     */
+    std::string decryptBytes(std::string_view bytes) const;
+
+    /**
+     * @brief Шифрует (или дешифрует) поток до конца входа частями по chunkSize байт.
+     *
+     * @return Число обработанных байтов.
+     * @throw std::runtime_error При ошибке записи.
+     */
+    std::uint64_t processStream(std::istream& in, std::ostream& out, size_t chunkSize = 1 << 16) const;
+
+    /**
+     * @brief Байты в HEX-формате encryptToHex: "XX " на байт.
+     */
+    static std::wstring bytesToHex(std::string_view bytes);
+
+    /**
+     * @brief Разбирает HEX-формат encryptToHex в байты (символы кроме HEX-цифр пропускаются).
+     *
+     * @throw std::runtime_error Если число HEX-цифр нечётно.
+     */
+    static std::string hexToBytes(std::wstring_view hex);
 };
 
 #endif // XOR_CIPHER_H